@@ -10,6 +10,9 @@
 // --- MPU6050 I2C ---
 #define I2C_SDA 25
 #define I2C_SCL 33
+// IMU FIFO rate and low-pass filter; 250 Hz fits one FIFO drain per sample.
+#define IMU_SAMPLE_RATE_HZ 250
+#define IMU_BANDWIDTH_HZ 94
 
 // --- TFT ILI9341 SPI (VSPI) ---
 #define VSPI_SCLK 18
@@ -26,7 +26,8 @@ void Board_initPins() {
 }
 
 void Board_initDisplay() {
-  DisplayHardwareConfig cfg{LCD_CS, TFT_DC, TFT_RST, TFT_BL_PIN};
+  DisplayHardwareConfig cfg{LCD_CS, TFT_DC, TFT_RST, TFT_BL_PIN, VSPI_SCLK,
+                            VSPI_MOSI};
   Display_configure(cfg);
 }
 
@@ -38,6 +39,8 @@ void Board_initTouch() {
 void Board_initSensors() {
   SensorPins pins{DHT_PIN, DHT_TYPE, I2C_SDA, I2C_SCL};
   Sensors_configure(pins);
+  ImuConfig imu{IMU_SAMPLE_RATE_HZ, IMU_BANDWIDTH_HZ};
+  Sensors_configureImu(imu);
 }
 
 SPIClass &Board_getSdSpi() { return sdSpi; }
@@ -1,6 +1,8 @@
 #include "BoardConfig.h"
 #include "Dictionary.h"
 #include "Display.h"
+#include "Log.h"
+#include "LoopProfiler.h"
 #include "SDManager.h"
 #include "Sensors.h"
 #include "Settings.h"
@@ -10,13 +12,64 @@
 #include <Arduino.h>
 #include <SPI.h>
 
+static const unsigned long SENSOR_TIMING_LOG_MS = 60000;
+static unsigned long lastSensorTimingLogMs = 0;
+
+// Report sampling-task period jitter and session log queue stats once a
+// minute, then start a new jitter window.
+static void logSensorTiming() {
+  unsigned long now = millis();
+  if (now - lastSensorTimingLogMs < SENSOR_TIMING_LOG_MS)
+    return;
+  lastSensorTimingLogMs = now;
+
+  SensorTimingStats st;
+  Sensors_getTimingStats(st);
+  Sensors_resetTimingStats();
+  uint32_t meanJitterUs =
+      st.samples ? (uint32_t)(st.jitterSumUs / st.samples) : 0;
+  LOG_INFO("sensors,timing,samples=%lu;mean_jitter_us=%lu;max_jitter_us=%lu;"
+           "max_sample_us=%lu;overruns=%lu;dropped=%lu;stale=%lu;"
+           "imu_samples=%lu;imu_overflows=%lu;trace_dropped=%lu",
+           (unsigned long)st.samples, (unsigned long)meanJitterUs,
+           (unsigned long)st.maxJitterUs, (unsigned long)st.maxSampleUs,
+           (unsigned long)st.overruns, (unsigned long)st.droppedLetters,
+           (unsigned long)st.staleLetters, (unsigned long)st.imuSamples,
+           (unsigned long)st.imuOverflows, (unsigned long)st.traceDropped);
+  SDManager::logSessionTiming(st);
+
+  if (!LOG_ENABLED(LOG_LEVEL_INFO))
+    return;
+  SDManager::SessionLogStats ls;
+  SDManager::getSessionLogStats(ls);
+  char hist[SDManager::WRITE_HIST_BUCKETS * 11];
+  size_t len = 0;
+  for (uint8_t i = 0; i < SDManager::WRITE_HIST_BUCKETS; i++)
+    len += snprintf(hist + len, sizeof(hist) - len, "%s%lu", i ? "/" : "",
+                    (unsigned long)ls.writeHist[i]);
+  LOG_INFO("sessionlog,stats,records=%lu;dropped=%lu;max_depth=%u;writes=%lu;"
+           "max_write_us=%lu;write_hist_ms=%s",
+           (unsigned long)ls.records, (unsigned long)ls.dropped,
+           (unsigned)ls.maxDepth, (unsigned long)ls.writes,
+           (unsigned long)ls.maxWriteUs, hist);
+}
+
+// Move recorded sensor trace bytes from the sampling task to the SD card.
+static void flushSensorTrace() {
+  if (!Sensors_isTraceRecording())
+    return;
+  uint8_t buf[512];
+  size_t n;
+  while ((n = Sensors_readTrace(buf, sizeof(buf))) > 0)
+    SDManager::appendSensorTrace(buf, n);
+}
 
 void setup() {
   Serial.begin(115200);
   delay(1000);
   Serial.println();
-  Serial.println(F("=== GhostRadar ESP32 boot ==="));
-  Serial.println(Board_getName());
+  LOG_INFO("=== GhostRadar ESP32 boot ===");
+  LOG_INFO("%s", Board_getName());
 
   Settings_loadDefaults();
   Board_initPins();
@@ -39,14 +92,28 @@ void setup() {
   Dictionary_begin();
   WifiRadar_begin();
   WifiRadar_startTask();
+  Sensors_startTask(); // after WifiRadar_begin(): it samples WiFi entropy
 
   SDManager::startSessionLog();
-  SDManager::logEvent("Boot complete");
+  if (Settings_get().sensorTrace && SDManager::startSensorTrace())
+    Sensors_setTraceRecording(true);
+  LOG_EVENT(LOG_LEVEL_INFO, "Boot complete");
 }
 
 void loop() {
+  PROFILE_UPDATE(); // overlay and CSV export, outside the timed loop
+  PROFILE_SCOPE(PROF_LOOP);
+  {
+    PROFILE_SCOPE(PROF_LOGGING);
+    logSensorTiming();
+    flushSensorTrace();
+  }
+
   // Touch UI
-  TouchUI_update();
+  {
+    PROFILE_SCOPE(PROF_TOUCH);
+    TouchUI_update();
+  }
   UiMode mode = TouchUI_getMode();
   if (mode == UI_MODE_SETTINGS) {
     return;
@@ -54,31 +121,58 @@ void loop() {
 
   // Sensors -> letter
   char newLetter = 0;
-  bool gotLetter = Sensors_pollLetter(newLetter);
+  bool gotLetter;
+  {
+    PROFILE_SCOPE(PROF_SENSORS);
+    gotLetter = Sensors_pollLetter(newLetter);
+    if (gotLetter)
+      Display_updateStatusBar(Sensors_getLastTempC(),
+                              Sensors_getLastHumidity());
+  }
   if (gotLetter) {
-    Display_updateStatusBar(Sensors_getLastTempC(), Sensors_getLastHumidity());
-
-    Dictionary_appendLetter(newLetter);
-    String sensorExtra = "temp=" + String(Sensors_getLastTempC(), 1) +
-                         ";hum=" + String(Sensors_getLastHumidity(), 1);
-    SDManager::logSessionLine("sensors,letter," + String(newLetter) + "," +
-                              sensorExtra);
+    {
+      PROFILE_SCOPE(PROF_DICTIONARY);
+      Dictionary_appendLetter(newLetter);
+    }
+    {
+      PROFILE_SCOPE(PROF_LOGGING);
+      float tempC, humidity;
+      Sensors_getLetterReading(tempC, humidity);
+      SDManager::logSessionLetter(newLetter, tempC, humidity);
+    }
 
     String hit;
-    if (Dictionary_checkForWord(hit)) {
+    bool gotWord;
+    {
+      PROFILE_SCOPE(PROF_DICTIONARY);
+      gotWord = Dictionary_checkForWord(hit);
+    }
+    if (gotWord) {
       Display_displayWord(hit);
-      const char *dictName = Dictionary_getActiveName();
-      String dictLabel = dictName ? String(dictName) : String("unknown");
-      SDManager::logSessionLine("dictionary,word," + hit +
-                                ",dict=" + dictLabel);
+      PROFILE_SCOPE(PROF_LOGGING);
+      if (Settings_get().matchPolicy == MATCH_POLICY_ALL) {
+        // Log every overlapping word, not just the one on screen.
+        static DictHit hits[DICT_MAX_CANDIDATES];
+        uint8_t count = Dictionary_getCandidates(hits, DICT_MAX_CANDIDATES);
+        for (uint8_t i = 0; i < count; i++)
+          SDManager::logSessionWord(hits[i]);
+      } else {
+        DictHit h;
+        if (Dictionary_getHit(h))
+          SDManager::logSessionWord(h);
+      }
     }
   }
 
-  // Heartbeat tick each loop; show letter or dash if no letter this cycle.
-  Display_heartbeatStep(gotLetter ? newLetter : 0);
-  // Animate heartbeat strip
-  Display_updateHeartbeat();
+  {
+    PROFILE_SCOPE(PROF_HEARTBEAT);
+    // Heartbeat tick each loop; show letter or dash if no letter this cycle.
+    Display_heartbeatStep(gotLetter ? newLetter : 0);
+    // Animate heartbeat strip
+    Display_updateHeartbeat();
+  }
 
   // WiFi radar
+  PROFILE_SCOPE(PROF_RADAR);
   WifiRadar_draw();
 }
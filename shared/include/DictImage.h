@@ -0,0 +1,53 @@
+#pragma once
+#include "DictMatcher.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Precompiled dictionary image produced by tools/host/dictc. Words are
+// uppercase, deduplicated and sorted by (length, text); the Aho-Corasick
+// automaton is stored alongside them so a loader only validates the image and
+// points a DictMatcher into the buffer. All fields are little-endian and every
+// section is 4-byte aligned, so an image can be used in place from a
+// memory-mapped flash partition or a single heap buffer.
+
+static const uint32_t DICT_IMAGE_MAGIC = 0x49445247UL; // "GRDI"
+static const uint16_t DICT_IMAGE_VERSION = 4;
+static const size_t DICT_IMAGE_NAME_LEN = 16;
+
+struct DictImageHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;
+  uint32_t imageSize; // header included, multiple of 4
+  uint32_t checksum;  // CRC-32 of bytes [headerSize, imageSize)
+  uint32_t wordCount;
+  uint32_t nodeCount;
+  uint32_t nodesOffset;
+  uint32_t wordOffsetsOffset;
+  uint32_t charsOffset;
+  uint32_t charsSize;
+  uint8_t maxWordLength; // also the deepest node
+  uint8_t reserved[3];
+  char name[DICT_IMAGE_NAME_LEN]; // NUL-padded display name
+};
+
+struct DictImageView {
+  DictMatcher matcher;
+  uint8_t maxWordLength;
+  const char *name;
+  uint32_t imageSize;
+  uint32_t checksum;
+};
+
+uint32_t DictImage_crc32(const uint8_t *data, size_t len, uint32_t crc = 0);
+
+// Validate an image and expose it without copying. Besides the header and
+// section bounds, every node link and word offset is checked once here, so
+// the matcher can follow them unchecked: children, fail and output links stay
+// inside the node table, fail and output links lead to shallower nodes (the
+// chains always end at the root), and no node is deeper than maxWordLength.
+// The CRC is skipped when `checkCrc` is false, for a caller that has already
+// verified this image's checksum. `data` must stay alive and be 4-byte
+// aligned for as long as the view is used.
+bool DictImage_open(const void *data, size_t size, DictImageView &out,
+                    bool checkCrc = true);
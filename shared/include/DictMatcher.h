@@ -0,0 +1,102 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Aho-Corasick automaton over a word list. The letter stream is fed one
+// character at a time and each state already knows which word (if any) ends
+// there, so matching cost does not depend on dictionary size.
+//
+// The automaton is stored as flat, index-linked arrays with no pointers so the
+// same layout can live on the heap, in flash, or inside a loaded image. This
+// header is kept free of Arduino types so host tools can build it too.
+
+static const uint32_t DICT_NO_WORD = 0xFFFFFFFFUL;
+static const uint32_t DICT_ROOT_STATE = 0;
+static const uint8_t DICT_MAX_TAGS = 8;
+// Node and word indices are stored in 24 bits; all ones means "none", so an
+// automaton holds fewer than this many states and words.
+static const uint32_t DICT_NODE_NONE = 0xFFFFFFUL;
+
+// 16 bytes: each 24-bit index shares a word with an 8-bit field.
+struct DictNode {
+  uint32_t firstChild : 24; // children are contiguous and sorted by label
+  uint32_t childCount : 8;
+  uint32_t fail : 24; // longest proper suffix that is also a trie path
+  uint32_t label : 8;
+  uint32_t output : 24; // next shorter state on the fail chain with a word
+  uint32_t depth : 8;
+  uint32_t word : 24; // word spelled by this exact path, or DICT_NODE_NONE
+  uint32_t tags : 8;  // tags of this state's own word
+};
+
+struct DictOutput {
+  uint32_t word;
+  uint8_t length;
+  uint8_t tags;
+};
+
+struct DictMatcher {
+  const DictNode *nodes;
+  uint32_t nodeCount;
+  const uint32_t *wordOffsets; // offset of each NUL-terminated word in chars
+  uint32_t wordCount;
+  const char *chars;
+};
+
+// Advance the automaton by one letter. Amortized O(1) per letter.
+uint32_t DictMatcher_step(const DictMatcher &m, uint32_t state, char c);
+// Earliest-added word that is a suffix at this state, or DICT_NO_WORD. Found
+// by following output links, so only states with a word pay for it.
+uint32_t DictMatcher_matchAt(const DictMatcher &m, uint32_t state);
+const char *DictMatcher_word(const DictMatcher &m, uint32_t wordId);
+// Tag bits of every word that ends at this state; 0 for untagged automata.
+uint8_t DictMatcher_tagsAt(const DictMatcher &m, uint32_t state);
+// Every word that is a suffix at this state, longest first, found by
+// following output links: the cost is proportional to the number of words
+// reported, not to the list size. Returns how many entries were written.
+uint32_t DictMatcher_outputs(const DictMatcher &m, uint32_t state,
+                             DictOutput *out, uint32_t maxOut);
+bool DictMatcher_empty(const DictMatcher &m);
+
+// Builds a DictMatcher from words added in priority order. Duplicate words are
+// dropped so the first occurrence keeps its priority. Words may carry a tag
+// bitmask (e.g. which of several merged lists they came from); duplicates
+// merge their tags. The returned matcher points into storage owned by the
+// builder.
+//
+// The vectors abort on allocation failure, so firmware callers check
+// peakBytes() and largestBlock() against the heap and reserve() the same
+// sizes before adding words.
+class DictMatcherBuilder {
+public:
+  void clear();
+  void reserve(size_t words, size_t chars);
+  bool addWord(const char *word, size_t len, uint8_t tags = 0);
+  DictMatcher build();
+  size_t memoryBytes() const;
+
+  // Heap a build from at most `chars` bytes of words (one terminator each)
+  // needs at its peak, after reserve(): the insertion trie, the final nodes
+  // and the breadth-first order are all live while build() renumbers them.
+  static size_t peakBytes(size_t chars);
+  // The largest single allocation among those: the final node table.
+  static size_t largestBlock(size_t chars);
+
+private:
+  // Insertion trie (first-child/next-sibling), discarded during build().
+  struct TrieNode {
+    uint32_t firstChild;
+    uint32_t nextSibling : 24;
+    uint32_t label : 8;
+    uint32_t word : 24;
+    uint32_t tags : 8;
+  };
+
+  uint32_t findChild(uint32_t node, uint8_t label) const;
+
+  std::vector<TrieNode> trie;
+  std::vector<DictNode> nodes;
+  std::vector<uint32_t> wordOffsets;
+  std::vector<char> chars;
+};
@@ -1,6 +1,18 @@
 #pragma once
+#include "DictMatcher.h"
+#include "config_core.h"
 #include <Arduino.h>
 
+// Most words that can end on one letter: one per length.
+static const uint8_t DICT_MAX_CANDIDATES = LETTER_BUFFER_SIZE;
+
+// A word that ends on the current letter.
+struct DictHit {
+  char word[LETTER_BUFFER_SIZE + 1];
+  uint32_t id;  // index in the active list; DICT_NO_WORD for SD lists
+  uint8_t tags; // built-in lists containing it ("All" entry), else 0
+};
+
 void Dictionary_begin();
 void Dictionary_appendLetter(char l);
 bool Dictionary_checkForWord(String &foundWord);
@@ -10,3 +22,17 @@ uint8_t Dictionary_getActiveIndex();
 uint8_t Dictionary_getCount();
 const char* Dictionary_getActiveName();
 const char* Dictionary_getNameForIndex(uint8_t idx);
+// Lists the last hit came from, e.g. "Default+Short" when the "All" entry is
+// active; otherwise the active dictionary's name.
+String Dictionary_getHitSources();
+String Dictionary_getSourcesForTags(uint8_t tags);
+// The same into a caller's buffer, truncated to fit; no allocation.
+void Dictionary_formatSources(uint8_t tags, char* dst, size_t size);
+// The word the last Dictionary_checkForWord() reported, with its id and
+// tags. False if it found none.
+bool Dictionary_getHit(DictHit &out);
+// Every candidate from the last Dictionary_checkForWord() hit, longest first
+// and at least Settings minWordLength long. checkForWord() reports one of them
+// according to Settings matchPolicy. Returns how many were written; room for
+// DICT_MAX_CANDIDATES always holds them all.
+uint8_t Dictionary_getCandidates(DictHit *out, uint8_t maxHits);
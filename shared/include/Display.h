@@ -14,13 +14,22 @@ struct DisplayLayout {
   int radarCenterX, radarCenterY, radarRadius;
 };
 
+struct DisplayRect {
+  int16_t x, y, w, h;
+};
+
 struct DisplayHardwareConfig {
   int cs;
   int dc;
   int rst;
   int blPin;  // -1 if not wired
+  int sclk;   // SPI clock/data pins for the DMA blit path; -1 disables it
+  int mosi;
 };
 
+// Called once a blit's pixels are on the panel, with the blit's fence.
+typedef void (*DisplayBlitCallback)(uint32_t fence, void* ctx);
+
 void Display_configure(const DisplayHardwareConfig& cfg);
 void Display_begin();
 void Display_drawStaticFrame();
@@ -29,6 +38,8 @@ void Display_displayLetter(char l);
 void Display_displayWord(const String& w);
 void Display_clearWordArea();
 void Display_setNightMode(bool enabled);
+// Status setters may be called from any task; they only mark the header, and
+// Display_updateHeartbeat() redraws it on the loop task.
 void Display_setSdPresent(bool present);
 void Display_setLoggingEnabled(bool enabled);
 void Display_setWifiActive(bool active);
@@ -40,14 +51,59 @@ void Display_setHeartbeatBpm(uint16_t bpm);
 uint8_t Display_getBrightnessLevel();
 uint16_t Display_dimColor(uint16_t color);
 const DisplayLayout& Display_getLayout();
+// Changes whenever the panel is drawn over wholesale (static frame, settings
+// screen, letter badge); modules that send only changed regions must then
+// resend everything.
+uint32_t Display_getFrameEpoch();
+// Changes whenever the brightness or night mode changes what
+// Display_dimColor() and the UI palette return.
+uint32_t Display_getPaletteEpoch();
 
 // Word overlay drawn over radar
 void Display_setOverlayWord(const String& w);
 void Display_drawOverlayWord();
+// Draw the overlay onto a canvas whose origin sits at (originX, originY) on
+// screen, so it goes out with the radar frame.
+// The canvas is indexed: the shadow and word take palette entries
+// shadowIndex and mainIndex, whose colours Display_getOverlayWordRect()
+// reports.
+void Display_drawOverlayWordOn(GFXcanvas8& canvas, int originX, int originY,
+                               uint8_t shadowIndex, uint8_t mainIndex);
+// Box the overlay covers in those coordinates, its current shadow and word
+// colours, and a stamp that changes whenever it would draw differently (word
+// or fade colour). False when there is no overlay word.
+bool Display_getOverlayWordRect(int originX, int originY, DisplayRect& box,
+                                uint16_t& shadowColor, uint16_t& mainColor,
+                                uint32_t& stamp);
+
+// Push a w x h block of RGB565 pixels (rows `stride` pixels apart) to the
+// panel. With SPI DMA the pixels are copied to a staging buffer and sent in
+// the background: `pixels` may be redrawn as soon as this returns, and
+// `done` runs from a later Display_* call once the block is on the glass.
+// Returns a fence for Display_blitDone()/Display_waitBlit(); 0 when the
+// blit already finished (no DMA: drawn synchronously, `done` already run).
+// Every other Display_* drawing call waits for pending blits first.
+uint32_t Display_blit(int16_t x, int16_t y, int16_t w, int16_t h,
+                      const uint16_t* pixels, int16_t stride,
+                      DisplayBlitCallback done = nullptr, void* ctx = nullptr);
+// As Display_blit(), for 8-bit pixels that index `palette` (RGB565). The
+// palette is applied as the pixels are queued and may change afterwards.
+uint32_t Display_blitIndexed(int16_t x, int16_t y, int16_t w, int16_t h,
+                             const uint8_t* pixels, int16_t stride,
+                             const uint16_t* palette,
+                             DisplayBlitCallback done = nullptr,
+                             void* ctx = nullptr);
+bool Display_blitDone(uint32_t fence);
+void Display_waitBlit(uint32_t fence);
+// Wait until the SPI bus is idle; call before other devices on the bus
+// (touch) are used.
+void Display_waitBlits();
 
 // Heartbeat scroller
 // Heartbeat scroller: pass letter ('A'..'Z') or 0 for dash cycle; call once per loop.
 void Display_heartbeatStep(char letterOrZero);
+// Scrolls by every step due since the last call and sends only the columns
+// that changed.
 void Display_updateHeartbeat();
 
 // Module placeholders
@@ -56,5 +112,6 @@ void ModuleLeft_draw(Adafruit_ILI9341 &tft, int x, int y, int w, int h);
 bool ModuleRight_enabled();
 void ModuleRight_draw(Adafruit_ILI9341 &tft, int x, int y, int w, int h);
 
-// Expose TFT so WifiRadar can draw on it
+// Expose TFT so WifiRadar can draw on it. Waits for pending blits, since
+// the driver writes to the bus directly.
 Adafruit_ILI9341& Display_tft();
@@ -0,0 +1,35 @@
+#pragma once
+#include <Adafruit_GFX.h>
+#include <stdint.h>
+
+// Pre-rasterized glyphs for text drawn into canvases every frame.
+// GlyphCache_addFont() renders the digits and A-Z of a font once through
+// Adafruit_GFX and keeps each as a row-aligned coverage mask with its
+// metrics. Drawing a cached glyph then writes the canvas buffer directly,
+// a byte of mask at a time, instead of one virtual drawPixel() per pixel.
+// The GFX fonts are 1-bit, so a mask bit is full coverage and tinting is a
+// plain fill with the text colour. Any other character falls back to
+// Adafruit_GFX, so every string still renders.
+//
+// Fonts are identified by their GFXfont; nullptr is the built-in 5x7 font at
+// size 1. Text is a single line with wrapping off. Loop task only.
+
+// Rasterize a font's digits and capitals. False if out of memory, in which
+// case that font keeps drawing through Adafruit_GFX.
+bool GlyphCache_addFont(const GFXfont *font);
+
+// The box Adafruit_GFX::getTextBounds() reports for `text` at cursor (0, 0)
+// with wrapping off. Read from the font tables; works for any font.
+void GlyphCache_textBounds(const GFXfont *font, const char *text, int16_t &x1,
+                           int16_t &y1, uint16_t &w, uint16_t &h);
+
+// Draw `text` as print() would with the cursor at (x, y): the top-left for
+// the built-in font, the baseline for the others. Returns the cursor x after
+// the text. May leave `font` selected on the canvas.
+int16_t GlyphCache_drawText(GFXcanvas16 &canvas, const GFXfont *font,
+                            int16_t x, int16_t y, const char *text,
+                            uint16_t color);
+// The same into an indexed canvas, with `color` a palette index.
+int16_t GlyphCache_drawText(GFXcanvas8 &canvas, const GFXfont *font,
+                            int16_t x, int16_t y, const char *text,
+                            uint8_t color);
@@ -0,0 +1,38 @@
+#pragma once
+#include "Settings.h"
+
+// Diagnostics on Serial, filtered at build time. Sites below GHOST_LOG_LEVEL
+// (a LoggingLevel value, default LOG_LEVEL_INFO) sit behind a constant-false
+// test: their arguments are never evaluated, no String is built and nothing
+// is formatted, and the optimizer drops them. Enabled sites format
+// printf-style into a stack buffer, so logging does not touch the heap.
+//
+//   LOG_DEBUG("Touch: raw(%d,%d)", p.x, p.y);
+//
+// Build with -D GHOST_LOG_LEVEL=3 for debug output, or 0 for errors only.
+// SDManager::logEvent() sends lines to the SD event log instead, where the
+// `logging.level` setting filters them as well.
+
+#ifndef GHOST_LOG_LEVEL
+#define GHOST_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Whether sites at `level` are compiled in.
+#define LOG_ENABLED(level) ((int)(level) <= (int)(GHOST_LOG_LEVEL))
+
+// Longest line, with its terminator; longer lines are cut.
+static const size_t LOG_LINE_MAX = 256;
+
+// Format one line and print it with a newline.
+void Log_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#define LOG_AT(level, ...)                                                     \
+  do {                                                                         \
+    if (LOG_ENABLED(level))                                                    \
+      Log_printf(__VA_ARGS__);                                                 \
+  } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+// Per-stage timing of loop(). Each stage is timed with the CPU cycle counter
+// and folded into a log-linear histogram (four buckets per power of two), so
+// min/avg/max are exact and p99 is within 25%. Stats cover the window since
+// the last reset. Only the loop task records; nothing here is locked.
+//
+// Build with -D GHOST_LOOP_PROFILER to enable it. Without the flag the
+// macros below expand to nothing, so loop() pays nothing and the linker
+// drops this module.
+
+enum ProfilerStage : uint8_t {
+  PROF_LOOP, // the whole loop() iteration
+  PROF_TOUCH,
+  PROF_SENSORS, // letter poll and status bar
+  PROF_DICTIONARY,
+  PROF_LOGGING, // session log lines, timing report, trace flush
+  PROF_HEARTBEAT,
+  PROF_RADAR,
+  PROF_STAGE_COUNT
+};
+
+struct ProfilerStats {
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t avgUs;
+  uint32_t p99Us;
+  uint32_t maxUs;
+};
+
+void Profiler_record(ProfilerStage stage, uint32_t cycles);
+void Profiler_getStats(ProfilerStage stage, ProfilerStats &out);
+void Profiler_reset();
+const char *Profiler_stageName(ProfilerStage stage);
+
+// One CSV row per stage after a "stage,count,min_us,avg_us,p99_us,max_us"
+// header.
+void Profiler_writeCsv(Print &out);
+void Profiler_setOverlay(bool on);
+// Draw the stats table over the lower part of the recents panel.
+void Profiler_drawOverlay();
+// Call once per loop, outside any stage: refreshes the overlay once a second
+// and, once a minute, writes the CSV to Serial and SD and resets the window.
+void Profiler_update();
+
+struct ProfilerScope {
+  explicit ProfilerScope(ProfilerStage stage)
+      : stage(stage), start(ESP.getCycleCount()) {}
+  ~ProfilerScope() { Profiler_record(stage, ESP.getCycleCount() - start); }
+
+  ProfilerStage stage;
+  uint32_t start;
+};
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+#ifdef GHOST_LOOP_PROFILER
+// Time the rest of the enclosing block as `stage`.
+#define PROFILE_SCOPE(stage)                                                   \
+  ProfilerScope PROFILER_CONCAT(profilerScope_, __LINE__)(stage)
+#define PROFILE_UPDATE() Profiler_update()
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#define PROFILE_UPDATE() ((void)0)
+#endif
@@ -1,4 +1,7 @@
 #pragma once
+#include "Dictionary.h"
+#include "Log.h"
+#include "SessionLog.h"
 #include <Arduino.h>
 #include <SPI.h>
 
@@ -10,10 +13,72 @@ namespace SDManager {
   bool loadSystemConfig();
   bool saveDefaultSystemConfigIfMissing();
 
-  void logEvent(const String &line);
+  // One printf-style line in /logs/events.log, if `logging.level` lets
+  // `level` through; the line is only formatted after that check. Like the
+  // session log, it is queued for the SD writer task, which keeps the file
+  // open, writes whole sectors at least every `logging.flush_ms` and rotates
+  // it to events.1.log .. events.3.log at 64 KB, so the event logs stay
+  // under 256 KB. UI loop only; events arriving while 16 are waiting are
+  // dropped. LOG_EVENT() also applies GHOST_LOG_LEVEL.
+  void logEvent(LoggingLevel level, const char *fmt, ...)
+      __attribute__((format(printf, 2, 3)));
+
+  struct EventLogStats {
+    uint32_t events;    // queued
+    uint32_t dropped;   // queue full, or the file could not be opened
+    uint32_t writes;    // blocks written to the card
+    uint32_t bytes;     // bytes written to the card
+    uint32_t rotations; // times events.log was moved to events.1.log
+  };
+  void getEventLogStats(EventLogStats &out);
+
+  // Session log in /logs/sessions, as CSV or, with `logging.format` set to
+  // "binary", as compact .grs records (SessionLog.h). The logSession* calls
+  // only copy a record into a RAM queue (microseconds); a low-priority task
+  // encodes the records and writes them in sector-aligned blocks of
+  // `logging.flush_bytes`, flushing at least every `logging.flush_ms`.
+  // Records arriving while the queue is full are dropped and counted.
+  // With `logging.prealloc_kb` set the task zero-fills up to that much
+  // ahead of the records when idle, so clusters are not allocated between
+  // record blocks; the zeros are trimmed on close, or on the next start
+  // after a power cut.
+  // endSessionLog() writes everything queued before it and closes the file.
   void startSessionLog();
+  void logSessionLetter(char letter, float tempC, float humidity);
+  void logSessionWord(const DictHit &hit);
+  void logSessionTiming(const SensorTimingStats &stats);
+  // Free-form "source,type,value,extra", cut to SESSION_TEXT_MAX - 1 chars.
   void logSessionLine(const String &line);
   void endSessionLog();
 
+  const uint8_t WRITE_HIST_BUCKETS = 11;
+  struct SessionLogStats {
+    uint32_t records;    // queued since startSessionLog()
+    uint32_t dropped;    // lost to a full queue
+    uint16_t maxDepth;   // most records waiting at once
+    uint32_t writes;     // blocks written to the card
+    uint32_t bytes;      // bytes written to the card
+    uint32_t maxWriteUs; // longest write, with its flush
+    // Writes by duration with their flush: under 1 ms, 1-2 ms, 2-4 ms and
+    // so on up to 512 ms, then longer.
+    uint32_t writeHist[WRITE_HIST_BUCKETS];
+  };
+  void getSessionLogStats(SessionLogStats &out);
+
+  // Latest LoopProfiler window as CSV in /logs/profile.csv (overwritten).
+  void saveLoopProfile();
+
+  // Binary sensor trace (see SensorTrace.h) under /logs/traces.
+  bool startSensorTrace();
+  void appendSensorTrace(const uint8_t *data, size_t len);
+  void endSensorTrace();
+
   bool available();
+  const char *dictionaryDir();
 }
+
+#define LOG_EVENT(level, ...)                                                  \
+  do {                                                                         \
+    if (LOG_ENABLED(level))                                                    \
+      SDManager::logEvent(level, __VA_ARGS__);                                 \
+  } while (0)
@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+
+// Large dictionaries streamed from the SD card's /dictionary folder as .sfx
+// files (tools/host/dictc -s). Only the per-block key index stays in RAM;
+// word blocks are read on demand through a small LRU block cache.
+
+// Enumerate /dictionary/*.sfx; returns the number of usable files.
+uint8_t SdDictionary_scan();
+uint8_t SdDictionary_getCount();
+const char *SdDictionary_getName(uint8_t idx);
+
+bool SdDictionary_open(uint8_t idx);
+void SdDictionary_close();
+bool SdDictionary_isOpen();
+
+// Lengths of every word that is a suffix of letters[0..count), shortest first.
+uint8_t SdDictionary_suffixLengths(const char *letters, int count,
+                                   uint8_t *lengths, uint8_t maxLengths);
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// Hardware-independent half of letter generation: motion variance windows,
+// scoring and the stability filter. sensors.cpp feeds it live readings and
+// the host replay backend feeds it a recorded SensorTrace, so both produce
+// the same letters from the same inputs. No Arduino dependencies.
+
+// Raw MPU6050 counts at the ranges Sensors_begin() selects.
+struct ImuSample {
+  int16_t accel[3];
+  int16_t gyro[3];
+};
+static const float IMU_ACCEL_LSB_PER_G = 4096.0f; // 8 g range
+static const float IMU_GYRO_LSB_PER_DPS = 65.5f;  // 500 deg/s range
+
+// Everything else one SAMPLE_PERIOD_MS step reads.
+struct SensorSample {
+  uint32_t timestampMs; // millis() at the start of the step; seeds the noise
+  float tempC;
+  float humidity;
+  int16_t hallRaw;
+  int16_t wifiStrongest;
+  float wifiVariance;
+  int16_t wifiCount;
+  float varianceScale;
+};
+
+// imuRateHz sizes the motion windows to ENTROPY_WINDOW_MS; 0 means one IMU
+// reading per step.
+void SensorPipeline_begin(uint16_t imuRateHz);
+void SensorPipeline_addImu(const ImuSample &s);
+// Scores one step with the IMU readings added since the previous one. True
+// when a letter has been stable for STABLE_SAMPLES_REQUIRED steps.
+bool SensorPipeline_sample(const SensorSample &s, char &outLetter);
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+
+// Turns one round of sensor readings into a letter. Each reading is mapped
+// onto [0, 1] over a fixed range, the results are combined with fixed
+// weights, and a noise byte is mixed in.
+//
+// There are two implementations. The float one is the reference. The Q16
+// fixed-point one uses precomputed reciprocal scales, so it has no divides
+// and no float math after the inputs are converted once. Building with
+// -D GHOST_FIXED_POINT_SCORE makes SensorScore_letter() use the fixed-point
+// path. Both paths are always compiled so host tools can compare them. The
+// header has no Arduino dependencies.
+
+struct SensorReadings {
+  float tempC;
+  float humidity;
+  float accelMag;    // m/s^2
+  float gyroMag;     // rad/s
+  float accelVar;    // variance of accelMag over the entropy window
+  float gyroVar;     // variance of gyroMag over the entropy window
+  int16_t hallRaw;
+  int16_t wifiStrongest; // dBm
+  float wifiVariance;    // RSSI variance of the last scan
+  int16_t wifiCount;
+  float varianceScale;   // Settings varianceScale
+  uint8_t noise;         // entropy byte mixed into the score
+};
+
+static const int32_t SENSOR_SCORE_ONE = 65536; // 1.0 in Q16
+
+float SensorScore_float(const SensorReadings &r); // [0, 1]
+int32_t SensorScore_q16(const SensorReadings &r); // [0, SENSOR_SCORE_ONE]
+char SensorScore_letterFromFloat(float score);
+char SensorScore_letterFromQ16(int32_t score);
+// Letter for r using the path selected at compile time.
+char SensorScore_letter(const SensorReadings &r);
+
+// Approximate sqrt(x*x + y*y + z*z) for raw int16 sensor vectors, with no
+// multiply wider than 32 bits and no square root: the larger of two linear
+// forms in the sorted absolute components (a 3D alpha-max-beta-min). Within
+// SENSOR_SCORE_MAG_ERROR of the true length in every direction.
+static const float SENSOR_SCORE_MAG_ERROR = 0.03f;
+uint32_t SensorScore_magnitude(int32_t x, int32_t y, int32_t z);
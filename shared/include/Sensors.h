@@ -1,5 +1,9 @@
 #pragma once
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Implemented by sensors.cpp on the device and by the trace replay backend in
+// tools/host, so this header stays free of Arduino types.
 
 struct SensorPins {
   int dhtPin;
@@ -8,11 +12,48 @@ struct SensorPins {
   int i2cScl;
 };
 
+// MPU6050 sampling. sampleRateHz > 0 runs the IMU from its hardware FIFO at
+// that rate and drains it in I2C bursts; 0 takes one reading per letter
+// sample. bandwidthHz picks the nearest digital low-pass filter setting.
+struct ImuConfig {
+  uint16_t sampleRateHz;
+  uint16_t bandwidthHz;
+};
+
+// Sample-period timing of the sampling task since the last reset.
+struct SensorTimingStats {
+  uint32_t samples;        // periods measured
+  uint64_t jitterSumUs;    // sum of |period - SAMPLE_PERIOD_MS|
+  uint32_t maxJitterUs;    // worst |period - SAMPLE_PERIOD_MS|
+  uint32_t maxSampleUs;    // longest time spent reading sensors
+  uint32_t overruns;       // samples that took longer than a period
+  uint32_t droppedLetters; // queue full, letter lost
+  uint32_t staleLetters;   // dequeued too late (UI not polling), discarded
+  uint32_t imuSamples;     // IMU readings fed into the motion windows
+  uint32_t imuOverflows;   // FIFO overflowed between drains, data lost
+  uint32_t traceDropped;   // trace records lost to a full queue
+};
+
 void Sensors_configure(const SensorPins& pins);
+void Sensors_configureImu(const ImuConfig &cfg); // before Sensors_begin()
 void Sensors_begin();
+// Moves sampling onto its own task; pollLetter() then only dequeues.
+void Sensors_startTask();
+// Non-blocking: the next stable letter, if one is queued.
 bool Sensors_pollLetter(char &outLetter);
+void Sensors_getTimingStats(SensorTimingStats &out);
+void Sensors_resetTimingStats();
+
+// Mirror every raw reading into a SensorTrace. Sensors_readTrace() then
+// returns the trace bytes (header first) for the caller to store.
+void Sensors_setTraceRecording(bool on);
+bool Sensors_isTraceRecording();
+size_t Sensors_readTrace(uint8_t *dst, size_t maxBytes);
 
+// Latest DHT reading, whether or not a letter has fired since.
 float Sensors_getLastTempC();
 float Sensors_getLastHumidity();
+// The reading the last letter from Sensors_pollLetter() was sampled with.
+void Sensors_getLetterReading(float &tempC, float &humidity);
 uint8_t Sensors_getBatteryPercent();
 uint8_t Sensors_getWifiStrengthPercent();
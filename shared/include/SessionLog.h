@@ -0,0 +1,117 @@
+#pragma once
+#include "DictMatcher.h"
+#include "Sensors.h"
+#include "config_core.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Session log records. Callers fill in one fixed-size record per event, which
+// is cheap enough for the UI loop; the SD writer task turns queued records
+// into CSV lines or binary records. No Arduino dependencies.
+
+// Every entry Dictionary_getCount() can report: built-ins, "All", SD lists.
+static const size_t SESSION_DICTS_MAX = DICT_FILE_COUNT + 1 + SD_DICT_MAX;
+static_assert(SESSION_DICTS_MAX <= 255, "dictionary indexes are one byte");
+static const size_t SESSION_NAME_MAX = 31;
+static const size_t SESSION_TEXT_MAX = 64;
+// Longest formatted line or binary record, with its newline.
+static const size_t SESSION_LINE_MAX = 256;
+
+enum SessionRecordType : uint8_t {
+  SESSION_LETTER, // sensors,letter,<letter>,temp=..;hum=..
+  SESSION_WORD,   // dictionary,word,<word>,dict=<sources>
+  SESSION_TIMING, // sensors,timing,samples=..;mean_jitter_us=..;...
+  SESSION_TEXT,   // preformatted "source,type,value,extra"
+  SESSION_DICT    // binary files only: the active dictionary changed
+};
+
+struct SessionLetter {
+  char letter;
+  float tempC;
+  float humidity;
+};
+
+struct SessionWord {
+  char word[LETTER_BUFFER_SIZE + 1];
+  uint32_t id;  // word id in the active dictionary, or DICT_NO_WORD
+  uint8_t tags; // lists containing it ("All" entry), else 0
+  uint8_t dict; // active dictionary index
+};
+
+struct SessionRecord {
+  uint32_t ms;       // millis() when logged
+  uint32_t unixTime; // time() when logged; 0 if it was not set
+  uint8_t type;      // SessionRecordType
+  union {
+    SessionLetter letter;
+    SessionWord word;
+    SensorTimingStats timing;
+    char text[SESSION_TEXT_MAX];
+    uint8_t dict; // SESSION_DICT
+  };
+};
+
+// Dictionary names by index, for the dict= column: tag bit i names entry i,
+// and untagged hits name the dictionary that was active.
+struct SessionDictNames {
+  const char *names[SESSION_DICTS_MAX];
+  uint8_t count;
+};
+
+// The header line of a session file, with its newline.
+const char *SessionLog_csvHeader();
+// Format `r` as one CSV line with its newline into dst (at least
+// SESSION_LINE_MAX bytes). Returns the line length; 0 for SESSION_DICT.
+size_t SessionLog_formatCsv(const SessionRecord &r,
+                            const SessionDictNames &dicts, char *dst);
+// The timestamp column: local time as 2024-01-31T23-59-59, or seconds since
+// boot as 0000-00-00T00-00-<s> when the clock was not set.
+size_t SessionLog_formatTimestamp(uint32_t unixTime, uint32_t ms, char *dst,
+                                  size_t size);
+
+// Binary session log (.grs): a header with the dictionary names, then one
+// tagged record per CSV row. Times are varint deltas from the previous
+// record, temperature and humidity are zigzag deltas in tenths, and words
+// are varint ids into the active dictionary. A word's text follows its id
+// the first time the id appears after a SESSION_DICT record, so a file
+// decodes without the word lists: ids depend on how a list was loaded.
+// A letter row takes about 6 bytes against about 57 as CSV.
+
+static const uint8_t SESSION_BIN_VERSION = 1;
+static const size_t SESSION_BIN_HEADER_BYTES = 8; // before the names
+static const size_t SESSION_BIN_HEADER_MAX =
+    SESSION_BIN_HEADER_BYTES + SESSION_DICTS_MAX * (1 + SESSION_NAME_MAX);
+// Word ids whose text is already in the file, per dictionary.
+static const size_t SESSION_BIN_WORD_SLOTS = 256;
+
+// Running state of one file, for the encoder and the decoder alike.
+struct SessionBinState {
+  uint32_t ms;
+  uint32_t unixTime;
+  int32_t tempTenths;
+  int32_t humTenths;
+  uint8_t dict; // 0xFF until the first SESSION_DICT record
+  uint16_t wordCount;
+  uint32_t words[SESSION_BIN_WORD_SLOTS]; // encoder only: id + 1, 0 if free
+};
+
+void SessionLog_resetBinary(SessionBinState &s);
+// dst needs SESSION_BIN_HEADER_MAX bytes. Names are cut to SESSION_NAME_MAX.
+size_t SessionLog_encodeBinaryHeader(uint8_t *dst,
+                                     const SessionDictNames &dicts);
+// Parse a header, copying the names into `storage` (SESSION_DICTS_MAX
+// rows) and pointing `dicts` at them. Returns the header size, or 0 if it
+// is not a session log or is truncated.
+size_t SessionLog_decodeBinaryHeader(const uint8_t *src, size_t len,
+                                     char storage[][SESSION_NAME_MAX + 1],
+                                     SessionDictNames &dicts);
+// Encode `r` (after a SESSION_DICT record if the dictionary changed) into
+// dst, which needs SESSION_LINE_MAX bytes. Returns the bytes written.
+size_t SessionLog_encodeBinary(const SessionRecord &r, SessionBinState &s,
+                               uint8_t *dst);
+// Decode the record at src. A word whose text was written earlier comes
+// back with an empty word and its id; the caller keeps the id -> text map
+// and clears it on SESSION_DICT. Returns the record size, or 0 if it is
+// truncated or malformed.
+size_t SessionLog_decodeBinary(const uint8_t *src, size_t len,
+                               SessionBinState &s, SessionRecord &out);
@@ -29,6 +29,13 @@ struct DeviceSettings {
   uint16_t heartbeatBpm;    // heartbeat animation speed
   bool loggingEnabled;
   uint8_t loggingLevel;     // see LoggingLevel enum
+  bool sensorTrace;         // record raw sensor readings for host replay
+  uint16_t logFlushMs;      // longest a session log line waits in RAM
+  uint16_t logFlushBytes;   // buffered session log bytes per SD write
+  uint8_t logFormat;        // see LogFormat enum
+  uint16_t logPreallocKb;   // session file space reserved up front, 0 = off
+  uint8_t matchPolicy;      // see MatchPolicy enum
+  uint8_t minWordLength;    // shorter dictionary hits are ignored
   UiSettings ui;
 };
 
@@ -39,6 +46,20 @@ enum LoggingLevel : uint8_t {
   LOG_LEVEL_DEBUG
 };
 
+// Session log file format (SessionLog.h).
+enum LogFormat : uint8_t {
+  LOG_FORMAT_CSV = 0, // .csv, readable as is
+  LOG_FORMAT_BINARY   // .grs, about a tenth of the size; tools/host decodes
+};
+
+// Which word to report when several dictionary words end on the same letter.
+enum MatchPolicy : uint8_t {
+  MATCH_POLICY_LONGEST = 0,
+  MATCH_POLICY_SHORTEST,
+  MATCH_POLICY_FIRST, // earliest in the list file
+  MATCH_POLICY_ALL    // every overlapping word; letters are not consumed
+};
+
 DeviceSettings& Settings_get();
 void Settings_loadDefaults();
 
@@ -48,8 +69,20 @@ float Settings_clampVariance(float v);
 uint8_t Settings_clampBrightness(uint8_t level, uint8_t maxLevel = 3);
 uint8_t Settings_clampDictionaryIndex(uint8_t idx, uint8_t maxIndex);
 uint16_t Settings_clampHeartbeat(uint16_t bpm, uint16_t minBpm = 40, uint16_t maxBpm = 240);
+// Whole 512-byte sectors, 512 B .. 4 KB.
+uint16_t Settings_clampLogFlushBytes(uint32_t bytes);
+// 100 ms .. 60 s; shorter would have the writer sync on every pass.
+uint16_t Settings_clampLogFlushMs(uint32_t ms);
+// 0 (off) .. 4096 KB of session file reserved ahead of the rows.
+uint16_t Settings_clampLogPreallocKb(uint32_t kb);
+// 1 .. LETTER_BUFFER_SIZE letters.
+uint8_t Settings_clampMinWordLength(uint32_t len);
 LoggingLevel Settings_parseLoggingLevel(const String& s);
 const char* Settings_loggingLevelToString(LoggingLevel level);
+LogFormat Settings_parseLogFormat(const String& s);
+const char* Settings_logFormatToString(LogFormat format);
+MatchPolicy Settings_parseMatchPolicy(const String& s);
+const char* Settings_matchPolicyToString(MatchPolicy policy);
 ComplicationType Settings_parseComplicationType(const String& s);
 const char* Settings_complicationTypeToString(ComplicationType type);
 
@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+
+// Mean and sample variance over the last `capacity` values in O(1) per value.
+// Uses Welford's update to add a value and its inverse to retire the oldest
+// one, so no pass over the window is needed. The window buffer is owned by
+// the caller, so the length is a choice made per use.
+//
+// The running mean and m2 are kept in double. After a burst of motion, m2 has
+// to shrink back to a tiny variance, and float cancellation would leave
+// percent-level errors. Each full window of replacements also triggers an
+// exact two-pass recompute, which is still O(1) amortized. The header has no
+// Arduino dependencies so host tools can build it too.
+
+struct SlidingStats {
+  float *window; // capacity values, oldest overwritten first
+  uint16_t capacity;
+  uint16_t count;
+  uint16_t next; // slot the next value goes into
+  uint16_t sinceResync;
+  double mean;
+  double m2; // sum of squared deviations from mean
+};
+
+void SlidingStats_init(SlidingStats &s, float *window, uint16_t capacity);
+void SlidingStats_reset(SlidingStats &s);
+// Add a value; once the window is full this also retires the oldest one.
+void SlidingStats_add(SlidingStats &s, float x);
+float SlidingStats_mean(const SlidingStats &s);
+// Sample variance (n - 1 denominator); 0 with fewer than two values.
+float SlidingStats_variance(const SlidingStats &s);
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-capacity single-producer/single-consumer ring buffer. One task may
+// push() while another reads and pops without a lock: each side only writes
+// its own free-running index and publishes it with release/acquire ordering,
+// so an element is fully written before the consumer can see it.
+//
+// push() is the only producer call; everything else that moves or reads
+// elements belongs to the consumer. Code that owns both ends (e.g. a sliding
+// window that drops its oldest entry when full) may mix them freely.
+// N must be a power of two so the indices can wrap around 2^32.
+template <typename T, size_t N> class SpscRing {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of 2");
+
+public:
+  SpscRing() : head(0), tail(0) {}
+
+  static size_t capacity() { return N; }
+  size_t size() const {
+    return head.load(std::memory_order_acquire) -
+           tail.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  bool full() const { return size() >= N; }
+
+  // Producer: false (and nothing stored) when full.
+  bool push(const T &item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N)
+      return false;
+    items[h & MASK] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: remove the oldest element.
+  bool pop(T &out) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t)
+      return false;
+    out = items[t & MASK];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: discard up to n of the oldest elements.
+  void drop(size_t n) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    size_t avail = head.load(std::memory_order_acquire) - t;
+    if (n > avail)
+      n = avail;
+    tail.store(t + (uint32_t)n, std::memory_order_release);
+  }
+
+  // Consumer: discard everything published so far.
+  void clear() {
+    tail.store(head.load(std::memory_order_acquire),
+               std::memory_order_release);
+  }
+
+  // Consumer: element i counted from the oldest (0) to the newest (size()-1).
+  T &at(size_t i) {
+    return items[(tail.load(std::memory_order_relaxed) + i) & MASK];
+  }
+  const T &at(size_t i) const {
+    return items[(tail.load(std::memory_order_relaxed) + i) & MASK];
+  }
+  T &newest() { return at(size() - 1); }
+
+  // Consumer: copy the newest min(size(), maxCount) elements, oldest first,
+  // into a contiguous array. Returns how many were copied.
+  size_t copyLatest(T *dst, size_t maxCount) const {
+    size_t count = size();
+    size_t skip = count > maxCount ? count - maxCount : 0;
+    for (size_t i = skip; i < count; i++)
+      dst[i - skip] = at(i);
+    return count - skip;
+  }
+
+private:
+  static const uint32_t MASK = (uint32_t)(N - 1);
+
+  T items[N];
+  std::atomic<uint32_t> head; // next slot the producer writes
+  std::atomic<uint32_t> tail; // next slot the consumer reads
+};
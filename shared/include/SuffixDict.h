@@ -0,0 +1,67 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Suffix-sorted dictionary for lists too large to keep in RAM (tools/host/dictc
+// -s). Every word is stored reversed, sorted bytewise and packed into
+// fixed-size blocks that never split a word. Only the header and one short key
+// per block (the first bytes of the block's first word) live in RAM; a word
+// that is a suffix of the letter stream is a prefix of the reversed stream, so
+// each candidate length costs one binary search over the keys plus a block
+// read. Lengths are only probed if some word of that length ends in the
+// stream's last letter (version 2 adds a length mask per last letter after
+// the keys). Block I/O is supplied by the caller so this stays
+// storage-agnostic.
+
+static const uint32_t SUFFIX_DICT_MAGIC = 0x58535247UL; // "GRSX"
+static const uint16_t SUFFIX_DICT_VERSION = 2; // 1 is still read
+static const uint8_t SUFFIX_DICT_LETTERS = 26;  // last-letter masks, A..Z
+static const uint16_t SUFFIX_DICT_BLOCK_SIZE = 512; // one SD sector
+static const uint8_t SUFFIX_DICT_KEY_LEN = 8;
+static const size_t SUFFIX_DICT_NAME_LEN = 16;
+
+struct SuffixDictHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;
+  uint32_t wordCount;
+  uint32_t blockCount;
+  uint32_t indexOffset;  // blockCount keys of SUFFIX_DICT_KEY_LEN bytes
+  uint32_t blocksOffset; // block-aligned from the start of the file
+  uint32_t indexCrc;     // CRC-32 (DictImage_crc32) of the keys, then masks
+  uint32_t lengthMask;   // bit n-1 set when a word of length n exists
+  uint16_t blockSize;
+  uint8_t keyLen;
+  uint8_t maxWordLength;
+  char name[SUFFIX_DICT_NAME_LEN];
+  // SUFFIX_DICT_LETTERS lengthMask-style masks of the words ending in 'A'
+  // .. 'Z', right after the keys; 0 in version 1 files.
+  uint32_t letterMaskOffset;
+  uint8_t reserved[8];
+};
+
+// Returns the block's bytes (blockSize long) or nullptr on I/O failure.
+typedef const char *(*SuffixDictReadBlock)(uint32_t block, void *ctx);
+
+struct SuffixDict {
+  const uint8_t *keys; // blockCount * SUFFIX_DICT_KEY_LEN bytes
+  uint32_t blockCount;
+  uint16_t blockSize;
+  uint32_t lengthMask;
+  const uint32_t *letterMasks; // SUFFIX_DICT_LETTERS masks, or nullptr
+  uint8_t maxWordLength;
+  SuffixDictReadBlock readBlock;
+  void *ctx;
+};
+
+bool SuffixDict_validHeader(const SuffixDictHeader &h);
+
+// Find the shortest word that is a suffix of letters[0..count) and copy it,
+// NUL-terminated, into out. Returns false if none (or on I/O failure).
+bool SuffixDict_findSuffix(const SuffixDict &d, const char *letters, int count,
+                           char *out, size_t outSize);
+// Lengths of every word that is a suffix of letters[0..count), shortest
+// first. Returns how many were written (at most maxLengths).
+uint8_t SuffixDict_suffixLengths(const SuffixDict &d, const char *letters,
+                                 int count, uint8_t *lengths,
+                                 uint8_t maxLengths);
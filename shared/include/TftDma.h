@@ -0,0 +1,71 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Asynchronous pixel pushes to the ILI9341 over SPI DMA (ESP-IDF spi_master
+// on the display's bus). Each blit is queued as six SPI transactions:
+// CASET, PASET and RAMWR with their parameters, then the pixels. The DC pin is
+// driven from the pre-transfer callback, so nothing waits on the CPU between
+// them.
+//
+// TftDma_blit() byte-swaps the pixels into one of two DMA staging buffers of
+// TFT_DMA_BUFFER_PIXELS and returns while the transfer runs, so the caller's
+// buffer is free for the next frame at once. Indexed-colour canvases are
+// expanded through their palette in the same copy. A blit taller than one
+// buffer goes out in row bands; when both buffers are in flight the call
+// waits for the older one.
+//
+// The bus is shared with CPU-driven transfers (Adafruit_ILI9341, the touch
+// controller). Call TftDma_waitAll() before any of those. Everything here runs
+// on the loop task; completion callbacks run inside TftDma_* calls and must
+// not queue blits.
+//
+// Display only starts it in firmware built with -D GHOST_TFT_DMA; otherwise
+// every blit is CPU-driven. spi_bus_initialize() takes over VSPI, which the
+// Arduino SPI HAL also drives, and after each burst only the MISO and
+// full-duplex bits the touch reads need are restored. Whether the HAL relies
+// on any other user/ctrl/DMA register the driver changes has not been checked
+// on a board yet; the timings so far come from the host simulator's model.
+
+struct TftDmaConfig {
+  int cs;
+  int dc;
+  int sclk;
+  int mosi;
+  uint32_t freqHz;
+};
+
+struct TftDmaStats {
+  uint32_t blits;
+  uint64_t bytes;  // pixel bytes queued
+  uint32_t waits;  // calls that had to block for the bus
+  uint64_t waitUs; // time spent blocked
+};
+
+typedef void (*TftDmaCallback)(uint32_t fence, void *ctx);
+
+// Claims the SPI host and allocates the staging buffers. False leaves DMA off
+// (pins not given, no DMA memory, or the driver refused).
+bool TftDma_begin(const TftDmaConfig &cfg);
+bool TftDma_ready();
+
+// Queue w x h pixels whose rows are `stride` pixels apart. w must not exceed
+// TFT_DMA_BUFFER_PIXELS. Returns the blit's fence (never 0).
+uint32_t TftDma_blit(int16_t x, int16_t y, int16_t w, int16_t h,
+                     const uint16_t *pixels, int16_t stride,
+                     TftDmaCallback done, void *ctx);
+// As TftDma_blit(), for 8-bit pixels that index `palette` (RGB565). Indices
+// are expanded while they are staged, so the palette is only read during the
+// call.
+uint32_t TftDma_blitIndexed(int16_t x, int16_t y, int16_t w, int16_t h,
+                            const uint8_t *pixels, int16_t stride,
+                            const uint16_t *palette, TftDmaCallback done,
+                            void *ctx);
+// True once the blit with this fence (and every earlier one) is on the glass.
+bool TftDma_done(uint32_t fence);
+void TftDma_wait(uint32_t fence);
+// Wait until the bus is idle.
+void TftDma_waitAll();
+
+void TftDma_getStats(TftDmaStats &out);
+void TftDma_resetStats();
@@ -17,7 +17,22 @@ static const int HEARTBEAT_BUFFER_W = HEARTBEAT_W + (HEARTBEAT_W / 2); // 1.5x v
 static const int RADAR_W = INNER_W - 2 * MODULE_BOX_W;
 static const int RADAR_H = INNER_H - HEADER_H - HEARTBEAT_H;
 
+// Each of the two SPI DMA staging buffers holds this many pixels (16 KB);
+// larger blits go out in row bands.
+static const int TFT_DMA_BUFFER_PIXELS = 8192;
+
 // --- Letter generation ---
 const unsigned long SAMPLE_PERIOD_MS = 200;
 const int STABLE_SAMPLES_REQUIRED = 3;
 const int LETTER_BUFFER_SIZE = 32;
+// Time span of the accel/gyro variance windows, and the most samples a
+// window may hold (4 bytes each). With the IMU FIFO running at a few hundred
+// Hz the window holds hundreds of samples; updates are O(1).
+const unsigned long ENTROPY_WINDOW_MS = 2000;
+const int ENTROPY_WINDOW_MAX = 512;
+
+// --- Dictionaries ---
+// The list is the built-in files, the merged "All" entry, then up to
+// SD_DICT_MAX lists from /dicts on the SD card.
+const int DICT_FILE_COUNT = 3;
+const int SD_DICT_MAX = 16;
@@ -1,58 +1,156 @@
 #include "SDManager.h"
+#include "Dictionary.h"
 #include "Display.h"
+#include "LoopProfiler.h"
 #include "Settings.h"
+#include "SpscRing.h"
 #include <ArduinoJson.h>
 #include <SD.h>
+#include <atomic>
+#include <stdarg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <time.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include <unistd.h>
+#endif
 
 namespace {
 const char *CONFIG_DIR = "/config";
 const char *LOGS_DIR = "/logs";
 const char *SESSIONS_DIR = "/logs/sessions";
+const char *TRACES_DIR = "/logs/traces";
 const char *DICTIONARY_DIR = "/dictionary";
 const char *UI_DIR = "/ui";
 
 const char *SYSTEM_CONFIG_PATH = "/config/system.json";
 const char *EVENT_LOG_PATH = "/logs/events.log";
+const char *LOOP_PROFILE_PATH = "/logs/profile.csv";
+// Where SD.begin() mounts the card in the VFS, for calls SD lacks.
+const char *SD_MOUNT_POINT = "/sd";
+const uint32_t SD_FREQUENCY_HZ = 4000000;
 
 bool sdAvailable = false;
 bool loggingActive = false;
-File sessionFile;
 String currentSessionPath;
+File traceFile;
+unsigned long lastTraceFlushMs = 0;
+const unsigned long TRACE_FLUSH_MS = 1000;
+
+// Session and event logs: records queued by the UI loop, written to the card
+// by logTask.
+const size_t SD_SECTOR_BYTES = 512;
+const size_t SESSION_QUEUE_SIZE = 64;
+const size_t SESSION_BUFFER_BYTES = 4096; // largest logging.flush_bytes
+const size_t EVENT_QUEUE_SIZE = 16;
+const size_t EVENT_TEXT_MAX = 96;
+const size_t EVENT_BUFFER_BYTES = SD_SECTOR_BYTES;
+// events.log moves to events.1.log when the next line would take it past
+// EVENT_LOG_MAX_BYTES, events.1.log to events.2.log and so on; the oldest
+// is deleted, so the event logs never take more than
+// EVENT_LOG_FILES * EVENT_LOG_MAX_BYTES.
+const uint32_t EVENT_LOG_MAX_BYTES = 64 * 1024;
+const uint8_t EVENT_LOG_FILES = 4;
+const UBaseType_t LOG_TASK_PRIORITY = 1; // below sensor sampling
+const uint32_t LOG_TASK_STACK_SIZE = 4096;
+const BaseType_t LOG_TASK_CORE = 0;
+const TickType_t LOG_TASK_POLL = pdMS_TO_TICKS(20);
+
+// A file kept open by logTask and appended to through a staging buffer.
+struct LogStream {
+  LogStream(uint8_t *buffer, size_t capacity)
+      : buffer(buffer), capacity(capacity), blockBytes(capacity),
+        buffered(0), fileBytes(0), unsynced(false), flushMs(0),
+        lastSyncMs(0), writes(0), bytes(0), maxWriteUs(0), writeHist() {}
+
+  File file;
+  uint8_t *buffer;
+  size_t capacity;
+  size_t blockBytes; // logging.flush_bytes, at most capacity
+  size_t buffered;
+  uint32_t fileBytes; // size of the file, as written so far
+  bool unsynced;      // written since the last flush()
+  unsigned long flushMs; // logging.flush_ms
+  unsigned long lastSyncMs;
+  uint32_t writes;
+  uint32_t bytes;
+  uint32_t maxWriteUs; // longest write, with its flush
+  uint32_t writeHist[SDManager::WRITE_HIST_BUCKETS];
+};
+
+struct EventRecord {
+  uint32_t ms;
+  uint32_t unixTime;
+  char text[EVENT_TEXT_MAX];
+};
+
+TaskHandle_t logTaskHandle = nullptr;
+
+SpscRing<SessionRecord, SESSION_QUEUE_SIZE> sessionQueue;
+// Set once the session file is open; from then on only logTask touches
+// sessionStream, until it clears the flag on close.
+std::atomic<bool> sessionOpen(false);
+std::atomic<bool> sessionCloseRequested(false);
+uint8_t sessionBuffer[SESSION_BUFFER_BYTES];
+LogStream sessionStream(sessionBuffer, SESSION_BUFFER_BYTES);
+SDManager::SessionLogStats sessionStats;
+bool sessionBinary = false;     // logging.format
+SessionDictNames sessionDicts;  // for the dict= column
+SessionBinState sessionBin;     // binary encoder state
+// With logging.prealloc_kb set, logTask writes zeros ahead of the records
+// a few sectors per pass, keeping up to that much reserved past them. The
+// card then allocates clusters while the writer is otherwise idle instead
+// of in the middle of record blocks. On close the file is cut back to the
+// records; after a power cut, the next startSessionLog() trims it, finding
+// it through SESSION_OPEN_PATH.
+const char *SESSION_OPEN_PATH = "/logs/session.open";
+const uint8_t SESSION_FILL_SECTORS = 8; // zero sectors per writer pass
+// A .grs record can end in zero bytes; keep a few when trimming.
+const uint32_t SESSION_BIN_ZERO_TAIL = 16;
+const uint8_t ZERO_SECTOR[SD_SECTOR_BYTES] = {};
+uint32_t sessionPreallocBytes = 0; // 0 when off
+uint32_t sessionReserveEnd = 0;    // zero-fill target
+uint32_t sessionFilled = 0;        // file size, records and zeros
+bool sessionMarked = false;        // SESSION_OPEN_PATH names the file
+
+// events.log is opened by logTask on the first event and stays open.
+SpscRing<EventRecord, EVENT_QUEUE_SIZE> eventQueue;
+uint8_t eventBuffer[EVENT_BUFFER_BYTES];
+LogStream eventStream(eventBuffer, EVENT_BUFFER_BYTES);
+// Only logEvent() writes eventStats.events and .dropped (queue full). Lines
+// logTask cannot write go in eventWriteDropped, so each counter has one
+// writer; getEventLogStats() adds the two.
+SDManager::EventLogStats eventStats;
+uint32_t eventWriteDropped = 0;
 
 bool ensureDir(const char *path) {
   if (SD.exists(path))
     return true;
   bool ok = SD.mkdir(path);
   if (!ok) {
-    Serial.print(F("Failed to create dir: "));
-    Serial.println(path);
+    LOG_ERROR("Failed to create dir: %s", path);
   }
   return ok;
 }
 
 String formatTimestamp() {
+  char buf[32];
   time_t now = time(nullptr);
-  struct tm timeinfo;
-  if (now > 0 && localtime_r(&now, &timeinfo)) {
-    char buf[24];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d-%02d-%02d",
-             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-             timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-    return String(buf);
-  }
+  SessionLog_formatTimestamp(now > 0 ? (uint32_t)now : 0, millis(), buf,
+                             sizeof(buf));
+  return String(buf);
+}
 
-  unsigned long ms = millis();
-  char fallback[28];
-  snprintf(fallback, sizeof(fallback), "0000-00-00T00-00-%lu",
-           (unsigned long)(ms / 1000UL));
-  return String(fallback);
+String sessionFilename(bool binary) {
+  String ts = formatTimestamp();
+  ts.replace(":", "-");
+  return String(SESSIONS_DIR) + "/" + ts + (binary ? ".grs" : ".csv");
 }
 
-String sessionFilename() {
+String traceFilename() {
   String ts = formatTimestamp();
   ts.replace(":", "-");
-  return String(SESSIONS_DIR) + "/" + ts + ".csv";
+  return String(TRACES_DIR) + "/" + ts + ".grt";
 }
 
 LoggingLevel currentLoggingLevel() {
@@ -63,6 +161,290 @@ bool levelAllows(LoggingLevel messageLevel) {
   return (int)messageLevel <= (int)currentLoggingLevel();
 }
 
+// --- Log writer (logTask) ---
+
+void openStream(LogStream &s, File file, size_t blockBytes,
+                unsigned long flushMs) {
+  s.file = file;
+  s.blockBytes = min(blockBytes, s.capacity);
+  s.flushMs = flushMs;
+  s.buffered = 0;
+  s.fileBytes = (uint32_t)file.size();
+  s.unsynced = false;
+  s.lastSyncMs = millis();
+}
+
+// Send the staged bytes, and flush() the file when `sync` is set so the
+// directory entry covers them.
+void writeStream(LogStream &s, bool sync) {
+  unsigned long start = micros();
+  if (s.buffered > 0) {
+    size_t n = s.file.write(s.buffer, s.buffered);
+    s.fileBytes += (uint32_t)n;
+    s.bytes += (uint32_t)n;
+    s.writes++;
+    s.buffered = 0;
+    s.unsynced = true;
+  }
+  if (sync && s.unsynced) {
+    s.file.flush();
+    s.unsynced = false;
+    s.lastSyncMs = millis();
+  }
+  uint32_t us = (uint32_t)(micros() - start);
+  if (us > s.maxWriteUs)
+    s.maxWriteUs = us;
+  uint8_t bucket = 0;
+  for (uint32_t ms = us / 1000;
+       ms > 0 && bucket < SDManager::WRITE_HIST_BUCKETS - 1; ms >>= 1)
+    bucket++;
+  s.writeHist[bucket]++;
+  Display_notifySdActivity();
+}
+
+// Append to the staging buffer. A block is sent once it reaches the next
+// multiple of blockBytes in the file, so after a short timed write the
+// following block realigns the file to whole sectors.
+void stageBytes(LogStream &s, const uint8_t *src, size_t len) {
+  while (len > 0) {
+    size_t block = s.blockBytes - s.fileBytes % SD_SECTOR_BYTES;
+    size_t n = min(len, block - s.buffered);
+    memcpy(s.buffer + s.buffered, src, n);
+    s.buffered += n;
+    src += n;
+    len -= n;
+    if (s.buffered == block)
+      writeStream(s, false);
+  }
+}
+
+bool syncDue(const LogStream &s) {
+  return (s.buffered > 0 || s.unsynced) &&
+         millis() - s.lastSyncMs >= s.flushMs;
+}
+
+// One queued record in the file's format.
+size_t encodeSessionRecord(const SessionRecord &r, uint8_t *dst) {
+  if (sessionBinary)
+    return SessionLog_encodeBinary(r, sessionBin, dst);
+  return SessionLog_formatCsv(r, sessionDicts, (char *)dst);
+}
+
+// Zero the next few sectors of reserved space, starting another step once
+// the records are within half a step of the end. The flush writes the FAT
+// for any clusters this allocated.
+void fillSession() {
+  LogStream &s = sessionStream;
+  if (sessionFilled < s.fileBytes)
+    sessionFilled = s.fileBytes;
+  uint32_t end = s.fileBytes + (uint32_t)s.buffered;
+  if (end + sessionPreallocBytes / 2 > sessionReserveEnd)
+    sessionReserveEnd += sessionPreallocBytes;
+  if (sessionFilled >= sessionReserveEnd)
+    return;
+  s.file.seek(sessionFilled);
+  for (uint8_t i = 0;
+       i < SESSION_FILL_SECTORS && sessionFilled < sessionReserveEnd; i++) {
+    size_t n = SD_SECTOR_BYTES - sessionFilled % SD_SECTOR_BYTES;
+    n = min(n, (size_t)(sessionReserveEnd - sessionFilled));
+    if (s.file.write(ZERO_SECTOR, n) != n) {
+      sessionPreallocBytes = 0; // card full: grow as written from here
+      break;
+    }
+    sessionFilled += (uint32_t)n;
+  }
+  s.file.flush();
+  s.file.seek(s.fileBytes);
+}
+
+bool truncateSdFile(const char *path, uint32_t size) {
+#if defined(ARDUINO_ARCH_ESP32)
+  String full = String(SD_MOUNT_POINT) + path;
+  return truncate(full.c_str(), (off_t)size) == 0;
+#else
+  return SD.truncate(path, size);
+#endif
+}
+
+// Bytes of `sector` up to its last non-zero one.
+size_t sectorData(File &f, uint32_t sector, uint8_t *buf) {
+  f.seek(sector * SD_SECTOR_BYTES);
+  size_t n = f.read(buf, SD_SECTOR_BYTES);
+  while (n > 0 && buf[n - 1] == 0)
+    n--;
+  return n;
+}
+
+// Cut a session file left pre-allocated by a power cut back to its records.
+// Records never leave a whole sector zero, so the first zero sector is
+// found by bisection.
+void trimUnclosedSession() {
+  File marker = SD.open(SESSION_OPEN_PATH, FILE_READ);
+  if (!marker)
+    return;
+  String path = marker.readStringUntil('\n');
+  marker.close();
+  path.trim();
+  File f = SD.open(path.c_str(), FILE_READ);
+  if (f) {
+    uint32_t size = (uint32_t)f.size();
+    uint8_t buf[SD_SECTOR_BYTES];
+    uint32_t lo = 0;
+    uint32_t hi = (size + SD_SECTOR_BYTES - 1) / SD_SECTOR_BYTES;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (sectorData(f, mid, buf) > 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    uint32_t end =
+        lo > 0 ? (lo - 1) * SD_SECTOR_BYTES + sectorData(f, lo - 1, buf) : 0;
+    f.close();
+    if (path.endsWith(".grs"))
+      end = min(size, end + SESSION_BIN_ZERO_TAIL);
+    if (end < size && truncateSdFile(path.c_str(), end)) {
+      LOG_INFO("Trimmed unclosed session log %s", path.c_str());
+    }
+  }
+  SD.remove(SESSION_OPEN_PATH);
+}
+
+void writeSession() {
+  uint8_t line[SESSION_LINE_MAX];
+  SessionRecord r;
+  // Read the request first: everything queued before it gets written.
+  bool closing = sessionCloseRequested.load(std::memory_order_acquire);
+  while (sessionQueue.pop(r))
+    stageBytes(sessionStream, line, encodeSessionRecord(r, line));
+  if (closing) {
+    writeStream(sessionStream, true);
+    sessionStream.file.close();
+    if (sessionMarked) {
+      if (sessionFilled > sessionStream.fileBytes &&
+          !truncateSdFile(currentSessionPath.c_str(),
+                          sessionStream.fileBytes))
+        LOG_ERROR("Failed to trim session log");
+      SD.remove(SESSION_OPEN_PATH);
+      sessionMarked = false;
+    }
+    sessionCloseRequested.store(false, std::memory_order_relaxed);
+    sessionOpen.store(false, std::memory_order_release);
+  } else if (syncDue(sessionStream)) {
+    writeStream(sessionStream, true);
+  } else if (sessionPreallocBytes) {
+    fillSession();
+  }
+}
+
+void eventLogPath(uint8_t index, char *dst, size_t size) {
+  if (index == 0)
+    snprintf(dst, size, "%s", EVENT_LOG_PATH);
+  else
+    snprintf(dst, size, "%s/events.%u.log", LOGS_DIR, (unsigned)index);
+}
+
+// The directory is only looked at again when the open fails.
+bool openEventLog(const char *mode) {
+  File f = SD.open(EVENT_LOG_PATH, mode);
+  if (!f && ensureDir(LOGS_DIR))
+    f = SD.open(EVENT_LOG_PATH, mode);
+  if (!f)
+    return false;
+  const DeviceSettings &s = Settings_get();
+  openStream(eventStream, f, EVENT_BUFFER_BYTES, s.logFlushMs);
+  return true;
+}
+
+void rotateEventLog() {
+  writeStream(eventStream, true);
+  eventStream.file.close();
+  char from[32], to[32];
+  eventLogPath(EVENT_LOG_FILES - 1, to, sizeof(to));
+  if (SD.exists(to))
+    SD.remove(to);
+  for (uint8_t i = EVENT_LOG_FILES - 1; i > 0; i--) {
+    eventLogPath(i - 1, from, sizeof(from));
+    eventLogPath(i, to, sizeof(to));
+    if (SD.exists(from))
+      SD.rename(from, to);
+  }
+  eventStats.rotations++;
+  openEventLog(FILE_WRITE);
+}
+
+void writeEvents() {
+  char line[32 + EVENT_TEXT_MAX + 2];
+  EventRecord e;
+  while (eventQueue.pop(e)) {
+    if (!eventStream.file && !openEventLog(FILE_APPEND)) {
+      eventWriteDropped++;
+      continue;
+    }
+    size_t n = SessionLog_formatTimestamp(e.unixTime, e.ms, line, 32);
+    n += (size_t)snprintf(line + n, sizeof(line) - n, " %s\r\n", e.text);
+    if (eventStream.fileBytes + eventStream.buffered + n >
+        EVENT_LOG_MAX_BYTES) {
+      rotateEventLog();
+      if (!eventStream.file) {
+        LOG_WARN("Event log: %s did not reopen after rotation",
+                 EVENT_LOG_PATH);
+        eventWriteDropped++;
+        continue;
+      }
+    }
+    stageBytes(eventStream, (const uint8_t *)line, n);
+  }
+  if (eventStream.file && syncDue(eventStream))
+    writeStream(eventStream, true);
+}
+
+void logTask(void *) {
+  for (;;) {
+    if (sessionOpen.load(std::memory_order_acquire))
+      writeSession();
+    writeEvents();
+    vTaskDelay(LOG_TASK_POLL);
+  }
+}
+
+bool startLogTask() {
+  if (logTaskHandle)
+    return true;
+  if (xTaskCreatePinnedToCore(logTask, "sdLog", LOG_TASK_STACK_SIZE, nullptr,
+                              LOG_TASK_PRIORITY, &logTaskHandle,
+                              LOG_TASK_CORE) != pdPASS) {
+    logTaskHandle = nullptr;
+    LOG_ERROR("Failed to start SD log task");
+    return false;
+  }
+  return true;
+}
+
+// UI loop side: stamp and queue a record.
+void stampRecord(uint32_t &ms, uint32_t &unixTime) {
+  ms = millis();
+  time_t now = time(nullptr);
+  unixTime = now > 0 ? (uint32_t)now : 0;
+}
+
+void queueSessionRecord(SessionRecord &r) {
+  stampRecord(r.ms, r.unixTime);
+  sessionStats.records++;
+  if (!sessionQueue.push(r)) {
+    sessionStats.dropped++;
+    return;
+  }
+  size_t depth = sessionQueue.size();
+  if (depth > sessionStats.maxDepth)
+    sessionStats.maxDepth = (uint16_t)depth;
+}
+
+bool sessionLogging() {
+  return sdAvailable && loggingActive &&
+         sessionOpen.load(std::memory_order_relaxed);
+}
+
 void writeComplication(JsonObject obj, const ComplicationConfig &cfg) {
   obj["type"] = Settings_complicationTypeToString(cfg.type);
   obj["label"] = cfg.label;
@@ -85,11 +467,11 @@ void applyComplication(JsonVariant src, ComplicationConfig &target) {
 
 namespace SDManager {
 bool begin(SPIClass &bus, int csPin) {
-  sdAvailable = SD.begin(csPin, bus);
+  sdAvailable = SD.begin(csPin, bus, SD_FREQUENCY_HZ, SD_MOUNT_POINT);
   if (!sdAvailable) {
-    Serial.println(F("SD init failed!"));
+    LOG_ERROR("SD init failed!");
   } else {
-    Serial.println(F("SD init OK."));
+    LOG_INFO("SD init OK.");
   }
   loggingActive = Settings_get().loggingEnabled;
   // Update UI indicators with fresh SD/logging state.
@@ -100,11 +482,13 @@ bool begin(SPIClass &bus, int csPin) {
 
 bool available() { return sdAvailable; }
 
+const char *dictionaryDir() { return DICTIONARY_DIR; }
+
 void ensureDirectories() {
   if (!sdAvailable)
     return;
-  const char *dirs[] = {CONFIG_DIR, LOGS_DIR, SESSIONS_DIR, DICTIONARY_DIR,
-                        UI_DIR};
+  const char *dirs[] = {CONFIG_DIR,     LOGS_DIR, SESSIONS_DIR, TRACES_DIR,
+                        DICTIONARY_DIR, UI_DIR};
   for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
     ensureDir(dirs[i]);
   }
@@ -127,6 +511,15 @@ bool saveDefaultSystemConfigIfMissing() {
   logging["enabled"] = s.loggingEnabled;
   logging["level"] =
       Settings_loggingLevelToString((LoggingLevel)s.loggingLevel);
+  logging["sensor_trace"] = s.sensorTrace;
+  logging["flush_ms"] = s.logFlushMs;
+  logging["flush_bytes"] = s.logFlushBytes;
+  logging["format"] = Settings_logFormatToString((LogFormat)s.logFormat);
+  logging["prealloc_kb"] = s.logPreallocKb;
+  JsonObject dictionary = doc["dictionary"].to<JsonObject>();
+  dictionary["match"] =
+      Settings_matchPolicyToString((MatchPolicy)s.matchPolicy);
+  dictionary["min_length"] = s.minWordLength;
 
   JsonObject ui = doc["ui"].to<JsonObject>();
   JsonObject complications = ui["complications"].to<JsonObject>();
@@ -139,7 +532,7 @@ bool saveDefaultSystemConfigIfMissing() {
 
   File f = SD.open(SYSTEM_CONFIG_PATH, FILE_WRITE);
   if (!f) {
-    Serial.println(F("Failed to create default system.json"));
+    LOG_ERROR("Failed to create default system.json");
     return false;
   }
   serializeJsonPretty(doc, f);
@@ -152,7 +545,7 @@ bool loadSystemConfig() {
     return false;
 
   if (!SD.exists(SYSTEM_CONFIG_PATH)) {
-    Serial.println(F("system.json missing; using defaults"));
+    LOG_WARN("system.json missing; using defaults");
     Settings_loadDefaults();
     loggingActive = Settings_get().loggingEnabled;
     Display_setLoggingEnabled(loggingActive);
@@ -161,7 +554,7 @@ bool loadSystemConfig() {
 
   File f = SD.open(SYSTEM_CONFIG_PATH, FILE_READ);
   if (!f) {
-    Serial.println(F("Failed to open system.json; using defaults"));
+    LOG_ERROR("Failed to open system.json; using defaults");
     Settings_loadDefaults();
     loggingActive = Settings_get().loggingEnabled;
     Display_setLoggingEnabled(loggingActive);
@@ -172,8 +565,7 @@ bool loadSystemConfig() {
   DeserializationError err = deserializeJson(doc, f);
   f.close();
   if (err) {
-    Serial.print(F("system.json parse error: "));
-    Serial.println(err.c_str());
+    LOG_ERROR("system.json parse error: %s", err.c_str());
     Settings_loadDefaults();
     loggingActive = Settings_get().loggingEnabled;
     Display_setLoggingEnabled(loggingActive);
@@ -192,6 +584,25 @@ bool loadSystemConfig() {
     const char *lvl = logging["level"] | Settings_loggingLevelToString(
                                              (LoggingLevel)s.loggingLevel);
     s.loggingLevel = Settings_parseLoggingLevel(String(lvl));
+    s.sensorTrace = logging["sensor_trace"] | s.sensorTrace;
+    s.logFlushMs =
+        Settings_clampLogFlushMs(logging["flush_ms"] | (uint32_t)s.logFlushMs);
+    s.logFlushBytes =
+        Settings_clampLogFlushBytes(logging["flush_bytes"] | s.logFlushBytes);
+    const char *format = logging["format"] | Settings_logFormatToString(
+                                                 (LogFormat)s.logFormat);
+    s.logFormat = Settings_parseLogFormat(String(format));
+    s.logPreallocKb = Settings_clampLogPreallocKb(
+        logging["prealloc_kb"] | (uint32_t)s.logPreallocKb);
+  }
+
+  JsonVariant dictionary = doc["dictionary"];
+  if (!dictionary.isNull()) {
+    const char *match = dictionary["match"] | Settings_matchPolicyToString(
+                                                  (MatchPolicy)s.matchPolicy);
+    s.matchPolicy = Settings_parseMatchPolicy(String(match));
+    s.minWordLength = Settings_clampMinWordLength(
+        dictionary["min_length"] | (uint32_t)s.minWordLength);
   }
 
   JsonVariant ui = doc["ui"];
@@ -214,25 +625,37 @@ bool loadSystemConfig() {
   return true;
 }
 
-void logEvent(const String &line) {
+void logEvent(LoggingLevel level, const char *fmt, ...) {
   if (!sdAvailable)
     return;
   if (!Settings_get().loggingEnabled)
     return;
-  if (!levelAllows(LOG_LEVEL_INFO))
+  if (!levelAllows(level))
+    return;
+  if (!startLogTask())
     return;
 
+  EventRecord e;
+  stampRecord(e.ms, e.unixTime);
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(e.text, sizeof(e.text), fmt, args);
+  va_end(args);
+  eventStats.events++;
+  if (!eventQueue.push(e))
+    eventStats.dropped++;
+}
+
+void saveLoopProfile() {
+  if (!sdAvailable || !Settings_get().loggingEnabled)
+    return;
   ensureDir(LOGS_DIR);
-  File f = SD.open(EVENT_LOG_PATH, FILE_WRITE);
+  File f = SD.open(LOOP_PROFILE_PATH, FILE_WRITE);
   if (!f) {
-    Serial.println(F("Failed to open event log"));
+    LOG_ERROR("Failed to open loop profile");
     return;
   }
-  f.seek(f.size());
-  String ts = formatTimestamp();
-  f.print(ts);
-  f.print(" ");
-  f.println(line);
+  Profiler_writeCsv(f);
   f.close();
   Display_notifySdActivity();
 }
@@ -240,43 +663,162 @@ void logEvent(const String &line) {
 void startSessionLog() {
   if (!sdAvailable)
     return;
+  endSessionLog();
   loggingActive = Settings_get().loggingEnabled;
-  if (sessionFile) {
-    sessionFile.close();
-  }
   if (!loggingActive)
     return;
 
+  if (!startLogTask())
+    return;
+
   ensureDir(SESSIONS_DIR);
+  trimUnclosedSession();
 
-  currentSessionPath = sessionFilename();
-  sessionFile = SD.open(currentSessionPath.c_str(), FILE_WRITE);
-  if (!sessionFile) {
-    Serial.println(F("Failed to open session log"));
+  const DeviceSettings &s = Settings_get();
+  sessionBinary = s.logFormat == LOG_FORMAT_BINARY;
+  currentSessionPath = sessionFilename(sessionBinary);
+  File f = SD.open(currentSessionPath.c_str(), FILE_WRITE);
+  if (!f) {
+    LOG_ERROR("Failed to open session log");
     return;
   }
-  sessionFile.println(F("timestamp,source,type,value,extra"));
-  sessionFile.flush();
+  // logTask leaves the session alone until sessionOpen is set; stage the
+  // header for its first block.
+  openStream(sessionStream, f, Settings_clampLogFlushBytes(s.logFlushBytes),
+             s.logFlushMs);
+  sessionStream.writes = sessionStream.bytes = sessionStream.maxWriteUs = 0;
+  memset(sessionStream.writeHist, 0, sizeof(sessionStream.writeHist));
+  sessionPreallocBytes = (uint32_t)s.logPreallocKb * 1024;
+  sessionReserveEnd = sessionFilled = 0;
+  if (sessionPreallocBytes) {
+    // Without the marker a power cut would leave the zeros in place.
+    File marker = SD.open(SESSION_OPEN_PATH, FILE_WRITE);
+    sessionMarked = (bool)marker;
+    if (marker) {
+      marker.println(currentSessionPath);
+      marker.close();
+    } else {
+      sessionPreallocBytes = 0;
+    }
+  }
+  sessionStats = SessionLogStats();
+  sessionQueue.clear();
+  // SESSION_DICTS_MAX covers every built-in, "All" and SD list.
+  sessionDicts.count = Dictionary_getCount();
+  for (uint8_t i = 0; i < sessionDicts.count; i++)
+    sessionDicts.names[i] = Dictionary_getNameForIndex(i);
+  if (sessionBinary) {
+    uint8_t header[SESSION_BIN_HEADER_MAX];
+    SessionLog_resetBinary(sessionBin);
+    stageBytes(sessionStream, header,
+               SessionLog_encodeBinaryHeader(header, sessionDicts));
+  } else {
+    const char *header = SessionLog_csvHeader();
+    stageBytes(sessionStream, (const uint8_t *)header, strlen(header));
+  }
+  sessionOpen.store(true, std::memory_order_release);
   Display_setLoggingEnabled(loggingActive);
 }
 
-void logSessionLine(const String &line) {
-  if (!sdAvailable || !loggingActive)
+void logSessionLetter(char letter, float tempC, float humidity) {
+  if (!sessionLogging())
     return;
-  if (!sessionFile)
+  SessionRecord r;
+  r.type = SESSION_LETTER;
+  r.letter.letter = letter;
+  r.letter.tempC = tempC;
+  r.letter.humidity = humidity;
+  queueSessionRecord(r);
+}
+
+void logSessionWord(const DictHit &hit) {
+  if (!sessionLogging())
     return;
+  SessionRecord r;
+  r.type = SESSION_WORD;
+  memcpy(r.word.word, hit.word, sizeof(r.word.word));
+  r.word.id = hit.id;
+  r.word.tags = hit.tags;
+  r.word.dict = Dictionary_getActiveIndex();
+  queueSessionRecord(r);
+}
 
-  String ts = formatTimestamp();
-  sessionFile.print(ts);
-  sessionFile.print(",");
-  sessionFile.println(line);
-  sessionFile.flush();
-  Display_notifySdActivity();
+void logSessionTiming(const SensorTimingStats &stats) {
+  if (!sessionLogging())
+    return;
+  SessionRecord r;
+  r.type = SESSION_TIMING;
+  r.timing = stats;
+  queueSessionRecord(r);
+}
+
+void logSessionLine(const String &line) {
+  if (!sessionLogging())
+    return;
+  SessionRecord r;
+  r.type = SESSION_TEXT;
+  snprintf(r.text, sizeof(r.text), "%s", line.c_str());
+  queueSessionRecord(r);
 }
 
 void endSessionLog() {
-  if (sessionFile) {
-    sessionFile.close();
+  if (!sessionOpen.load(std::memory_order_acquire))
+    return;
+  // The writer drains the queue, writes the last block and closes the file.
+  sessionCloseRequested.store(true, std::memory_order_release);
+  while (sessionOpen.load(std::memory_order_acquire))
+    vTaskDelay(1);
+}
+
+void getSessionLogStats(SessionLogStats &out) {
+  out = sessionStats;
+  out.writes = sessionStream.writes;
+  out.bytes = sessionStream.bytes;
+  out.maxWriteUs = sessionStream.maxWriteUs;
+  memcpy(out.writeHist, sessionStream.writeHist, sizeof(out.writeHist));
+}
+
+void getEventLogStats(EventLogStats &out) {
+  out = eventStats;
+  out.dropped += eventWriteDropped;
+  out.writes = eventStream.writes;
+  out.bytes = eventStream.bytes;
+}
+
+bool startSensorTrace() {
+  if (!sdAvailable)
+    return false;
+  if (traceFile)
+    traceFile.close();
+
+  ensureDir(TRACES_DIR);
+  String path = traceFilename();
+  traceFile = SD.open(path.c_str(), FILE_WRITE);
+  if (!traceFile) {
+    LOG_ERROR("Failed to open sensor trace");
+    return false;
   }
+  LOG_INFO("Recording sensor trace: %s", path.c_str());
+  lastTraceFlushMs = millis();
+  return true;
+}
+
+void appendSensorTrace(const uint8_t *data, size_t len) {
+  if (!traceFile || len == 0)
+    return;
+  traceFile.write(data, len);
+  // The file buffers whole sectors; flush about once a second so a power cut
+  // loses little, without a card write per loop.
+  unsigned long now = millis();
+  if (now - lastTraceFlushMs >= TRACE_FLUSH_MS) {
+    traceFile.flush();
+    lastTraceFlushMs = now;
+    Display_notifySdActivity();
+  }
+}
+
+void endSensorTrace() {
+  if (traceFile)
+    traceFile.close();
 }
 } // namespace SDManager
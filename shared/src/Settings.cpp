@@ -1,4 +1,5 @@
 #include "Settings.h"
+#include "config_core.h"
 #include <math.h>
 
 static DeviceSettings settings;
@@ -46,6 +47,13 @@ void Settings_loadDefaults() {
   settings.heartbeatBpm = 120; // base heartbeat speed
   settings.loggingEnabled = true;
   settings.loggingLevel = LOG_LEVEL_INFO;
+  settings.sensorTrace = false;
+  settings.logFlushMs = 2000;
+  settings.logFlushBytes = 4096;
+  settings.logFormat = LOG_FORMAT_CSV;
+  settings.logPreallocKb = 0;
+  settings.matchPolicy = MATCH_POLICY_LONGEST;
+  settings.minWordLength = 1;
 
   settings.ui.topLeft.type = ComplicationType::TemperatureC;
   settings.ui.topLeft.label = "T";
@@ -86,6 +94,37 @@ uint16_t Settings_clampHeartbeat(uint16_t bpm, uint16_t minBpm,
   return bpm;
 }
 
+uint16_t Settings_clampLogFlushBytes(uint32_t bytes) {
+  const uint32_t sector = 512;
+  if (bytes < sector)
+    return sector;
+  if (bytes > 8 * sector)
+    return 8 * sector;
+  return (uint16_t)(bytes / sector * sector);
+}
+
+uint16_t Settings_clampLogFlushMs(uint32_t ms) {
+  if (ms < 100)
+    return 100;
+  if (ms > 60000)
+    return 60000;
+  return (uint16_t)ms;
+}
+
+uint16_t Settings_clampLogPreallocKb(uint32_t kb) {
+  if (kb > 4096)
+    return 4096;
+  return (uint16_t)kb;
+}
+
+uint8_t Settings_clampMinWordLength(uint32_t len) {
+  if (len < 1)
+    return 1;
+  if (len > (uint32_t)LETTER_BUFFER_SIZE)
+    return (uint8_t)LETTER_BUFFER_SIZE;
+  return (uint8_t)len;
+}
+
 LoggingLevel Settings_parseLoggingLevel(const String &s) {
   if (s.equalsIgnoreCase("debug"))
     return LOG_LEVEL_DEBUG;
@@ -110,6 +149,40 @@ const char *Settings_loggingLevelToString(LoggingLevel level) {
   return "info";
 }
 
+LogFormat Settings_parseLogFormat(const String &s) {
+  if (s.equalsIgnoreCase("binary"))
+    return LOG_FORMAT_BINARY;
+  return LOG_FORMAT_CSV;
+}
+
+const char *Settings_logFormatToString(LogFormat format) {
+  return format == LOG_FORMAT_BINARY ? "binary" : "csv";
+}
+
+MatchPolicy Settings_parseMatchPolicy(const String &s) {
+  if (s.equalsIgnoreCase("shortest"))
+    return MATCH_POLICY_SHORTEST;
+  if (s.equalsIgnoreCase("first"))
+    return MATCH_POLICY_FIRST;
+  if (s.equalsIgnoreCase("all"))
+    return MATCH_POLICY_ALL;
+  return MATCH_POLICY_LONGEST;
+}
+
+const char *Settings_matchPolicyToString(MatchPolicy policy) {
+  switch (policy) {
+  case MATCH_POLICY_LONGEST:
+    return "longest";
+  case MATCH_POLICY_SHORTEST:
+    return "shortest";
+  case MATCH_POLICY_FIRST:
+    return "first";
+  case MATCH_POLICY_ALL:
+    return "all";
+  }
+  return "longest";
+}
+
 static uint8_t nearestVarianceIndex(float v) {
   uint8_t bestIdx = 0;
   float bestDiff = fabsf(VARIANCE_STEPS[0] - v);
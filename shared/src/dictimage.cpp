@@ -0,0 +1,101 @@
+#include "DictImage.h"
+#include <string.h>
+
+static_assert(sizeof(DictNode) == 16, "DictNode layout is part of the image");
+static_assert(sizeof(DictImageHeader) == 60,
+              "DictImageHeader layout is part of the image");
+
+// Nibble-wise CRC-32 (IEEE): a 64-byte table instead of 1 KB of flash.
+static const uint32_t CRC32_NIBBLE[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL};
+
+uint32_t DictImage_crc32(const uint8_t *data, size_t len, uint32_t crc) {
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ CRC32_NIBBLE[crc & 0x0F];
+    crc = (crc >> 4) ^ CRC32_NIBBLE[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+static bool sectionFits(uint32_t offset, uint64_t bytes, uint32_t imageSize) {
+  return (offset & 3) == 0 && offset <= imageSize &&
+         bytes <= (uint64_t)(imageSize - offset);
+}
+
+static bool indicesValid(const DictImageHeader *h, const DictNode *nodes,
+                         const uint32_t *wordOffsets) {
+  const uint32_t count = h->nodeCount;
+  if (nodes[DICT_ROOT_STATE].depth != 0)
+    return false;
+  for (uint32_t i = 0; i < count; i++) {
+    const DictNode &n = nodes[i];
+    if ((uint64_t)n.firstChild + n.childCount > count || n.fail >= count ||
+        n.output >= count || n.depth > h->maxWordLength ||
+        (n.word != DICT_NODE_NONE && n.word >= h->wordCount))
+      return false;
+    if (i != DICT_ROOT_STATE &&
+        (nodes[n.fail].depth >= n.depth || nodes[n.output].depth >= n.depth))
+      return false;
+    for (uint32_t k = 0; k < n.childCount; k++) {
+      if (nodes[n.firstChild + k].depth != n.depth + 1)
+        return false;
+    }
+  }
+  for (uint32_t i = 0; i < h->wordCount; i++) {
+    if (wordOffsets[i] >= h->charsSize)
+      return false; // chars ends in a NUL, so every word is terminated
+  }
+  return true;
+}
+
+bool DictImage_open(const void *data, size_t size, DictImageView &out,
+                    bool checkCrc) {
+  if (!data || ((uintptr_t)data & 3) != 0 || size < sizeof(DictImageHeader))
+    return false;
+
+  const uint8_t *base = (const uint8_t *)data;
+  const DictImageHeader *h = (const DictImageHeader *)data;
+  if (h->magic != DICT_IMAGE_MAGIC || h->version != DICT_IMAGE_VERSION ||
+      h->headerSize != sizeof(DictImageHeader))
+    return false;
+  if (h->imageSize > size || h->imageSize < h->headerSize)
+    return false;
+  if (h->nodeCount == 0 || h->wordCount == 0 || h->charsSize == 0)
+    return false;
+  if (h->name[DICT_IMAGE_NAME_LEN - 1] != '\0')
+    return false;
+
+  if (!sectionFits(h->nodesOffset, (uint64_t)h->nodeCount * sizeof(DictNode),
+                   h->imageSize) ||
+      !sectionFits(h->wordOffsetsOffset,
+                   (uint64_t)h->wordCount * sizeof(uint32_t), h->imageSize) ||
+      !sectionFits(h->charsOffset, h->charsSize, h->imageSize))
+    return false;
+
+  if (checkCrc && DictImage_crc32(base + h->headerSize,
+                                  h->imageSize - h->headerSize) != h->checksum)
+    return false;
+  if (base[h->charsOffset + h->charsSize - 1] != '\0')
+    return false; // last word must be terminated
+
+  const DictNode *nodes = (const DictNode *)(base + h->nodesOffset);
+  const uint32_t *wordOffsets = (const uint32_t *)(base + h->wordOffsetsOffset);
+  if (!indicesValid(h, nodes, wordOffsets))
+    return false;
+
+  out.matcher.nodes = nodes;
+  out.matcher.nodeCount = h->nodeCount;
+  out.matcher.wordOffsets = wordOffsets;
+  out.matcher.wordCount = h->wordCount;
+  out.matcher.chars = (const char *)(base + h->charsOffset);
+  out.maxWordLength = h->maxWordLength;
+  out.name = h->name;
+  out.imageSize = h->imageSize;
+  out.checksum = h->checksum;
+  return true;
+}
@@ -1,23 +1,78 @@
 #include "Dictionary.h"
+#include "DictImage.h"
+#include "DictMatcher.h"
+#include "Log.h"
+#include "SdDictionary.h"
 #include "Settings.h"
+#include "SpscRing.h"
 #include "config_core.h"
 #include <FS.h>
 #include <SPIFFS.h>
-#include <vector>
-
-static std::vector<String> dictionary;
-static char letterBuffer[LETTER_BUFFER_SIZE];
-static int letterCount = 0;
+#include <esp_heap_caps.h>
+#include <esp_partition.h>
+
+#ifdef GHOST_EMBEDDED_DICTS
+// Generated at build time by tools/gen_embedded_dicts.py from data/.
+#include "EmbeddedDicts.h"
+#endif
+
+// Words are compiled into an Aho-Corasick automaton; letterWindow is only kept
+// so the automaton can be re-seeded with the last letters after a hit.
+// Lists from the board's data/ folder are embedded in flash at build time and
+// selected with no load step at all. Precompiled images (tools/host/dictc) are
+// used in place, either from the memory-mapped "dicts" partition or from one
+// SPIFFS read into a single buffer; text lists are parsed into
+// dictionaryBuilder as a fallback. The "All" entry merges every built-in
+// list into combinedBuilder with one tag bit per list, so a single pass
+// reports which lists a hit belongs to. Suffix-sorted lists in the SD card's
+// /dictionary folder follow it and are streamed instead.
+static DictMatcherBuilder dictionaryBuilder;
+static DictMatcherBuilder combinedBuilder;
+static DictMatcher dictionary = {nullptr, 0, nullptr, 0, nullptr};
+static uint8_t *dictionaryImageBuffer = nullptr;
+static bool dictPartitionProbed = false;
+static uint32_t matchState = DICT_ROOT_STATE;
+static SpscRing<char, LETTER_BUFFER_SIZE> letterWindow;
 static uint8_t activeDictIndex = 0;
 static bool spiffsMounted = false;
+static bool sdDictActive = false;
+static uint8_t lastHitTags = 0;
+static DictOutput candidates[DICT_MAX_CANDIDATES];
+static uint8_t candidateCount = 0;
+static uint8_t hitCandidate = 0; // the one checkForWord() reported
+static char windowCopy[LETTER_BUFFER_SIZE];
+static int windowLength = 0;
 
 static const char *const DICT_FILES[] = {"/words.txt", "/paranormal.txt",
                                          "/short.txt"};
 
+static const char *const DICT_IMAGE_FILES[] = {
+    "/words.dict", "/paranormal.dict", "/short.dict"};
+
 static const char *const DICT_NAMES[] = {"Default", "Paranormal", "Short"};
 
-static const size_t DICT_FILE_COUNT =
-    sizeof(DICT_FILES) / sizeof(DICT_FILES[0]);
+static const char *DICT_PARTITION_LABEL = "dicts";
+
+static_assert(sizeof(DICT_FILES) / sizeof(DICT_FILES[0]) == DICT_FILE_COUNT,
+              "DICT_FILE_COUNT in config_core.h");
+
+// Images are fully validated (CRC included) once: partition images when the
+// partition is first mapped, SPIFFS images the first time each file is read.
+// Switching back to a list then reuses the partition view, or re-reads the
+// file and only repeats the index checks if its size and checksum match.
+static DictImageView partitionImages[DICT_FILE_COUNT];
+static bool partitionHasImage[DICT_FILE_COUNT] = {};
+
+struct VerifiedImage {
+  uint32_t size; // 0 until the file has passed the CRC
+  uint32_t checksum;
+};
+static VerifiedImage verifiedImages[DICT_FILE_COUNT] = {};
+
+// Index of the merged list, right after the built-in ones.
+static const uint8_t DICT_ALL_INDEX = DICT_FILE_COUNT;
+static const char *DICT_ALL_NAME = "All";
+static_assert(DICT_FILE_COUNT <= DICT_MAX_TAGS, "one tag bit per list");
 
 // small fallback dict
 static const char *FALLBACK_DICT[] = {
@@ -27,36 +82,226 @@ static const char *FALLBACK_DICT[] = {
 static const int FALLBACK_DICT_SIZE =
     sizeof(FALLBACK_DICT) / sizeof(FALLBACK_DICT[0]);
 
+static void releaseDictionary() {
+  dictionaryBuilder.clear();
+  if (dictionaryImageBuffer) {
+    free(dictionaryImageBuffer);
+    dictionaryImageBuffer = nullptr;
+  }
+  dictionary = {nullptr, 0, nullptr, 0, nullptr};
+  matchState = DICT_ROOT_STATE;
+}
+
+// DictMatcherBuilder aborts if an allocation fails, which would reboot-loop
+// on an edited list too big for the heap. Builds are checked up front
+// instead, and a list that does not fit is skipped so the caller falls back.
+static bool builderFits(size_t chars) {
+  return heap_caps_get_free_size(MALLOC_CAP_8BIT) >=
+             DictMatcherBuilder::peakBytes(chars) &&
+         heap_caps_get_largest_free_block(MALLOC_CAP_8BIT) >=
+             DictMatcherBuilder::largestBlock(chars);
+}
+
 static void loadFallbackDictionary() {
-  dictionary.clear();
-  dictionary.reserve(FALLBACK_DICT_SIZE);
+  releaseDictionary();
   for (int i = 0; i < FALLBACK_DICT_SIZE; i++) {
-    dictionary.push_back(String(FALLBACK_DICT[i]));
+    dictionaryBuilder.addWord(FALLBACK_DICT[i], strlen(FALLBACK_DICT[i]));
+  }
+  dictionary = dictionaryBuilder.build();
+  LOG_INFO("Loaded fallback dictionary, size=%lu",
+           (unsigned long)dictionary.wordCount);
+}
+
+static bool loadEmbeddedDictionary(const char *path) {
+#ifdef GHOST_EMBEDDED_DICTS
+  for (size_t i = 0; i < EmbeddedDicts::COUNT; i++) {
+    const EmbeddedDicts::Entry &entry = EmbeddedDicts::ENTRIES[i];
+    if (strcmp(entry.path, path) != 0 || DictMatcher_empty(entry.matcher))
+      continue;
+    releaseDictionary();
+    dictionary = entry.matcher;
+    LOG_INFO("Using embedded dictionary %s, size=%lu", path,
+             (unsigned long)dictionary.wordCount);
+    return true;
+  }
+#else
+  (void)path;
+#endif
+  return false;
+}
+
+// Whether the SPIFFS text list at `path` differs from the data/ file its
+// embedded table was generated from, i.e. it was edited after the build.
+// Checked once per list and boot.
+static bool spiffsListEdited(const char *path) {
+#ifdef GHOST_EMBEDDED_DICTS
+  static int8_t edited[EmbeddedDicts::COUNT] = {};
+  if (!spiffsMounted)
+    return false;
+  for (size_t i = 0; i < EmbeddedDicts::COUNT; i++) {
+    const EmbeddedDicts::Entry &entry = EmbeddedDicts::ENTRIES[i];
+    if (strcmp(entry.path, path) != 0)
+      continue;
+    if (edited[i] == 0) {
+      File file = SPIFFS.exists(path) ? SPIFFS.open(path, "r") : File();
+      bool differs = false;
+      if (file && file.size() != entry.sourceSize) {
+        differs = true;
+      } else if (file) {
+        uint32_t hash = 0x811C9DC5UL; // FNV-1a, as gen_embedded_dicts.py
+        uint8_t buf[256];
+        size_t n;
+        while ((n = file.read(buf, sizeof(buf))) > 0) {
+          for (size_t k = 0; k < n; k++)
+            hash = (hash ^ buf[k]) * 0x01000193UL;
+        }
+        differs = hash != entry.sourceHash;
+      }
+      if (file)
+        file.close();
+      edited[i] = differs ? 1 : -1;
+      if (differs)
+        LOG_WARN("SPIFFS %s differs from the embedded copy; using SPIFFS",
+                 path);
+    }
+    return edited[i] > 0;
   }
-  Serial.print("Loaded fallback dictionary, size=");
-  Serial.println(dictionary.size());
+#else
+  (void)path;
+#endif
+  return false;
+}
+
+// Image names are the source file stem, e.g. "words" for /words.txt.
+static bool imageNameMatches(const char *imageName, const char *path) {
+  if (*path == '/')
+    path++;
+  size_t len = strcspn(path, ".");
+  return strlen(imageName) == len && strncmp(imageName, path, len) == 0;
+}
+
+// Matching states are as deep as their word; the letter window bounds that.
+static bool imageFitsWindow(const DictImageView &view) {
+  return view.maxWordLength <= LETTER_BUFFER_SIZE;
+}
+
+static void logImageLoaded(const DictImageView &view, const char *source,
+                           unsigned long startMs) {
+  LOG_INFO("Loaded dictionary image '%.*s' from %s: %lu words in %lu ms",
+           (int)sizeof(view.name), view.name, source,
+           (unsigned long)dictionary.wordCount, millis() - startMs);
+}
+
+// The partition holds dictc images back to back (dictc -p). It is mapped for
+// the lifetime of the firmware and never unmapped; each built-in list keeps
+// the first valid image with its name.
+static void probeDictionaryPartition() {
+  if (dictPartitionProbed)
+    return;
+  dictPartitionProbed = true;
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, DICT_PARTITION_LABEL);
+  const void *ptr = nullptr;
+  spi_flash_mmap_handle_t handle;
+  if (!part || esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA,
+                                  &ptr, &handle) != ESP_OK)
+    return;
+
+  const uint8_t *base = (const uint8_t *)ptr;
+  size_t size = part->size;
+  size_t offset = 0;
+  DictImageView view;
+  while (offset + sizeof(DictImageHeader) <= size &&
+         DictImage_open(base + offset, size - offset, view)) {
+    for (uint8_t i = 0; i < DICT_FILE_COUNT; i++) {
+      if (!partitionHasImage[i] && imageFitsWindow(view) &&
+          imageNameMatches(view.name, DICT_FILES[i])) {
+        partitionImages[i] = view;
+        partitionHasImage[i] = true;
+      }
+    }
+    offset += view.imageSize;
+  }
+}
+
+static bool loadDictionaryFromPartition(uint8_t idx) {
+  unsigned long startMs = millis();
+  probeDictionaryPartition();
+  if (!partitionHasImage[idx])
+    return false;
+  releaseDictionary();
+  dictionary = partitionImages[idx].matcher;
+  logImageLoaded(partitionImages[idx], DICT_PARTITION_LABEL, startMs);
+  return true;
+}
+
+static bool loadDictionaryImageFromSPIFFS(uint8_t idx) {
+  unsigned long startMs = millis();
+  const char *path = DICT_IMAGE_FILES[idx];
+  if (!SPIFFS.exists(path))
+    return false;
+  File file = SPIFFS.open(path, "r");
+  if (!file)
+    return false;
+
+  releaseDictionary();
+  size_t size = file.size();
+  dictionaryImageBuffer = (uint8_t *)malloc(size);
+  if (!dictionaryImageBuffer) {
+    file.close();
+    LOG_ERROR("No memory for dictionary image: %s", path);
+    return false;
+  }
+  size_t got = file.read(dictionaryImageBuffer, size);
+  file.close();
+
+  VerifiedImage &verified = verifiedImages[idx];
+  const DictImageHeader *h = (const DictImageHeader *)dictionaryImageBuffer;
+  bool checkCrc = size < sizeof(DictImageHeader) || verified.size != size ||
+                  verified.checksum != h->checksum;
+  DictImageView view;
+  if (got != size ||
+      !DictImage_open(dictionaryImageBuffer, size, view, checkCrc) ||
+      !imageFitsWindow(view)) {
+    LOG_ERROR("Invalid dictionary image: %s", path);
+    verified.size = 0;
+    releaseDictionary();
+    return false;
+  }
+  verified.size = (uint32_t)size;
+  verified.checksum = view.checksum;
+  dictionary = view.matcher;
+  logImageLoaded(view, path, startMs);
+  return true;
 }
 
 static bool loadDictionaryFromSPIFFS(const char *path) {
-  dictionary.clear();
-  dictionary.reserve(
-      512); // reduce reallocations/fragmentation for moderate dictionaries
+  releaseDictionary();
 
   if (!SPIFFS.exists(path)) {
-    Serial.print("Dictionary file not found: ");
-    Serial.println(path);
+    LOG_WARN("Dictionary file not found: %s", path);
     return false;
   }
 
   File file = SPIFFS.open(path, "r");
   if (!file) {
-    Serial.print("Failed to open dictionary file: ");
-    Serial.println(path);
+    LOG_ERROR("Failed to open dictionary file: %s", path);
     return false;
   }
 
-  Serial.print("Loading dictionary from ");
-  Serial.println(path);
+  size_t chars = file.size() + 1; // the last line may lack a newline
+  if (!builderFits(chars)) {
+    LOG_ERROR("Not enough heap to load %s (%lu bytes); use dictc -s for the "
+              "SD card",
+              path, (unsigned long)file.size());
+    file.close();
+    return false;
+  }
+
+  LOG_INFO("Loading dictionary from %s", path);
+
+  // reduce reallocations/fragmentation for moderate dictionaries
+  dictionaryBuilder.reserve(512, chars);
 
   while (file.available()) {
     String line = file.readStringUntil('\n');
@@ -66,30 +311,93 @@ static bool loadDictionaryFromSPIFFS(const char *path) {
     line.toUpperCase();
     if (line.length() > LETTER_BUFFER_SIZE)
       continue;
-    dictionary.push_back(line);
+    dictionaryBuilder.addWord(line.c_str(), line.length());
   }
   file.close();
+  dictionary = dictionaryBuilder.build();
+
+  LOG_INFO("Loaded %lu words (%lu states) from SPIFFS.",
+           (unsigned long)dictionary.wordCount,
+           (unsigned long)dictionary.nodeCount);
+
+  return !DictMatcher_empty(dictionary);
+}
+
+static bool loadBuiltinDictionary(uint8_t idx) {
+  // An edited SPIFFS list wins over the copies built from data/: the
+  // embedded table, the partition image and a SPIFFS image.
+  if (spiffsListEdited(DICT_FILES[idx]) &&
+      loadDictionaryFromSPIFFS(DICT_FILES[idx]))
+    return true;
+  if (loadEmbeddedDictionary(DICT_FILES[idx]) ||
+      loadDictionaryFromPartition(idx))
+    return true;
+  if (!spiffsMounted)
+    return false;
+  return loadDictionaryImageFromSPIFFS(idx) ||
+         loadDictionaryFromSPIFFS(DICT_FILES[idx]);
+}
 
-  Serial.print("Loaded ");
-  Serial.print(dictionary.size());
-  Serial.println(" words from SPIFFS.");
+// Load each built-in list in turn and fold its words into combinedBuilder;
+// shared prefixes and words present in several lists are stored once.
+static bool loadCombinedDictionary() {
+  unsigned long startMs = millis();
+  combinedBuilder.clear();
+  size_t words = 0, chars = 0;
+  for (uint8_t i = 0; i < DICT_FILE_COUNT; i++) {
+    if (!loadBuiltinDictionary(i))
+      continue;
+    size_t listChars = 0;
+    for (uint32_t id = 0; id < dictionary.wordCount; id++)
+      listChars += strlen(DictMatcher_word(dictionary, id)) + 1;
+    if (!builderFits(chars + listChars)) {
+      LOG_ERROR("Not enough heap to add %s to the combined dictionary",
+                DICT_NAMES[i]);
+      continue;
+    }
+    words += dictionary.wordCount;
+    chars += listChars;
+    combinedBuilder.reserve(words, chars);
+    for (uint32_t id = 0; id < dictionary.wordCount; id++) {
+      const char *word = DictMatcher_word(dictionary, id);
+      combinedBuilder.addWord(word, strlen(word), (uint8_t)(1 << i));
+    }
+  }
+  releaseDictionary();
+  dictionary = combinedBuilder.build();
 
-  return !dictionary.empty();
+  LOG_INFO("Combined dictionary: %lu words, %lu bytes in %lu ms",
+           (unsigned long)dictionary.wordCount,
+           (unsigned long)combinedBuilder.memoryBytes(), millis() - startMs);
+  return !DictMatcher_empty(dictionary);
+}
+
+static bool loadSdDictionary(uint8_t sdIdx) {
+  releaseDictionary();
+  sdDictActive = SdDictionary_open(sdIdx);
+  return sdDictActive;
 }
 
 bool Dictionary_setActiveIndex(uint8_t idx) {
-  if (DICT_FILE_COUNT == 0)
+  uint8_t total = Dictionary_getCount();
+  if (total == 0)
     return false;
-  uint8_t clamped = Settings_clampDictionaryIndex(idx, DICT_FILE_COUNT - 1);
+  uint8_t clamped = Settings_clampDictionaryIndex(idx, total - 1);
   activeDictIndex = clamped;
   Settings_get().dictionaryIndex = clamped;
   bool loaded = false;
 
-  if (spiffsMounted) {
-    loaded = loadDictionaryFromSPIFFS(DICT_FILES[clamped]);
-  }
+  SdDictionary_close();
+  sdDictActive = false;
+  combinedBuilder.clear();
+  if (clamped < DICT_FILE_COUNT)
+    loaded = loadBuiltinDictionary(clamped);
+  else if (clamped == DICT_ALL_INDEX)
+    loaded = loadCombinedDictionary();
+  else
+    loaded = loadSdDictionary(clamped - DICT_ALL_INDEX - 1);
   if (!loaded) {
-    Serial.println("Using fallback dictionary.");
+    LOG_WARN("Using fallback dictionary.");
     loadFallbackDictionary();
   }
 
@@ -98,95 +406,201 @@ bool Dictionary_setActiveIndex(uint8_t idx) {
 }
 
 void Dictionary_begin() {
-  letterCount = 0;
+  letterWindow.clear();
+  SdDictionary_scan();
   activeDictIndex = Settings_clampDictionaryIndex(
-      Settings_get().dictionaryIndex, DICT_FILE_COUNT - 1);
+      Settings_get().dictionaryIndex, Dictionary_getCount() - 1);
 
   spiffsMounted = SPIFFS.begin(false);
   if (!spiffsMounted) {
-    Serial.println(
-        "SPIFFS mount failed (no auto-format). Using fallback dictionary.");
-    loadFallbackDictionary();
+    LOG_ERROR("SPIFFS mount failed (no auto-format).");
+    // Embedded tables and partition images do not need SPIFFS.
+    if (Dictionary_setActiveIndex(activeDictIndex))
+      return;
     Settings_get().dictionaryIndex = 0;
     activeDictIndex = 0;
     return;
   }
 
-  Serial.println("SPIFFS mounted.");
-  // List files (debug)
-  File root = SPIFFS.open("/");
-  File f = root.openNextFile();
-  while (f) {
-    Serial.print("FILE: ");
-    Serial.println(f.name());
-    f = root.openNextFile();
+  LOG_INFO("SPIFFS mounted.");
+  if (LOG_ENABLED(LOG_LEVEL_DEBUG)) {
+    File root = SPIFFS.open("/");
+    for (File f = root.openNextFile(); f; f = root.openNextFile())
+      LOG_DEBUG("FILE: %s", f.name());
   }
 
   if (!Dictionary_setActiveIndex(activeDictIndex)) {
-    Serial.println("Failed to load requested dictionary, using fallback.");
+    LOG_WARN("Failed to load requested dictionary, using fallback.");
   }
 }
 
 void Dictionary_appendLetter(char l) {
-  if (letterCount < LETTER_BUFFER_SIZE) {
-    letterBuffer[letterCount++] = l;
-  } else {
-    memmove(letterBuffer, letterBuffer + 1, LETTER_BUFFER_SIZE - 1);
-    letterBuffer[LETTER_BUFFER_SIZE - 1] = l;
+  if (letterWindow.full())
+    letterWindow.drop(1);
+  letterWindow.push(l);
+  if (!sdDictActive)
+    matchState = DictMatcher_step(dictionary, matchState, l);
+}
+
+// Every word (>= minLength) ending on the current letter, longest first.
+// The automaton walks its output links; SD dictionaries probe each length.
+static void collectCandidates(uint8_t minLength) {
+  candidateCount = 0;
+  if (sdDictActive) {
+    uint8_t lengths[LETTER_BUFFER_SIZE];
+    uint8_t n = SdDictionary_suffixLengths(windowCopy, windowLength, lengths,
+                                           LETTER_BUFFER_SIZE);
+    while (n > 0 && lengths[n - 1] >= minLength) {
+      DictOutput &c = candidates[candidateCount++];
+      c.word = DICT_NO_WORD;
+      c.length = lengths[--n];
+      c.tags = 0;
+    }
+    return;
+  }
+  uint32_t n = DictMatcher_outputs(dictionary, matchState, candidates,
+                                   DICT_MAX_CANDIDATES);
+  while (n > 0 && candidates[n - 1].length < minLength)
+    n--;
+  candidateCount = (uint8_t)n;
+}
+
+static uint8_t selectCandidate(MatchPolicy policy) {
+  switch (policy) {
+  case MATCH_POLICY_SHORTEST:
+    return candidateCount - 1;
+  case MATCH_POLICY_FIRST: {
+    // Lowest word id = earliest in the list; SD lists are length-sorted.
+    uint8_t best = candidateCount - 1;
+    for (uint8_t i = 0; i < candidateCount; i++) {
+      if (candidates[i].word < candidates[best].word)
+        best = i;
+    }
+    return best;
+  }
+  case MATCH_POLICY_LONGEST:
+  case MATCH_POLICY_ALL:
+  default:
+    return 0;
   }
 }
 
 bool Dictionary_checkForWord(String &foundWord) {
-  if (letterCount == 0 || dictionary.empty())
+  candidateCount = 0;
+  if (letterWindow.empty())
+    return false;
+  if (!sdDictActive && DictMatcher_empty(dictionary))
     return false;
 
-  for (size_t i = 0; i < dictionary.size(); i++) {
-    const String &word = dictionary[i];
-    int len = word.length();
-    if (len > letterCount)
-      continue;
-
-    bool match = true;
-    for (int j = 0; j < len; j++) {
-      char bufChar = letterBuffer[letterCount - len + j];
-      char dictChar = word[j];
-      if (bufChar != dictChar) {
-        match = false;
-        break;
-      }
-    }
+  // Candidates are suffixes of the window; keep a linear copy for the SD
+  // lookup and for getCandidates().
+  windowLength = (int)letterWindow.copyLatest(windowCopy, LETTER_BUFFER_SIZE);
+  const DeviceSettings &s = Settings_get();
+  collectCandidates(s.minWordLength);
+  if (candidateCount == 0)
+    return false;
+  MatchPolicy policy = (MatchPolicy)s.matchPolicy;
+  hitCandidate = selectCandidate(policy);
+  const DictOutput &hit = candidates[hitCandidate];
+  char word[LETTER_BUFFER_SIZE + 1];
+  memcpy(word, windowCopy + windowLength - hit.length, hit.length);
+  word[hit.length] = '\0';
+  foundWord = word;
+  lastHitTags = hit.tags;
+
+  // "All" keeps every letter so overlapping words are still found later.
+  if (policy == MATCH_POLICY_ALL)
+    return true;
+
+  size_t keep = 2;
+  if (letterWindow.size() > keep)
+    letterWindow.drop(letterWindow.size() - keep);
+
+  // Re-seed the automaton so later hits only see the kept letters.
+  matchState = DICT_ROOT_STATE;
+  for (size_t i = 0; i < letterWindow.size(); i++) {
+    matchState = DictMatcher_step(dictionary, matchState, letterWindow.at(i));
+  }
+  return true;
+}
 
-    if (match) {
-      foundWord = word;
+static void fillHit(const DictOutput &c, DictHit &out) {
+  memcpy(out.word, windowCopy + windowLength - c.length, c.length);
+  out.word[c.length] = '\0';
+  out.id = c.word;
+  out.tags = c.tags;
+}
 
-      int keep = 2;
-      if (keep > letterCount)
-        keep = letterCount;
-      char temp[LETTER_BUFFER_SIZE];
-      memcpy(temp, letterBuffer + (letterCount - keep), keep);
-      memcpy(letterBuffer, temp, keep);
-      letterCount = keep;
+uint8_t Dictionary_getCandidates(DictHit *out, uint8_t maxHits) {
+  uint8_t count = candidateCount < maxHits ? candidateCount : maxHits;
+  for (uint8_t i = 0; i < count; i++)
+    fillHit(candidates[i], out[i]);
+  return count;
+}
 
-      return true;
-    }
-  }
-  return false;
+bool Dictionary_getHit(DictHit &out) {
+  if (candidateCount == 0)
+    return false;
+  fillHit(candidates[hitCandidate], out);
+  return true;
 }
 
-void Dictionary_clearBufferAndWord() { letterCount = 0; }
+void Dictionary_clearBufferAndWord() {
+  letterWindow.clear();
+  candidateCount = 0;
+  matchState = DICT_ROOT_STATE;
+}
 
 uint8_t Dictionary_getActiveIndex() { return activeDictIndex; }
 
-uint8_t Dictionary_getCount() { return (uint8_t)DICT_FILE_COUNT; }
+uint8_t Dictionary_getCount() {
+  return (uint8_t)(DICT_ALL_INDEX + 1 + SdDictionary_getCount());
+}
 
 const char *Dictionary_getActiveName() {
   return Dictionary_getNameForIndex(activeDictIndex);
 }
 
 const char *Dictionary_getNameForIndex(uint8_t idx) {
-  if (DICT_FILE_COUNT == 0)
+  uint8_t total = Dictionary_getCount();
+  if (total == 0)
     return nullptr;
-  if (idx >= DICT_FILE_COUNT)
-    idx = DICT_FILE_COUNT - 1;
-  return DICT_NAMES[idx];
+  if (idx >= total)
+    idx = total - 1;
+  if (idx < DICT_FILE_COUNT)
+    return DICT_NAMES[idx];
+  if (idx == DICT_ALL_INDEX)
+    return DICT_ALL_NAME;
+  return SdDictionary_getName(idx - DICT_ALL_INDEX - 1);
+}
+
+String Dictionary_getHitSources() {
+  return Dictionary_getSourcesForTags(lastHitTags);
+}
+
+String Dictionary_getSourcesForTags(uint8_t tags) {
+  char buf[64];
+  Dictionary_formatSources(tags, buf, sizeof(buf));
+  return String(buf);
+}
+
+void Dictionary_formatSources(uint8_t tags, char *dst, size_t size) {
+  if (size == 0)
+    return;
+  if (tags == 0) {
+    const char *name = Dictionary_getActiveName();
+    snprintf(dst, size, "%s", name ? name : "unknown");
+    return;
+  }
+  size_t used = 0;
+  dst[0] = '\0';
+  for (uint8_t i = 0; i < DICT_FILE_COUNT && used < size; i++) {
+    if (!(tags & (1 << i)))
+      continue;
+    int n = snprintf(dst + used, size - used, "%s%s", used ? "+" : "",
+                     DICT_NAMES[i]);
+    if (n < 0)
+      break;
+    used += (size_t)n;
+  }
 }
@@ -0,0 +1,237 @@
+#include "DictMatcher.h"
+#include <string.h>
+
+static const uint32_t NO_NODE = 0xFFFFFFFFUL;
+
+static uint32_t findChild(const DictMatcher &m, uint32_t state, uint8_t label) {
+  const DictNode &n = m.nodes[state];
+  for (uint32_t i = 0; i < n.childCount; i++) {
+    const DictNode &child = m.nodes[n.firstChild + i];
+    if (child.label == label)
+      return n.firstChild + i;
+    if (child.label > label)
+      break; // children sorted by label
+  }
+  return NO_NODE;
+}
+
+uint32_t DictMatcher_step(const DictMatcher &m, uint32_t state, char c) {
+  if (m.nodeCount == 0)
+    return DICT_ROOT_STATE;
+  uint8_t label = (uint8_t)c;
+  for (;;) {
+    uint32_t next = findChild(m, state, label);
+    if (next != NO_NODE)
+      return next;
+    if (state == DICT_ROOT_STATE)
+      return DICT_ROOT_STATE;
+    state = m.nodes[state].fail;
+  }
+}
+
+// State of the longest word that is a suffix at state, or the root.
+static uint32_t firstOutput(const DictMatcher &m, uint32_t state) {
+  const DictNode &n = m.nodes[state];
+  return n.word != DICT_NODE_NONE ? state : n.output;
+}
+
+uint32_t DictMatcher_matchAt(const DictMatcher &m, uint32_t state) {
+  if (state >= m.nodeCount)
+    return DICT_NO_WORD;
+  uint32_t match = DICT_NO_WORD;
+  for (uint32_t s = firstOutput(m, state); s != DICT_ROOT_STATE;
+       s = m.nodes[s].output) {
+    if (m.nodes[s].word < match)
+      match = m.nodes[s].word; // lower id = earlier in the source list
+  }
+  return match;
+}
+
+const char *DictMatcher_word(const DictMatcher &m, uint32_t wordId) {
+  if (wordId >= m.wordCount)
+    return nullptr;
+  return m.chars + m.wordOffsets[wordId];
+}
+
+uint8_t DictMatcher_tagsAt(const DictMatcher &m, uint32_t state) {
+  if (state >= m.nodeCount)
+    return 0;
+  uint8_t tags = 0;
+  for (uint32_t s = firstOutput(m, state); s != DICT_ROOT_STATE;
+       s = m.nodes[s].output)
+    tags |= m.nodes[s].tags;
+  return tags;
+}
+
+uint32_t DictMatcher_outputs(const DictMatcher &m, uint32_t state,
+                             DictOutput *out, uint32_t maxOut) {
+  if (state >= m.nodeCount)
+    return 0;
+  uint32_t count = 0;
+  uint32_t s = firstOutput(m, state);
+  while (s != DICT_ROOT_STATE && count < maxOut) {
+    const DictNode &n = m.nodes[s];
+    out[count].word = n.word;
+    out[count].length = n.depth;
+    out[count].tags = n.tags;
+    count++;
+    s = n.output;
+  }
+  return count;
+}
+
+bool DictMatcher_empty(const DictMatcher &m) { return m.wordCount == 0; }
+
+void DictMatcherBuilder::clear() {
+  // swap() releases capacity so a rebuild starts from an empty heap footprint.
+  std::vector<TrieNode>().swap(trie);
+  std::vector<DictNode>().swap(nodes);
+  std::vector<uint32_t>().swap(wordOffsets);
+  std::vector<char>().swap(chars);
+}
+
+void DictMatcherBuilder::reserve(size_t words, size_t charCount) {
+  wordOffsets.reserve(words);
+  chars.reserve(charCount);
+  trie.reserve(charCount + 1); // one node per letter at most, plus the root
+}
+
+size_t DictMatcherBuilder::peakBytes(size_t charCount) {
+  size_t states = charCount + 1;
+  size_t words = charCount / 2; // a letter and a terminator each
+  return states * (sizeof(TrieNode) + sizeof(DictNode) + sizeof(uint32_t)) +
+         words * sizeof(uint32_t) + charCount;
+}
+
+size_t DictMatcherBuilder::largestBlock(size_t charCount) {
+  return (charCount + 1) * sizeof(DictNode);
+}
+
+uint32_t DictMatcherBuilder::findChild(uint32_t node, uint8_t label) const {
+  for (uint32_t c = trie[node].firstChild; c != DICT_NODE_NONE;
+       c = trie[c].nextSibling) {
+    if (trie[c].label == label)
+      return c;
+  }
+  return NO_NODE;
+}
+
+bool DictMatcherBuilder::addWord(const char *word, size_t len, uint8_t tags) {
+  if (!word || len == 0 || len > 255)
+    return false;
+  if (trie.empty())
+    trie.push_back({DICT_NODE_NONE, DICT_NODE_NONE, 0, DICT_NODE_NONE, 0});
+  // Room for every new state and the word id within 24 bits.
+  if (trie.size() + len >= DICT_NODE_NONE ||
+      wordOffsets.size() >= DICT_NODE_NONE)
+    return false;
+
+  uint32_t node = DICT_ROOT_STATE;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t label = (uint8_t)word[i];
+    uint32_t next = findChild(node, label);
+    if (next == NO_NODE) {
+      next = (uint32_t)trie.size();
+      trie.push_back({DICT_NODE_NONE, trie[node].firstChild, label,
+                      DICT_NODE_NONE, 0});
+      trie[node].firstChild = next;
+    }
+    node = next;
+  }
+  trie[node].tags |= tags; // a duplicate still adds its lists
+  if (trie[node].word != DICT_NODE_NONE)
+    return false; // duplicate; first occurrence keeps priority
+
+  trie[node].word = (uint32_t)wordOffsets.size();
+  wordOffsets.push_back((uint32_t)chars.size());
+  chars.insert(chars.end(), word, word + len);
+  chars.push_back('\0');
+  return true;
+}
+
+DictMatcher DictMatcherBuilder::build() {
+  DictMatcher m = {nullptr, 0, nullptr, 0, nullptr};
+  if (wordOffsets.empty())
+    return m;
+
+  // Renumber the insertion trie breadth-first so every node's children are
+  // contiguous and sorted; bfs[i] is the insertion index of final node i.
+  const uint32_t count = (uint32_t)trie.size();
+  std::vector<uint32_t> bfs;
+  bfs.reserve(count);
+  bfs.push_back(DICT_ROOT_STATE);
+  nodes.assign(count, DictNode());
+  nodes[DICT_ROOT_STATE] = {0, 0, DICT_ROOT_STATE, 0, DICT_ROOT_STATE, 0,
+                            DICT_NODE_NONE, 0};
+
+  for (uint32_t i = 0; i < bfs.size(); i++) {
+    uint32_t old = bfs[i];
+    uint32_t first = (uint32_t)bfs.size();
+    for (uint32_t c = trie[old].firstChild; c != DICT_NODE_NONE;
+         c = trie[c].nextSibling) {
+      // Insertion sort by label; fan-out is at most a few dozen.
+      bfs.push_back(c);
+      for (uint32_t j = (uint32_t)bfs.size() - 1;
+           j > first && trie[bfs[j - 1]].label > trie[bfs[j]].label; j--) {
+        uint32_t t = bfs[j];
+        bfs[j] = bfs[j - 1];
+        bfs[j - 1] = t;
+      }
+    }
+    nodes[i].firstChild = first;
+    nodes[i].childCount = (uint8_t)(bfs.size() - first);
+    for (uint32_t k = first; k < bfs.size(); k++) {
+      DictNode &child = nodes[k];
+      const TrieNode &t = trie[bfs[k]];
+      child.label = t.label;
+      child.depth = nodes[i].depth + 1;
+      child.word = t.word;
+      child.tags = t.tags;
+    }
+  }
+  std::vector<TrieNode>().swap(trie);
+  std::vector<uint32_t>().swap(bfs);
+
+  m.nodes = nodes.data();
+  m.nodeCount = count;
+
+  // Fail links in BFS order: a node's fail target is always shallower, so it
+  // is final (including its output link) before it is consulted.
+  for (uint32_t i = 0; i < count; i++) {
+    const DictNode &parent = nodes[i];
+    for (uint32_t k = 0; k < parent.childCount; k++) {
+      DictNode &child = nodes[parent.firstChild + k];
+      uint32_t target = DICT_ROOT_STATE;
+      if (i != DICT_ROOT_STATE) {
+        uint32_t f = parent.fail;
+        for (;;) {
+          uint32_t t = ::findChild(m, f, child.label);
+          if (t != NO_NODE) {
+            target = t;
+            break;
+          }
+          if (f == DICT_ROOT_STATE)
+            break;
+          f = nodes[f].fail;
+        }
+      }
+      child.fail = target;
+      child.output = nodes[target].word != DICT_NODE_NONE
+                         ? target
+                         : nodes[target].output;
+    }
+  }
+
+  wordOffsets.shrink_to_fit();
+  chars.shrink_to_fit();
+
+  m.wordOffsets = wordOffsets.data();
+  m.wordCount = (uint32_t)wordOffsets.size();
+  m.chars = chars.data();
+  return m;
+}
+
+size_t DictMatcherBuilder::memoryBytes() const {
+  return nodes.capacity() * sizeof(DictNode) +
+         wordOffsets.capacity() * sizeof(uint32_t) + chars.capacity();
+}
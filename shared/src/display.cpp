@@ -1,11 +1,16 @@
 #include "Display.h"
 #include "Dictionary.h"
+#include "GlyphCache.h"
+#include "Log.h"
 #include "Settings.h"
+#include "SpscRing.h"
+#include "TftDma.h"
 #include "config_core.h"
 #include <Adafruit_GFX.h>
 #include <Fonts/FreeSans12pt7b.h>
 #include <Fonts/FreeSans24pt7b.h>
 #include <Fonts/FreeSans9pt7b.h>
+#include <atomic>
 #include <math.h>
 
 // --- Color scheme (RGB565) ---
@@ -36,25 +41,44 @@ struct UiStyle {
   bool nightMode;
   float brightnessScale;
 
+  // Derived by rebuild() whenever the brightness or mode changes, so colour
+  // lookups are table reads: each RGB565 channel scaled and shifted into
+  // place, and the current palette already scaled.
+  uint16_t redLut[32];
+  uint16_t greenLut[64];
+  uint16_t blueLut[32];
+  UiPalette scaled;
+
   UiPalette current() const { return nightMode ? night : base; }
 
   uint16_t scale(uint16_t color) const {
-    uint8_t r = (color >> 11) & 0x1F;
-    uint8_t g = (color >> 5) & 0x3F;
-    uint8_t b = color & 0x1F;
+    return redLut[color >> 11] | greenLut[(color >> 5) & 0x3F] |
+           blueLut[color & 0x1F];
+  }
+
+  void rebuild() {
     float s = brightnessScale;
-    r = (uint8_t)min(31, (int)(r * s));
-    g = (uint8_t)min(63, (int)(g * s));
-    b = (uint8_t)min(31, (int)(b * s));
-    return (r << 11) | (g << 5) | b;
+    for (int v = 0; v < 32; v++) {
+      redLut[v] = (uint16_t)(min(31, (int)(v * s)) << 11);
+      blueLut[v] = (uint16_t)min(31, (int)(v * s));
+    }
+    for (int v = 0; v < 64; v++)
+      greenLut[v] = (uint16_t)(min(63, (int)(v * s)) << 5);
+    UiPalette p = current();
+    scaled.bg = scale(p.bg);
+    scaled.panel = scale(p.panel);
+    scaled.text = scale(p.text);
+    scaled.textDim = scale(p.textDim);
+    scaled.accent = scale(p.accent);
+    scaled.accentSoft = scale(p.accentSoft);
   }
 
-  uint16_t bg() const { return scale(current().bg); }
-  uint16_t panel() const { return scale(current().panel); }
-  uint16_t text() const { return scale(current().text); }
-  uint16_t textDim() const { return scale(current().textDim); }
-  uint16_t accent() const { return scale(current().accent); }
-  uint16_t accentSoft() const { return scale(current().accentSoft); }
+  uint16_t bg() const { return scaled.bg; }
+  uint16_t panel() const { return scaled.panel; }
+  uint16_t text() const { return scaled.text; }
+  uint16_t textDim() const { return scaled.textDim; }
+  uint16_t accent() const { return scaled.accent; }
+  uint16_t accentSoft() const { return scaled.accentSoft; }
 };
 
 static UiStyle uiStyle = {{COL_BG_BASE, COL_PANEL_BASE, COL_TEXT_BASE,
@@ -63,11 +87,28 @@ static UiStyle uiStyle = {{COL_BG_BASE, COL_PANEL_BASE, COL_TEXT_BASE,
                           {0x0000, 0x1082, 0xBDF7, 0x7BEF, 0xF980,
                            0x9000}, // night variant: warmer, softer
                           false,
-                          BRIGHTNESS_SCALES[2]};
+                          BRIGHTNESS_SCALES[2],
+                          {},
+                          {},
+                          {},
+                          {}};
+static uint32_t paletteEpoch = 0;
+
+static void rebuildPalette() {
+  uiStyle.rebuild();
+  paletteEpoch++;
+}
 
-static DisplayHardwareConfig hwConfig = {-1, -1, -1, -1};
+static DisplayHardwareConfig hwConfig = {-1, -1, -1, -1, -1, -1};
 static Adafruit_ILI9341 *tftPtr = nullptr;
-#define tft (*tftPtr)
+static const uint32_t TFT_SPI_HZ = 40000000;
+
+// The driver writes to the bus directly; let queued DMA blits finish first.
+static Adafruit_ILI9341 &panelForCpu() {
+  TftDma_waitAll();
+  return *tftPtr;
+}
+#define tft panelForCpu()
 static char lastDisplayedLetter = 0;
 static uint8_t currentBrightnessLevel = 2;
 
@@ -78,18 +119,40 @@ static bool backlightConfigured = false;
 
 // Layout cached for other modules
 static DisplayLayout layout;
-
-// Heartbeat scroller buffer (double-buffered windowed blit)
-static GFXcanvas16 heartbeatCanvas(HEARTBEAT_W, HEARTBEAT_H);
+// Bumped when the panel is drawn over outside the modules' own blits.
+static uint32_t frameEpoch = 0;
+
+// Heartbeat scroller: a ring of columns. Strip column s lives in ring column
+// (heartbeatHead + s) % HEARTBEAT_RING_W, so scrolling only moves the head.
+// A tick clears and rasterizes the columns entering on the right and sends
+// the columns whose pixels changed (those under glyphs); the bare trace looks
+// the same after any shift and is never resent.
+static const int HEARTBEAT_SPACING = 24; // glyph cell; ink stays inside it
+// Columns kept ready past the right edge, so a glyph is rasterized whole
+// before its first column shows.
+static const int HEARTBEAT_LOOKAHEAD = 2 * HEARTBEAT_SPACING;
+static const int HEARTBEAT_RING_W = HEARTBEAT_W + HEARTBEAT_LOOKAHEAD;
+// Most columns one update scrolls; more and a glyph could show before it is
+// drawn. Slower loops fall behind rather than tear.
+static const int HEARTBEAT_MAX_STEP = HEARTBEAT_LOOKAHEAD - HEARTBEAT_SPACING;
+// Indexed colour: the palette below is applied as the columns are sent.
+enum HeartbeatColor : uint8_t { HB_COL_BG, HB_COL_LINE, HB_COL_GLYPH };
+static GFXcanvas8 heartbeatCanvas(HEARTBEAT_RING_W, HEARTBEAT_H);
+static uint16_t heartbeatPalette[3];
+static int heartbeatHead = 0;     // ring column of strip column 0
+static int heartbeatPrepared = 0; // strip columns cleared, glyphs drawn
+static bool heartbeatFullBlit = true;
+static int heartbeatDirtyX0 = 0; // extra strip span to send (dropped glyphs)
+static int heartbeatDirtyX1 = 0;
+static int heartbeatInkY0 = HEARTBEAT_H; // rows any drawn glyph touches
+static int heartbeatInkY1 = 0;
+static uint32_t heartbeatPaletteEpoch = 0; // palette the panel shows
 static unsigned long lastHeartbeatStepMs = 0;
-static const int HEARTBEAT_SPACING = 24;
 static const unsigned long HEARTBEAT_SCROLL_INTERVAL_BASE_MS = 35;
 static const uint16_t HEARTBEAT_SCROLL_BPM_BASE = 120;
 static unsigned long heartbeatScrollIntervalMs =
     HEARTBEAT_SCROLL_INTERVAL_BASE_MS;
-static const int HEARTBEAT_MAX_ENTRIES = 24; // keep ~last 20 chars safely
-static int heartbeatDirtyX0 = 0;
-static int heartbeatDirtyX1 = HEARTBEAT_W;
+static const int HEARTBEAT_MAX_ENTRIES = 32; // ~20 visible; power of two
 static uint16_t heartbeatBpmTarget = HEARTBEAT_SCROLL_BPM_BASE;
 static uint16_t heartbeatBpmCurrent = HEARTBEAT_SCROLL_BPM_BASE;
 static unsigned long lastHeartbeatEaseMs = 0;
@@ -97,26 +160,31 @@ static const unsigned long HEARTBEAT_EASE_INTERVAL_MS = 80;
 
 struct HeartbeatEntry {
   char c;
-  int x; // pixel position relative to visible window
+  int x;       // cell's left edge, in strip columns
+  int8_t inkX; // glyph ink, relative to x; valid once drawn
+  uint8_t inkW;
+  bool drawn;
 };
-static HeartbeatEntry heartbeatEntries[HEARTBEAT_MAX_ENTRIES];
-static int heartbeatEntryCount = 0;
+// Oldest (leftmost) first, so entries scrolling off are dropped from the front.
+static SpscRing<HeartbeatEntry, HEARTBEAT_MAX_ENTRIES> heartbeatEntries;
 
 // Word overlay
 static String overlayWord;
 
-// Header/status state
+// Header/status state. The setters may run on other tasks (the WiFi scan
+// task, the SD writer on core 0), so they only flag the header; the loop
+// redraws it. A pulse holds the millis() it ends at, 0 when idle.
 static bool tftReady = false;
+static std::atomic<bool> headerDirty(false);
 static bool statusSdPresent = false;
 static bool statusLoggingEnabled = false;
 static bool statusWifiActive = false;
-static unsigned long sdPulseUntilMs = 0;
-static unsigned long wifiPulseUntilMs = 0;
+static std::atomic<uint32_t> sdPulseUntilMs(0);
+static std::atomic<uint32_t> wifiPulseUntilMs(0);
 
 // Word history (right module)
 static const int WORD_HISTORY_MAX = 5;
-static String wordHistory[WORD_HISTORY_MAX];
-static int wordHistoryCount = 0;
+static SpscRing<String, 8> wordHistory; // newest last, WORD_HISTORY_MAX kept
 
 // Overlay fade
 static unsigned long overlayFadeStartMs = 0;
@@ -131,7 +199,7 @@ static bool ensureTft() {
   if (tftPtr)
     return true;
   if (hwConfig.cs < 0 || hwConfig.dc < 0) {
-    Serial.println(F("Display pins not configured"));
+    LOG_ERROR("Display pins not configured");
     return false;
   }
   tftPtr = new Adafruit_ILI9341(hwConfig.cs, hwConfig.dc, hwConfig.rst);
@@ -141,12 +209,9 @@ static bool ensureTft() {
 static void pushWordHistory(const String &w) {
   if (w.length() == 0)
     return;
-  for (int i = min(wordHistoryCount, WORD_HISTORY_MAX - 1); i > 0; i--) {
-    wordHistory[i] = wordHistory[i - 1];
-  }
-  wordHistory[0] = w;
-  if (wordHistoryCount < WORD_HISTORY_MAX)
-    wordHistoryCount++;
+  if (wordHistory.size() >= WORD_HISTORY_MAX)
+    wordHistory.drop(1);
+  wordHistory.push(w);
 }
 
 static void computeLayout() {
@@ -201,7 +266,7 @@ static uint16_t colAccentSoft() { return uiStyle.accentSoft(); }
 
 Adafruit_ILI9341 &Display_tft() {
   ensureTft();
-  return *tftPtr;
+  return tft;
 }
 
 static void ensureBacklightConfigured() {
@@ -215,7 +280,10 @@ static void ensureBacklightConfigured() {
 void Display_applyBrightness(uint8_t level) {
   level = Settings_clampBrightness(level, BRIGHTNESS_LEVEL_COUNT - 1);
   currentBrightnessLevel = level;
-  uiStyle.brightnessScale = BRIGHTNESS_SCALES[level];
+  if (uiStyle.brightnessScale != BRIGHTNESS_SCALES[level] || !paletteEpoch) {
+    uiStyle.brightnessScale = BRIGHTNESS_SCALES[level];
+    rebuildPalette();
+  }
 
   if (DISPLAY_BL_PIN >= 0) {
     ensureBacklightConfigured();
@@ -230,6 +298,10 @@ uint8_t Display_getBrightnessLevel() { return currentBrightnessLevel; }
 
 const DisplayLayout &Display_getLayout() { return layout; }
 
+uint32_t Display_getFrameEpoch() { return frameEpoch; }
+
+uint32_t Display_getPaletteEpoch() { return paletteEpoch; }
+
 static bool heartbeatReady() { return heartbeatCanvas.getBuffer() != nullptr; }
 
 static void updateHeartbeatInterval(uint16_t bpm) {
@@ -240,32 +312,121 @@ static void updateHeartbeatInterval(uint16_t bpm) {
   heartbeatBpmCurrent = clamped;
 }
 
+// Reset strip columns [from, to) to the bare trace.
+static void heartbeatClearColumns(int from, int to) {
+  while (from < to) {
+    int col = (heartbeatHead + from) % HEARTBEAT_RING_W;
+    int run = min(to - from, HEARTBEAT_RING_W - col);
+    heartbeatCanvas.fillRect(col, 0, run, HEARTBEAT_H, HB_COL_BG);
+    heartbeatCanvas.drawFastHLine(col, HEARTBEAT_H / 2, run, HB_COL_LINE);
+    from += run;
+  }
+}
+
+static void heartbeatDrawGlyph(HeartbeatEntry &e) {
+  char buf[2] = {e.c, '\0'};
+  int16_t x1, y1;
+  uint16_t w, h;
+  GlyphCache_textBounds(&FreeSans12pt7b, buf, x1, y1, w, h);
+  int tx = e.x - w / 2 + HEARTBEAT_SPACING / 2;
+  int ty = (HEARTBEAT_H + h) / 2;
+  e.inkX = (int8_t)(tx + x1 - e.x);
+  e.inkW = (uint8_t)w;
+  e.drawn = true;
+  if (ty + y1 < heartbeatInkY0)
+    heartbeatInkY0 = max(ty + y1, 0);
+  if (ty + y1 + h > heartbeatInkY1)
+    heartbeatInkY1 = min(ty + y1 + (int)h, HEARTBEAT_H);
+
+  // Ring position of the cursor; a glyph straddling the ring's end is drawn
+  // twice and the canvas clips each copy.
+  int rx = ((heartbeatHead + tx) % HEARTBEAT_RING_W + HEARTBEAT_RING_W) %
+           HEARTBEAT_RING_W;
+  uint8_t c = HB_COL_GLYPH;
+  GlyphCache_drawText(heartbeatCanvas, &FreeSans12pt7b, rx, ty, buf, c);
+  if (rx + x1 + (int)w > HEARTBEAT_RING_W)
+    GlyphCache_drawText(heartbeatCanvas, &FreeSans12pt7b, rx - HEARTBEAT_RING_W,
+                        ty, buf, c);
+  else if (rx + x1 < 0)
+    GlyphCache_drawText(heartbeatCanvas, &FreeSans12pt7b, rx + HEARTBEAT_RING_W,
+                        ty, buf, c);
+}
+
+// Clear the columns up to strip column `upTo` and rasterize every glyph whose
+// cell now fits. Ring columns past `upTo` are scratch: a glyph cut by the
+// left edge spills its hidden part there, so a rebuild stops a cell short of
+// the ring's end.
+static void heartbeatPrepare(int upTo) {
+  if (heartbeatPrepared < upTo) {
+    heartbeatClearColumns(heartbeatPrepared, upTo);
+    heartbeatPrepared = upTo;
+  }
+  for (size_t i = 0; i < heartbeatEntries.size(); i++) {
+    HeartbeatEntry &e = heartbeatEntries.at(i);
+    if (e.drawn)
+      continue;
+    if (e.x + HEARTBEAT_SPACING > heartbeatPrepared)
+      break; // later entries sit further right
+    heartbeatDrawGlyph(e);
+  }
+  heartbeatCanvas.setFont();
+}
+
+// Redraw the whole ring from the entries.
+static void heartbeatRebuild() {
+  heartbeatPrepared = 0;
+  heartbeatInkY0 = HEARTBEAT_H;
+  heartbeatInkY1 = 0;
+  for (size_t i = 0; i < heartbeatEntries.size(); i++)
+    heartbeatEntries.at(i).drawn = false;
+  heartbeatPrepare(HEARTBEAT_W + HEARTBEAT_SPACING);
+  heartbeatFullBlit = true;
+}
+
 static void heartbeatReset() {
   if (!heartbeatReady()) {
-    Serial.println(F("heartbeat canvas alloc failed; skipping scroller"));
+    LOG_ERROR("heartbeat canvas alloc failed; skipping scroller");
     return;
   }
-  heartbeatCanvas.fillScreen(colBg());
-  heartbeatEntryCount = 0;
-  heartbeatDirtyX0 = 0;
-  heartbeatDirtyX1 = HEARTBEAT_W;
+  heartbeatEntries.clear();
+  heartbeatHead = 0;
+  heartbeatDirtyX0 = heartbeatDirtyX1 = 0;
+  heartbeatRebuild();
   heartbeatBpmCurrent = heartbeatBpmTarget;
 }
 
 void Display_begin() {
   if (!ensureTft()) {
-    Serial.println(F("Display init skipped; missing driver"));
+    LOG_ERROR("Display init skipped; missing driver");
     return;
   }
   computeLayout();
-  tft.begin();
+  if (!paletteEpoch)
+    rebuildPalette();
+  tft.begin(TFT_SPI_HZ);
   tft.setRotation(1); // Landscape: 320x240
   tftReady = true;
+  GlyphCache_addFont(nullptr);
+  GlyphCache_addFont(&FreeSans12pt7b);
+#ifdef GHOST_TFT_DMA
+  // Opt-in until validated on a board; see TftDma.h.
+  TftDmaConfig dma = {hwConfig.cs, hwConfig.dc, hwConfig.sclk, hwConfig.mosi,
+                      TFT_SPI_HZ};
+  TftDma_begin(dma);
+#endif
   updateHeartbeatInterval(Settings_get().heartbeatBpm);
 }
 
-static bool isPulsing(unsigned long untilMs, unsigned long now) {
-  return untilMs != 0 && now < untilMs;
+static bool isPulsing(const std::atomic<uint32_t> &untilMs, uint32_t now) {
+  uint32_t until = untilMs.load(std::memory_order_relaxed);
+  return until != 0 && now < until;
+}
+
+// Clear a pulse that has ended, unless another task just started a new one.
+static bool expirePulse(std::atomic<uint32_t> &untilMs, uint32_t now) {
+  uint32_t until = untilMs.load(std::memory_order_relaxed);
+  return until != 0 && now > until &&
+         untilMs.compare_exchange_strong(until, 0, std::memory_order_relaxed);
 }
 
 static uint16_t statusColor(bool active, bool pulsing) {
@@ -328,7 +489,7 @@ static void drawHeaderStatusArea() {
   int areaH = layout.headerH - inset * 2;
   tft.fillRect(areaX, areaY, areaW, areaH, bg);
 
-  unsigned long now = millis();
+  uint32_t now = (uint32_t)millis();
   bool sdPulse = isPulsing(sdPulseUntilMs, now);
   bool wifiPulse = isPulsing(wifiPulseUntilMs, now);
 
@@ -347,6 +508,7 @@ static void drawHeaderStatusArea() {
 
 static void drawLetterBadge(char l) {
   // Floating badge in the top-left of radar region
+  frameEpoch++;
   int badgeW = 56;
   int badgeH = 56;
   int areaX = layout.radarX + 6;
@@ -363,7 +525,7 @@ static void drawLetterBadge(char l) {
 
   int16_t x1, y1;
   uint16_t w, h;
-  tft.getTextBounds(buf, 0, 0, &x1, &y1, &w, &h);
+  GlyphCache_textBounds(&FreeSans24pt7b, buf, x1, y1, w, h);
 
   int centerX = areaX + badgeW / 2;
   int centerY = areaY + badgeH / 2;
@@ -401,12 +563,12 @@ static void drawWordHistoryPanel() {
   tft.setCursor(labelX, areaY + 14);
   tft.print(label);
 
-  int maxLines = min(wordHistoryCount, WORD_HISTORY_MAX);
+  int maxLines = (int)wordHistory.size();
   int lineY = areaY + 28;
   for (int i = 0; i < maxLines; i++) {
     tft.setTextColor(colText(), colPanel());
     tft.setCursor(areaX + 6, lineY);
-    String word = wordHistory[i];
+    String word = wordHistory.at(maxLines - 1 - i); // newest on top
     if (word.length() > 8) {
       word = word.substring(0, 7) + ".";
     }
@@ -461,6 +623,7 @@ static void drawModules() {
 
 void Display_drawStaticFrame() {
   lastDisplayedLetter = 0;
+  frameEpoch++;
   computeLayout();
 
   tft.fillScreen(colBg());
@@ -485,6 +648,7 @@ void Display_updateStatusBar(float temp, float humidity) {
 
 void Display_setNightMode(bool enabled) {
   uiStyle.nightMode = enabled;
+  rebuildPalette();
   if (tftReady) {
     Display_drawStaticFrame();
     drawHeaderStatusArea();
@@ -493,32 +657,27 @@ void Display_setNightMode(bool enabled) {
 
 void Display_setSdPresent(bool present) {
   statusSdPresent = present;
-  if (tftReady)
-    drawHeaderStatusArea();
+  headerDirty = true;
 }
 
 void Display_setLoggingEnabled(bool enabled) {
   statusLoggingEnabled = enabled;
-  if (tftReady)
-    drawHeaderStatusArea();
+  headerDirty = true;
 }
 
 void Display_setWifiActive(bool active) {
   statusWifiActive = active;
-  if (tftReady)
-    drawHeaderStatusArea();
+  headerDirty = true;
 }
 
 void Display_notifySdActivity() {
-  sdPulseUntilMs = millis() + 450;
-  if (tftReady)
-    drawHeaderStatusArea();
+  sdPulseUntilMs.store((uint32_t)millis() + 450, std::memory_order_relaxed);
+  headerDirty = true;
 }
 
 void Display_notifyWifiScan() {
-  wifiPulseUntilMs = millis() + 450;
-  if (tftReady)
-    drawHeaderStatusArea();
+  wifiPulseUntilMs.store((uint32_t)millis() + 450, std::memory_order_relaxed);
+  headerDirty = true;
 }
 
 void Display_displayLetter(char l) {
@@ -540,21 +699,26 @@ void Display_displayWord(const String &w) {
   Display_setOverlayWord(w);
   pushWordHistory(w);
   drawWordHistoryPanel();
-  Display_drawOverlayWord();
+  // The overlay itself goes out with the next radar frame.
 }
 
-void Display_drawOverlayWord() {
-  if (overlayWord.length() == 0)
-    return;
-
+// Cursor, covered box and fade colour of the overlay word, relative to an
+// origin at (originX, originY) on screen.
+static void layoutOverlayWord(int originX, int originY, int16_t &cx,
+                              int16_t &cy, DisplayRect &box,
+                              uint16_t &mainColor) {
   // Draw centered over radar region
   int16_t x1, y1;
   uint16_t ww, hh;
-  tft.setFont(&FreeSans12pt7b);
-  tft.getTextBounds(overlayWord, 0, 0, &x1, &y1, &ww, &hh);
+  GlyphCache_textBounds(&FreeSans12pt7b, overlayWord.c_str(), x1, y1, ww, hh);
 
-  int16_t cx = layout.radarX + (layout.radarW - ww) / 2;
-  int16_t cy = layout.radarY + (layout.radarH + hh) / 2;
+  cx = layout.radarX - originX + (layout.radarW - ww) / 2;
+  cy = layout.radarY - originY + (layout.radarH + hh) / 2;
+  // Shadow is offset by 2px.
+  box.x = cx + x1;
+  box.y = cy + y1;
+  box.w = ww + 2;
+  box.h = hh + 2;
 
   unsigned long now = millis();
   if (overlayFadeStartMs == 0)
@@ -565,16 +729,61 @@ void Display_drawOverlayWord() {
   if (t > 1.0f)
     t = 1.0f;
 
-  uint16_t mainColor = lerpColor(colAccentSoft(), colAccent(), t);
+  mainColor = lerpColor(colAccentSoft(), colAccent(), t);
+}
 
+void Display_drawOverlayWord() {
+  if (overlayWord.length() == 0)
+    return;
+  int16_t cx, cy;
+  DisplayRect box;
+  uint16_t mainColor;
+  layoutOverlayWord(0, 0, cx, cy, box, mainColor);
+
+  tft.setFont(&FreeSans12pt7b);
+  tft.setTextWrap(false);
   tft.setTextColor(colAccentSoft());
   tft.setCursor(cx + 2, cy + 2);
   tft.print(overlayWord);
-
   tft.setTextColor(mainColor);
   tft.setCursor(cx, cy);
   tft.print(overlayWord);
   tft.setFont();
+  tft.setTextWrap(true);
+}
+
+bool Display_getOverlayWordRect(int originX, int originY, DisplayRect &box,
+                                uint16_t &shadowColor, uint16_t &mainColor,
+                                uint32_t &stamp) {
+  if (overlayWord.length() == 0)
+    return false;
+  int16_t cx, cy;
+  layoutOverlayWord(originX, originY, cx, cy, box, mainColor);
+  shadowColor = colAccentSoft();
+
+  stamp = 2166136261UL; // FNV-1a over the word, then both colours
+  for (unsigned int i = 0; i < overlayWord.length(); i++)
+    stamp = (stamp ^ (uint8_t)overlayWord[i]) * 16777619UL;
+  stamp = (stamp ^ mainColor) * 16777619UL;
+  stamp = (stamp ^ shadowColor) * 16777619UL;
+  return true;
+}
+
+void Display_drawOverlayWordOn(GFXcanvas8 &canvas, int originX, int originY,
+                               uint8_t shadowIndex, uint8_t mainIndex) {
+  if (overlayWord.length() == 0)
+    return;
+
+  int16_t cx, cy;
+  DisplayRect box;
+  uint16_t mainColor;
+  layoutOverlayWord(originX, originY, cx, cy, box, mainColor);
+
+  const char *word = overlayWord.c_str();
+  GlyphCache_drawText(canvas, &FreeSans12pt7b, cx + 2, cy + 2, word,
+                      shadowIndex);
+  GlyphCache_drawText(canvas, &FreeSans12pt7b, cx, cy, word, mainIndex);
+  canvas.setFont();
 }
 
 void Display_clearWordArea() {
@@ -587,39 +796,58 @@ void Display_heartbeatStep(char letterOrZero) {
     return;
   if (letterOrZero == 0)
     return; // only draw real letters
-  // Drop oldest if at capacity
-  if (heartbeatEntryCount >= HEARTBEAT_MAX_ENTRIES) {
-    memmove(heartbeatEntries, heartbeatEntries + 1,
-            (HEARTBEAT_MAX_ENTRIES - 1) * sizeof(HeartbeatEntry));
-    heartbeatEntryCount = HEARTBEAT_MAX_ENTRIES - 1;
+  // Drop oldest if at capacity; its pixels are wiped on the next update.
+  if (heartbeatEntries.full()) {
+    const HeartbeatEntry &old = heartbeatEntries.at(0);
+    if (old.drawn) {
+      int x0 = max(old.x + old.inkX, 0);
+      int x1 = min(old.x + old.inkX + old.inkW, heartbeatPrepared);
+      if (x0 < x1) {
+        heartbeatClearColumns(x0, x1);
+        if (heartbeatDirtyX0 >= heartbeatDirtyX1) {
+          heartbeatDirtyX0 = x0;
+          heartbeatDirtyX1 = x1;
+        } else {
+          heartbeatDirtyX0 = min(heartbeatDirtyX0, x0);
+          heartbeatDirtyX1 = max(heartbeatDirtyX1, x1);
+        }
+      }
+    }
+    heartbeatEntries.drop(1);
   }
   int startX = HEARTBEAT_W;
-  if (heartbeatEntryCount > 0) {
-    int lastX = heartbeatEntries[heartbeatEntryCount - 1].x;
-    if (lastX > startX)
-      startX = lastX + HEARTBEAT_SPACING;
+  if (!heartbeatEntries.empty()) {
+    int nextX = heartbeatEntries.newest().x + HEARTBEAT_SPACING;
+    if (nextX > startX)
+      startX = nextX;
+  }
+  HeartbeatEntry entry = {letterOrZero, startX, 0, 0, false};
+  heartbeatEntries.push(entry);
+}
+
+// Send strip columns [from, to), rows [y0, y1), from the ring.
+static void heartbeatBlitColumns(int from, int to, int y0, int y1) {
+  from = max(from, 0);
+  to = min(to, (int)HEARTBEAT_W);
+  while (from < to) {
+    int col = (heartbeatHead + from) % HEARTBEAT_RING_W;
+    int run = min(to - from, HEARTBEAT_RING_W - col);
+    Display_blitIndexed(
+        layout.heartbeatX + from, layout.heartbeatY + y0, run, y1 - y0,
+        heartbeatCanvas.getBuffer() + y0 * HEARTBEAT_RING_W + col,
+        HEARTBEAT_RING_W, heartbeatPalette);
+    from += run;
   }
-  heartbeatEntries[heartbeatEntryCount].c = letterOrZero;
-  heartbeatEntries[heartbeatEntryCount].x = startX;
-  heartbeatEntryCount++;
-  heartbeatDirtyX0 = 0;
-  heartbeatDirtyX1 = HEARTBEAT_W;
 }
 
 void Display_updateHeartbeat() {
   unsigned long now = millis();
-  bool pulseChanged = false;
-  if (sdPulseUntilMs && now > sdPulseUntilMs) {
-    sdPulseUntilMs = 0;
-    pulseChanged = true;
-  }
-  if (wifiPulseUntilMs && now > wifiPulseUntilMs) {
-    wifiPulseUntilMs = 0;
-    pulseChanged = true;
-  }
-  if (pulseChanged && tftReady) {
+  bool pulseChanged = expirePulse(sdPulseUntilMs, (uint32_t)now);
+  pulseChanged = expirePulse(wifiPulseUntilMs, (uint32_t)now) || pulseChanged;
+  // Take the flag before drawing, so a setter racing the redraw marks it
+  // again for the next pass.
+  if (tftReady && (headerDirty.exchange(false) || pulseChanged))
     drawHeaderStatusArea();
-  }
 
   if (!heartbeatReady())
     return;
@@ -637,51 +865,149 @@ void Display_updateHeartbeat() {
     updateHeartbeatInterval(heartbeatBpmCurrent);
   }
 
-  if (now - lastHeartbeatStepMs >= heartbeatScrollIntervalMs) {
-    lastHeartbeatStepMs = now;
-    // Advance all entries left; drop those fully off-screen.
-    int writeIdx = 0;
-    for (int i = 0; i < heartbeatEntryCount; i++) {
-      heartbeatEntries[i].x -= 1;
-      if (heartbeatEntries[i].x < -HEARTBEAT_SPACING)
-        continue;
-      heartbeatEntries[writeIdx++] = heartbeatEntries[i];
+  // Scroll every step that fell due since the last update, so the speed does
+  // not depend on the loop rate.
+  int steps = 0;
+  unsigned long elapsed = now - lastHeartbeatStepMs;
+  if (elapsed >= heartbeatScrollIntervalMs) {
+    steps = (int)(elapsed / heartbeatScrollIntervalMs);
+    if (steps > HEARTBEAT_MAX_STEP) {
+      steps = HEARTBEAT_MAX_STEP;
+      lastHeartbeatStepMs = now;
+    } else {
+      lastHeartbeatStepMs += steps * heartbeatScrollIntervalMs;
     }
-    heartbeatEntryCount = writeIdx;
-    heartbeatDirtyX0 = 0;
-    heartbeatDirtyX1 = HEARTBEAT_W;
   }
-  // Redraw heartbeat strip (dirty range only)
-  heartbeatCanvas.fillRect(heartbeatDirtyX0, 0,
-                           heartbeatDirtyX1 - heartbeatDirtyX0, HEARTBEAT_H,
-                           colBg());
-  uint16_t lineC = colTextDim();
-  int midY = HEARTBEAT_H / 2;
-  heartbeatCanvas.drawLine(heartbeatDirtyX0, midY, heartbeatDirtyX1, midY,
-                           lineC);
-
-  heartbeatCanvas.setFont(&FreeSans12pt7b);
-  heartbeatCanvas.setTextColor(colAccent());
-  for (int i = 0; i < heartbeatEntryCount; i++) {
-    char buf[2] = {heartbeatEntries[i].c, '\0'};
-    int16_t x1, y1;
-    uint16_t w, h;
-    heartbeatCanvas.getTextBounds(buf, 0, 0, &x1, &y1, &w, &h);
-    int16_t tx = heartbeatEntries[i].x - w / 2 + HEARTBEAT_SPACING / 2;
-    int16_t ty = (HEARTBEAT_H + h) / 2;
-    heartbeatCanvas.setCursor(tx, ty);
-    heartbeatCanvas.print(buf);
+  if (steps > 0) {
+    // Drop entries fully off-screen (always the oldest, since x grows from
+    // oldest to newest).
+    for (size_t i = 0; i < heartbeatEntries.size(); i++)
+      heartbeatEntries.at(i).x -= steps;
+    while (!heartbeatEntries.empty() &&
+           heartbeatEntries.at(0).x + HEARTBEAT_SPACING <= 0)
+      heartbeatEntries.drop(1);
+    heartbeatHead = (heartbeatHead + steps) % HEARTBEAT_RING_W;
+    heartbeatPrepared = max(heartbeatPrepared - steps, 0);
+    heartbeatDirtyX0 -= steps;
+    heartbeatDirtyX1 -= steps;
   }
-  heartbeatCanvas.setFont();
+  // A new palette only changes how the indices expand: resend everything.
+  if (heartbeatPaletteEpoch != paletteEpoch) {
+    heartbeatPaletteEpoch = paletteEpoch;
+    heartbeatPalette[HB_COL_BG] = colBg();
+    heartbeatPalette[HB_COL_LINE] = colTextDim();
+    heartbeatPalette[HB_COL_GLYPH] = colAccent();
+    heartbeatFullBlit = true;
+  }
+  heartbeatPrepare(HEARTBEAT_RING_W);
 
-  tft.drawRGBBitmap(layout.heartbeatX + heartbeatDirtyX0, layout.heartbeatY,
-                    heartbeatCanvas.getBuffer() + heartbeatDirtyX0,
-                    heartbeatDirtyX1 - heartbeatDirtyX0, HEARTBEAT_H);
+  if (heartbeatFullBlit) {
+    heartbeatFullBlit = false;
+    heartbeatDirtyX0 = heartbeatDirtyX1 = 0;
+    heartbeatBlitColumns(0, HEARTBEAT_W, 0, HEARTBEAT_H);
+    return;
+  }
+  if (heartbeatDirtyX0 < heartbeatDirtyX1) {
+    // The panel still shows the dropped glyph `steps` columns further right.
+    heartbeatBlitColumns(heartbeatDirtyX0, heartbeatDirtyX1 + steps, 0,
+                         HEARTBEAT_H);
+    heartbeatDirtyX0 = heartbeatDirtyX1 = 0;
+  }
+  if (steps == 0 || heartbeatInkY0 >= heartbeatInkY1)
+    return;
+
+  // A glyph moved left by `steps` changes its ink columns plus `steps` to the
+  // right of them. Neighbouring glyphs share one blit; a gap of a whole cell
+  // costs more to send than a second transfer.
+  int spanX0 = 0;
+  int spanX1 = 0;
+  for (size_t i = 0; i < heartbeatEntries.size(); i++) {
+    const HeartbeatEntry &e = heartbeatEntries.at(i);
+    if (!e.drawn)
+      break;
+    int x0 = e.x + e.inkX;
+    int x1 = x0 + e.inkW + steps;
+    if (x0 >= HEARTBEAT_W)
+      break;
+    if (spanX0 < spanX1 && x0 - spanX1 < HEARTBEAT_SPACING) {
+      spanX1 = x1;
+      continue;
+    }
+    if (spanX0 < spanX1)
+      heartbeatBlitColumns(spanX0, spanX1, heartbeatInkY0, heartbeatInkY1);
+    spanX0 = x0;
+    spanX1 = x1;
+  }
+  if (spanX0 < spanX1)
+    heartbeatBlitColumns(spanX0, spanX1, heartbeatInkY0, heartbeatInkY1);
+}
+
+uint32_t Display_blit(int16_t x, int16_t y, int16_t w, int16_t h,
+                      const uint16_t *pixels, int16_t stride,
+                      DisplayBlitCallback done, void *ctx) {
+  if (!tftReady)
+    return 0;
+  if (TftDma_ready() && w <= TFT_DMA_BUFFER_PIXELS)
+    return TftDma_blit(x, y, w, h, pixels, stride, done, ctx);
+
+  Adafruit_ILI9341 &panel = tft;
+  panel.startWrite();
+  panel.setAddrWindow(x, y, w, h);
+  for (int16_t row = 0; row < h; row++)
+    panel.writePixels((uint16_t *)pixels + (int32_t)row * stride, w);
+  panel.endWrite();
+  if (done)
+    done(0, ctx);
+  return 0;
+}
 
-  heartbeatDirtyX0 = 0;
-  heartbeatDirtyX1 = HEARTBEAT_W;
+uint32_t Display_blitIndexed(int16_t x, int16_t y, int16_t w, int16_t h,
+                             const uint8_t *pixels, int16_t stride,
+                             const uint16_t *palette, DisplayBlitCallback done,
+                             void *ctx) {
+  if (!tftReady)
+    return 0;
+  if (TftDma_ready() && w <= TFT_DMA_BUFFER_PIXELS)
+    return TftDma_blitIndexed(x, y, w, h, pixels, stride, palette, done, ctx);
+
+  // Expand a row at a time for the CPU path. A row never spans more than
+  // the panel, so clip to its width and `line` always holds it.
+  static uint16_t line[SCREEN_W];
+  if (x < 0) {
+    pixels -= x;
+    w += x;
+    x = 0;
+  }
+  if (x + w > SCREEN_W)
+    w = SCREEN_W - x;
+  if (w > 0 && h > 0) {
+    Adafruit_ILI9341 &panel = tft;
+    panel.startWrite();
+    panel.setAddrWindow(x, y, w, h);
+    for (int16_t row = 0; row < h; row++) {
+      const uint8_t *src = pixels + (int32_t)row * stride;
+      for (int16_t col = 0; col < w; col++)
+        line[col] = palette[src[col]];
+      panel.writePixels(line, w);
+    }
+    panel.endWrite();
+  }
+  if (done)
+    done(0, ctx);
+  return 0;
 }
 
+bool Display_blitDone(uint32_t fence) {
+  return fence == 0 || TftDma_done(fence);
+}
+
+void Display_waitBlit(uint32_t fence) {
+  if (fence != 0)
+    TftDma_wait(fence);
+}
+
+void Display_waitBlits() { TftDma_waitAll(); }
+
 static void drawRowLabel(int y, const char *label) {
   tft.setFont(&FreeSans12pt7b);
   tft.setTextColor(colAccent(), colBg());
@@ -755,6 +1081,7 @@ static void drawVarianceRow(int top, int height, float varianceScale) {
 }
 
 void Display_drawSettingsScreen(const DeviceSettings &s) {
+  frameEpoch++;
   tft.fillScreen(colBg());
 
   tft.setFont(&FreeSans12pt7b);
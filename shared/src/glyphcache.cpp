@@ -0,0 +1,255 @@
+#include "GlyphCache.h"
+#include "Log.h"
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint8_t GLYPH_SLOTS = 36; // '0'..'9', then 'A'..'Z'
+static const uint8_t MAX_ATLASES = 4;
+// Built-in font: 5x8 cells drawn from the top-left, 6 px apart.
+static const int CLASSIC_W = 5;
+static const int CLASSIC_H = 8;
+static const int CLASSIC_ADVANCE = 6;
+
+struct CachedGlyph {
+  uint16_t offset; // first mask byte
+  uint8_t width;
+  uint8_t height;
+  int8_t xOffset; // ink box from the cursor
+  int8_t yOffset;
+};
+
+struct GlyphAtlas {
+  const GFXfont *font;
+  uint8_t *masks; // rows of (width + 7) / 8 bytes, MSB leftmost
+  CachedGlyph glyphs[GLYPH_SLOTS];
+};
+
+static GlyphAtlas atlases[MAX_ATLASES];
+static uint8_t atlasCount = 0;
+
+static int slotFor(unsigned char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'A' && c <= 'Z')
+    return 10 + (c - 'A');
+  return -1;
+}
+
+static char charForSlot(int slot) {
+  return slot < 10 ? (char)('0' + slot) : (char)('A' + slot - 10);
+}
+
+static const GlyphAtlas *findAtlas(const GFXfont *font) {
+  for (uint8_t i = 0; i < atlasCount; i++) {
+    if (atlases[i].font == font)
+      return atlases[i].masks ? &atlases[i] : nullptr;
+  }
+  return nullptr;
+}
+
+static const GFXglyph *fontGlyph(const GFXfont *font, unsigned char c) {
+  if (c < font->first || c > font->last)
+    return nullptr;
+  return &font->glyph[c - font->first];
+}
+
+// Ink box of `c` relative to the cursor; false when it has none.
+static bool inkBox(const GFXfont *font, unsigned char c, int &x, int &y,
+                   int &w, int &h) {
+  if (!font) {
+    x = 0;
+    y = 0;
+    w = CLASSIC_W;
+    h = CLASSIC_H;
+    return true;
+  }
+  const GFXglyph *g = fontGlyph(font, c);
+  if (!g || g->width == 0 || g->height == 0)
+    return false;
+  x = g->xOffset;
+  y = g->yOffset;
+  w = g->width;
+  h = g->height;
+  return true;
+}
+
+static int advanceOf(const GFXfont *font, unsigned char c) {
+  if (!font)
+    return CLASSIC_ADVANCE;
+  const GFXglyph *g = fontGlyph(font, c);
+  return g ? g->xAdvance : 0;
+}
+
+bool GlyphCache_addFont(const GFXfont *font) {
+  if (findAtlas(font))
+    return true;
+  if (atlasCount >= MAX_ATLASES)
+    return false;
+
+  // Size the mask block and a scratch canvas that fits the largest glyph.
+  GlyphAtlas &atlas = atlases[atlasCount];
+  atlas.font = font;
+  atlas.masks = nullptr;
+  uint32_t bytes = 0;
+  int scratchW = 1;
+  int scratchH = 1;
+  for (int slot = 0; slot < GLYPH_SLOTS; slot++) {
+    CachedGlyph &g = atlas.glyphs[slot];
+    int x = 0, y = 0, w = 0, h = 0;
+    if (!inkBox(font, (unsigned char)charForSlot(slot), x, y, w, h))
+      w = h = 0;
+    g.offset = (uint16_t)bytes;
+    g.width = (uint8_t)w;
+    g.height = (uint8_t)h;
+    g.xOffset = (int8_t)x;
+    g.yOffset = (int8_t)y;
+    bytes += (uint32_t)((w + 7) / 8) * h;
+    scratchW = max(scratchW, w);
+    scratchH = max(scratchH, h);
+  }
+  if (bytes > 0xFFFF)
+    return false;
+
+  uint8_t *masks = (uint8_t *)calloc(bytes ? bytes : 1, 1);
+  GFXcanvas16 scratch((uint16_t)scratchW, (uint16_t)scratchH);
+  if (!masks || !scratch.getBuffer()) {
+    free(masks);
+    LOG_WARN("glyph cache alloc failed; using GFX text");
+    return false;
+  }
+
+  // Render each glyph with its ink box at the scratch origin and keep the
+  // lit pixels, so cached text matches Adafruit_GFX exactly.
+  scratch.setFont(font);
+  for (int slot = 0; slot < GLYPH_SLOTS; slot++) {
+    const CachedGlyph &g = atlas.glyphs[slot];
+    if (g.width == 0)
+      continue;
+    scratch.fillScreen(0);
+    scratch.drawChar(-g.xOffset, -g.yOffset, (unsigned char)charForSlot(slot),
+                     0xFFFF, 0xFFFF, 1);
+    int rowBytes = (g.width + 7) / 8;
+    uint8_t *row = masks + g.offset;
+    for (int y = 0; y < g.height; y++, row += rowBytes) {
+      for (int x = 0; x < g.width; x++) {
+        if (scratch.getBuffer()[y * scratchW + x])
+          row[x >> 3] |= (uint8_t)(0x80 >> (x & 7));
+      }
+    }
+  }
+  atlas.masks = masks;
+  atlasCount++;
+  return true;
+}
+
+void GlyphCache_textBounds(const GFXfont *font, const char *text, int16_t &x1,
+                           int16_t &y1, uint16_t &w, uint16_t &h) {
+  // Same accumulation as Adafruit_GFX::charBounds(): every glyph in the
+  // font's range widens the box, even one without ink.
+  int minX = INT16_MAX, minY = INT16_MAX, maxX = -1, maxY = -1;
+  int x = 0;
+  for (; *text; text++) {
+    unsigned char c = (unsigned char)*text;
+    int gx0, gy0, gx1, gy1;
+    if (!font) {
+      gx0 = x;
+      gy0 = 0;
+      gx1 = x + CLASSIC_ADVANCE - 1;
+      gy1 = CLASSIC_H - 1;
+    } else {
+      const GFXglyph *g = fontGlyph(font, c);
+      if (!g)
+        continue;
+      gx0 = x + g->xOffset;
+      gy0 = g->yOffset;
+      gx1 = gx0 + g->width - 1;
+      gy1 = gy0 + g->height - 1;
+    }
+    minX = min(minX, gx0);
+    minY = min(minY, gy0);
+    maxX = max(maxX, gx1);
+    maxY = max(maxY, gy1);
+    x += advanceOf(font, c);
+  }
+  x1 = 0;
+  y1 = 0;
+  w = h = 0;
+  if (maxX >= minX) {
+    x1 = (int16_t)minX;
+    w = (uint16_t)(maxX - minX + 1);
+  }
+  if (maxY >= minY) {
+    y1 = (int16_t)minY;
+    h = (uint16_t)(maxY - minY + 1);
+  }
+}
+
+template <typename Canvas, typename Pixel>
+static void blitGlyph(Canvas &canvas, const uint8_t *masks,
+                      const CachedGlyph &g, int x, int y, Pixel color) {
+  int gx = x + g.xOffset;
+  int gy = y + g.yOffset;
+  int canvasW = canvas.width();
+  int r0 = max(0, -gy);
+  int r1 = min((int)g.height, canvas.height() - gy);
+  int c0 = max(0, -gx);
+  int c1 = min((int)g.width, canvasW - gx);
+  if (r0 >= r1 || c0 >= c1)
+    return;
+  int rowBytes = (g.width + 7) / 8;
+  const uint8_t *bits = masks + g.offset + r0 * rowBytes;
+  Pixel *row = canvas.getBuffer() + (int32_t)(gy + r0) * canvasW + gx;
+  for (int r = r0; r < r1; r++, bits += rowBytes, row += canvasW) {
+    for (int b = c0 >> 3; b <= (c1 - 1) >> 3; b++) {
+      uint8_t m = bits[b];
+      if (!m)
+        continue;
+      int i1 = min(c1, b * 8 + 8);
+      for (int i = max(c0, b * 8); i < i1; i++) {
+        if (m & (0x80 >> (i & 7)))
+          row[i] = color;
+      }
+    }
+  }
+}
+
+template <typename Canvas, typename Pixel>
+static int16_t drawText(Canvas &canvas, const GFXfont *font, int16_t x,
+                        int16_t y, const char *text, Pixel color) {
+  // Direct writes assume an unrotated canvas with a buffer.
+  const GlyphAtlas *atlas = nullptr;
+  if (canvas.getRotation() == 0 && canvas.getBuffer())
+    atlas = findAtlas(font);
+  bool fontSelected = false;
+  for (; *text; text++) {
+    unsigned char c = (unsigned char)*text;
+    int slot = atlas ? slotFor(c) : -1;
+    if (slot >= 0) {
+      blitGlyph(canvas, atlas->masks, atlas->glyphs[slot], x, y, color);
+    } else {
+      int bx, by, bw, bh;
+      if (inkBox(font, c, bx, by, bw, bh)) {
+        if (!fontSelected) {
+          canvas.setFont(font);
+          fontSelected = true;
+        }
+        canvas.drawChar(x, y, c, color, color, 1);
+      }
+    }
+    x += advanceOf(font, c);
+  }
+  return x;
+}
+
+int16_t GlyphCache_drawText(GFXcanvas16 &canvas, const GFXfont *font,
+                            int16_t x, int16_t y, const char *text,
+                            uint16_t color) {
+  return drawText(canvas, font, x, y, text, color);
+}
+
+int16_t GlyphCache_drawText(GFXcanvas8 &canvas, const GFXfont *font,
+                            int16_t x, int16_t y, const char *text,
+                            uint8_t color) {
+  return drawText(canvas, font, x, y, text, color);
+}
@@ -0,0 +1,13 @@
+#include "Log.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+void Log_printf(const char *fmt, ...) {
+  char line[LOG_LINE_MAX];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  Serial.println(line);
+}
@@ -0,0 +1,160 @@
+#include "LoopProfiler.h"
+#include "Display.h"
+#include "SDManager.h"
+#include "TouchUI.h"
+
+static const uint8_t SUB_BITS = 2; // 4 buckets per power of two
+static const uint8_t LINEAR_BITS = 8; // cycles below 256 share bucket 0
+static const uint8_t BUCKET_COUNT =
+    1 + (32 - LINEAR_BITS) * (1 << SUB_BITS);
+
+static const unsigned long OVERLAY_REFRESH_MS = 1000;
+static const unsigned long REPORT_INTERVAL_MS = 60000;
+
+struct StageHistogram {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+  uint32_t buckets[BUCKET_COUNT];
+};
+
+static StageHistogram stages[PROF_STAGE_COUNT];
+static bool overlayOn = true;
+static unsigned long lastOverlayMs = 0;
+static unsigned long lastReportMs = 0;
+
+static const char *const STAGE_NAMES[PROF_STAGE_COUNT] = {
+    "loop", "touch", "sensors", "dictionary", "logging", "heartbeat", "radar"};
+// Four-letter labels for the overlay.
+static const char *const STAGE_LABELS[PROF_STAGE_COUNT] = {
+    "LOOP", "TUCH", "SENS", "DICT", "LOG", "HEAR", "RADR"};
+
+static uint8_t bucketFor(uint32_t cycles) {
+  if (cycles < (1UL << LINEAR_BITS))
+    return 0;
+  uint8_t msb = 31 - __builtin_clz(cycles);
+  uint8_t sub = (cycles >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+  return 1 + (msb - LINEAR_BITS) * (1 << SUB_BITS) + sub;
+}
+
+// Largest cycle count that falls into bucket i.
+static uint32_t bucketUpper(uint8_t i) {
+  if (i == 0)
+    return (1UL << LINEAR_BITS) - 1;
+  uint8_t msb = LINEAR_BITS + (i - 1) / (1 << SUB_BITS);
+  uint32_t sub = (i - 1) % (1 << SUB_BITS);
+  uint64_t next = (uint64_t)((1 << SUB_BITS) + sub + 1) << (msb - SUB_BITS);
+  return next > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)(next - 1);
+}
+
+static uint32_t cyclesToUs(uint64_t cycles) {
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  return (uint32_t)(cycles / (mhz ? mhz : 1));
+}
+
+void Profiler_record(ProfilerStage stage, uint32_t cycles) {
+  if (stage >= PROF_STAGE_COUNT)
+    return;
+  StageHistogram &h = stages[stage];
+  if (h.count == 0 || cycles < h.minCycles)
+    h.minCycles = cycles;
+  if (cycles > h.maxCycles)
+    h.maxCycles = cycles;
+  h.count++;
+  h.sumCycles += cycles;
+  h.buckets[bucketFor(cycles)]++;
+}
+
+void Profiler_getStats(ProfilerStage stage, ProfilerStats &out) {
+  out = ProfilerStats();
+  if (stage >= PROF_STAGE_COUNT)
+    return;
+  const StageHistogram &h = stages[stage];
+  if (h.count == 0)
+    return;
+  // Smallest bucket holding the 99th percentile sample.
+  uint32_t rank = h.count - h.count / 100;
+  uint32_t seen = 0;
+  uint32_t p99 = h.maxCycles;
+  for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+    seen += h.buckets[i];
+    if (seen >= rank) {
+      p99 = bucketUpper(i);
+      break;
+    }
+  }
+  if (p99 > h.maxCycles)
+    p99 = h.maxCycles;
+  out.count = h.count;
+  out.minUs = cyclesToUs(h.minCycles);
+  out.avgUs = cyclesToUs(h.sumCycles / h.count);
+  out.p99Us = cyclesToUs(p99);
+  out.maxUs = cyclesToUs(h.maxCycles);
+}
+
+void Profiler_reset() { memset(stages, 0, sizeof(stages)); }
+
+const char *Profiler_stageName(ProfilerStage stage) {
+  return stage < PROF_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+void Profiler_writeCsv(Print &out) {
+  out.println(F("stage,count,min_us,avg_us,p99_us,max_us"));
+  char line[64];
+  for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+    ProfilerStats st;
+    Profiler_getStats((ProfilerStage)i, st);
+    snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%lu",
+             STAGE_NAMES[i], (unsigned long)st.count,
+             (unsigned long)st.minUs, (unsigned long)st.avgUs,
+             (unsigned long)st.p99Us, (unsigned long)st.maxUs);
+    out.println(line);
+  }
+}
+
+void Profiler_setOverlay(bool on) { overlayOn = on; }
+
+void Profiler_drawOverlay() {
+  const int lineH = 10;
+  const int rows = PROF_STAGE_COUNT + 1;
+  const DisplayLayout &layout = Display_getLayout();
+  int areaW = layout.moduleRightW - 8;
+  int areaH = rows * lineH + 4;
+  int areaX = layout.mainX + layout.mainW - layout.moduleRightW + 4;
+  int areaY = layout.mainY + layout.mainH - areaH - 4;
+
+  Adafruit_ILI9341 &tft = Display_tft();
+  uint16_t bg = Display_dimColor(0x0000);
+  tft.fillRect(areaX, areaY, areaW, areaH, bg);
+  tft.setFont();
+  tft.setTextColor(Display_dimColor(0x8410), bg);
+  tft.setCursor(areaX + 2, areaY + 2);
+  tft.print("STG  AVG  P99");
+  tft.setTextColor(Display_dimColor(0xC618), bg);
+  char line[24];
+  for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++) {
+    ProfilerStats st;
+    Profiler_getStats((ProfilerStage)i, st);
+    snprintf(line, sizeof(line), "%-4s%5lu%5lu", STAGE_LABELS[i],
+             (unsigned long)(st.avgUs > 99999 ? 99999 : st.avgUs),
+             (unsigned long)(st.p99Us > 99999 ? 99999 : st.p99Us));
+    tft.setCursor(areaX + 2, areaY + 2 + (i + 1) * lineH);
+    tft.print(line);
+  }
+}
+
+void Profiler_update() {
+  unsigned long now = millis();
+  if (overlayOn && TouchUI_getMode() == UI_MODE_MAIN &&
+      now - lastOverlayMs >= OVERLAY_REFRESH_MS) {
+    lastOverlayMs = now;
+    Profiler_drawOverlay();
+  }
+  if (now - lastReportMs >= REPORT_INTERVAL_MS) {
+    lastReportMs = now;
+    Profiler_writeCsv(Serial);
+    SDManager::saveLoopProfile();
+    Profiler_reset();
+  }
+}
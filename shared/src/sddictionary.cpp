@@ -0,0 +1,196 @@
+#include "SdDictionary.h"
+#include "DictImage.h"
+#include "SDManager.h"
+#include "SuffixDict.h"
+#include "config_core.h"
+#include <SD.h>
+
+static const size_t SD_DICT_PATH_LEN = 64;
+static const uint8_t BLOCK_CACHE_SLOTS = 8; // 4 KB of 512-byte blocks
+
+struct SdDictEntry {
+  char name[SUFFIX_DICT_NAME_LEN];
+  char path[SD_DICT_PATH_LEN];
+};
+
+struct BlockCacheSlot {
+  uint32_t block;
+  uint32_t lastUse;
+  bool valid;
+  char data[SUFFIX_DICT_BLOCK_SIZE];
+};
+
+static SdDictEntry sdDicts[SD_DICT_MAX];
+static uint8_t sdDictCount = 0;
+
+static File dictFile;
+static SuffixDictHeader dictHeader;
+static uint8_t *dictKeys = nullptr;
+static SuffixDict activeDict = SuffixDict();
+
+static BlockCacheSlot blockCache[BLOCK_CACHE_SLOTS];
+static uint32_t cacheClock = 0;
+static uint32_t cacheHits = 0;
+static uint32_t cacheMisses = 0;
+
+static bool hasSuffix(const char *name, const char *suffix) {
+  size_t n = strlen(name);
+  size_t s = strlen(suffix);
+  return n >= s && strcasecmp(name + n - s, suffix) == 0;
+}
+
+static bool readHeader(File &f, SuffixDictHeader &h) {
+  if (!f.seek(0))
+    return false;
+  if (f.read((uint8_t *)&h, sizeof(h)) != sizeof(h))
+    return false;
+  return SuffixDict_validHeader(h);
+}
+
+uint8_t SdDictionary_scan() {
+  sdDictCount = 0;
+  if (!SDManager::available())
+    return 0;
+
+  File dir = SD.open(SDManager::dictionaryDir());
+  if (!dir || !dir.isDirectory())
+    return 0;
+
+  File f = dir.openNextFile();
+  while (f && sdDictCount < SD_DICT_MAX) {
+    const char *name = f.name();
+    if (!f.isDirectory() && hasSuffix(name, ".sfx")) {
+      SuffixDictHeader h;
+      SdDictEntry &e = sdDicts[sdDictCount];
+      // Older cores return the full path from name(), newer the base name.
+      if (name[0] == '/')
+        snprintf(e.path, sizeof(e.path), "%s", name);
+      else
+        snprintf(e.path, sizeof(e.path), "%s/%s", SDManager::dictionaryDir(),
+                 name);
+      if (readHeader(f, h)) {
+        memcpy(e.name, h.name, sizeof(e.name));
+        sdDictCount++;
+      } else {
+        LOG_WARN("Skipping invalid SD dictionary: %s", e.path);
+      }
+    }
+    f.close();
+    f = dir.openNextFile();
+  }
+  dir.close();
+
+  LOG_INFO("SD dictionaries found: %u", (unsigned)sdDictCount);
+  return sdDictCount;
+}
+
+uint8_t SdDictionary_getCount() { return sdDictCount; }
+
+const char *SdDictionary_getName(uint8_t idx) {
+  if (idx >= sdDictCount)
+    return nullptr;
+  return sdDicts[idx].name;
+}
+
+static const char *readCachedBlock(uint32_t block, void *) {
+  cacheClock++;
+  BlockCacheSlot *victim = &blockCache[0];
+  for (uint8_t i = 0; i < BLOCK_CACHE_SLOTS; i++) {
+    BlockCacheSlot &slot = blockCache[i];
+    if (slot.valid && slot.block == block) {
+      slot.lastUse = cacheClock;
+      cacheHits++;
+      return slot.data;
+    }
+    if (!slot.valid || (victim->valid && slot.lastUse < victim->lastUse))
+      victim = &slot;
+  }
+
+  cacheMisses++;
+  uint32_t offset = dictHeader.blocksOffset + block * dictHeader.blockSize;
+  if (!dictFile.seek(offset) ||
+      dictFile.read((uint8_t *)victim->data, dictHeader.blockSize) !=
+          dictHeader.blockSize) {
+    victim->valid = false;
+    return nullptr;
+  }
+  victim->block = block;
+  victim->lastUse = cacheClock;
+  victim->valid = true;
+  return victim->data;
+}
+
+void SdDictionary_close() {
+  if (cacheHits + cacheMisses > 0) {
+    LOG_DEBUG("SD dictionary block cache: %lu hits, %lu misses",
+              (unsigned long)cacheHits, (unsigned long)cacheMisses);
+  }
+  if (dictFile)
+    dictFile.close();
+  if (dictKeys) {
+    free(dictKeys);
+    dictKeys = nullptr;
+  }
+  activeDict = SuffixDict();
+  for (uint8_t i = 0; i < BLOCK_CACHE_SLOTS; i++)
+    blockCache[i].valid = false;
+  cacheHits = cacheMisses = 0;
+}
+
+bool SdDictionary_open(uint8_t idx) {
+  SdDictionary_close();
+  if (idx >= sdDictCount || !SDManager::available())
+    return false;
+
+  const char *path = sdDicts[idx].path;
+  dictFile = SD.open(path, FILE_READ);
+  if (!dictFile || !readHeader(dictFile, dictHeader)) {
+    LOG_ERROR("Failed to open SD dictionary: %s", path);
+    SdDictionary_close();
+    return false;
+  }
+
+  // Keys, then the last-letter masks if the file has them; the CRC covers
+  // both. keyBytes is a multiple of 8, so the masks stay aligned.
+  size_t keyBytes = (size_t)dictHeader.blockCount * dictHeader.keyLen;
+  size_t maskBytes = dictHeader.letterMaskOffset
+                         ? SUFFIX_DICT_LETTERS * sizeof(uint32_t)
+                         : 0;
+  dictKeys = (uint8_t *)malloc(keyBytes + maskBytes);
+  if (!dictKeys || !dictFile.seek(dictHeader.indexOffset) ||
+      dictFile.read(dictKeys, keyBytes) != keyBytes ||
+      (maskBytes && (!dictFile.seek(dictHeader.letterMaskOffset) ||
+                     dictFile.read(dictKeys + keyBytes, maskBytes) !=
+                         maskBytes)) ||
+      DictImage_crc32(dictKeys, keyBytes + maskBytes) !=
+          dictHeader.indexCrc) {
+    LOG_ERROR("Invalid SD dictionary index: %s", path);
+    SdDictionary_close();
+    return false;
+  }
+
+  activeDict.keys = dictKeys;
+  activeDict.blockCount = dictHeader.blockCount;
+  activeDict.blockSize = dictHeader.blockSize;
+  activeDict.lengthMask = dictHeader.lengthMask;
+  activeDict.letterMasks =
+      maskBytes ? (const uint32_t *)(dictKeys + keyBytes) : nullptr;
+  activeDict.maxWordLength = dictHeader.maxWordLength;
+  activeDict.readBlock = readCachedBlock;
+  activeDict.ctx = nullptr;
+
+  LOG_INFO("Streaming SD dictionary %s: %lu words, %lu bytes index in RAM",
+           path, (unsigned long)dictHeader.wordCount,
+           (unsigned long)(keyBytes + maskBytes));
+  return true;
+}
+
+bool SdDictionary_isOpen() { return activeDict.keys != nullptr; }
+
+uint8_t SdDictionary_suffixLengths(const char *letters, int count,
+                                   uint8_t *lengths, uint8_t maxLengths) {
+  if (!SdDictionary_isOpen())
+    return 0;
+  return SuffixDict_suffixLengths(activeDict, letters, count, lengths,
+                                  maxLengths);
+}
@@ -0,0 +1,111 @@
+#include "SensorPipeline.h"
+#include "SensorScore.h"
+#include "SlidingStats.h"
+#include "config_core.h"
+#include <math.h>
+
+static const float ACCEL_SCALE = 9.80665f / IMU_ACCEL_LSB_PER_G; // m/s^2
+static const float GYRO_SCALE =
+    (3.14159265f / 180.0f) / IMU_GYRO_LSB_PER_DPS; // rad/s
+
+// Entropy windows
+static float accelMagWindow[ENTROPY_WINDOW_MAX];
+static float gyroMagWindow[ENTROPY_WINDOW_MAX];
+static SlidingStats accelMagStats;
+static SlidingStats gyroMagStats;
+// Mean magnitude of the IMU readings since the last step.
+static float motionAccelSum = 0.0f;
+static float motionGyroSum = 0.0f;
+static uint16_t motionCount = 0;
+static float lastAccelMag = 0.0f;
+static float lastGyroMag = 0.0f;
+
+// Letter generation
+static uint32_t sampleCounter = 0;
+static char currentCandidateLetter = 0;
+static int stableCount = 0;
+
+void SensorPipeline_begin(uint16_t imuRateHz) {
+  // The windows span ENTROPY_WINDOW_MS of whichever rate is in use.
+  uint32_t rateHz = imuRateHz ? imuRateHz : 1000UL / SAMPLE_PERIOD_MS;
+  uint32_t window = rateHz * ENTROPY_WINDOW_MS / 1000UL;
+  if (window < 2)
+    window = 2;
+  if (window > (uint32_t)ENTROPY_WINDOW_MAX)
+    window = ENTROPY_WINDOW_MAX;
+  SlidingStats_init(accelMagStats, accelMagWindow, (uint16_t)window);
+  SlidingStats_init(gyroMagStats, gyroMagWindow, (uint16_t)window);
+
+  motionAccelSum = motionGyroSum = 0.0f;
+  motionCount = 0;
+  lastAccelMag = lastGyroMag = 0.0f;
+  sampleCounter = 0;
+  currentCandidateLetter = 0;
+  stableCount = 0;
+}
+
+void SensorPipeline_addImu(const ImuSample &s) {
+#ifdef GHOST_FIXED_POINT_SCORE
+  // Integer magnitude of the raw counts, scaled once.
+  float accelMag =
+      SensorScore_magnitude(s.accel[0], s.accel[1], s.accel[2]) * ACCEL_SCALE;
+  float gyroMag =
+      SensorScore_magnitude(s.gyro[0], s.gyro[1], s.gyro[2]) * GYRO_SCALE;
+#else
+  float ax = s.accel[0] * ACCEL_SCALE;
+  float ay = s.accel[1] * ACCEL_SCALE;
+  float az = s.accel[2] * ACCEL_SCALE;
+  float gx = s.gyro[0] * GYRO_SCALE;
+  float gy = s.gyro[1] * GYRO_SCALE;
+  float gz = s.gyro[2] * GYRO_SCALE;
+  float accelMag = sqrtf(ax * ax + ay * ay + az * az);
+  float gyroMag = sqrtf(gx * gx + gy * gy + gz * gz);
+#endif
+  SlidingStats_add(accelMagStats, accelMag);
+  SlidingStats_add(gyroMagStats, gyroMag);
+  motionAccelSum += accelMag;
+  motionGyroSum += gyroMag;
+  motionCount++;
+}
+
+bool SensorPipeline_sample(const SensorSample &s, char &outLetter) {
+  sampleCounter++;
+
+  // Motion terms use the mean magnitude since the previous step.
+  if (motionCount > 0) {
+    lastAccelMag = motionAccelSum / motionCount;
+    lastGyroMag = motionGyroSum / motionCount;
+  }
+  motionAccelSum = motionGyroSum = 0.0f;
+  motionCount = 0;
+
+  SensorReadings r;
+  r.tempC = s.tempC;
+  r.humidity = s.humidity;
+  r.accelMag = lastAccelMag;
+  r.gyroMag = lastGyroMag;
+  r.accelVar = SlidingStats_variance(accelMagStats);
+  r.gyroVar = SlidingStats_variance(gyroMagStats);
+  r.hallRaw = s.hallRaw;
+  r.wifiStrongest = s.wifiStrongest;
+  r.wifiVariance = s.wifiVariance;
+  r.wifiCount = s.wifiCount;
+  r.varianceScale = s.varianceScale;
+  uint32_t t = s.timestampMs ^ (sampleCounter * 2654435761UL);
+  r.noise = (uint8_t)(t & 0xFF);
+  char letter = SensorScore_letter(r);
+
+  if (letter == currentCandidateLetter) {
+    stableCount++;
+  } else {
+    currentCandidateLetter = letter;
+    stableCount = 1;
+  }
+
+  if (stableCount >= STABLE_SAMPLES_REQUIRED) {
+    outLetter = currentCandidateLetter;
+    stableCount = 0;
+    return true;
+  }
+  return false;
+}
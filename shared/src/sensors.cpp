@@ -1,16 +1,33 @@
 #include "Sensors.h"
+#include "Log.h"
+#include "SensorPipeline.h"
+#include "SensorTrace.h"
 #include "Settings.h"
+#include "SpscRing.h"
 #include "WifiRadar.h" // for WiFi entropy
 #include "config_core.h"
 #include <Adafruit_MPU6050.h>
 #include <Adafruit_Sensor.h>
 #include <DHT.h>
 #include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <math.h>
 
+// Sampling runs on its own FreeRTOS task pinned to core 0 with a fixed
+// SAMPLE_PERIOD_MS cadence, so slow DHT/I2C reads never stall the UI loop.
+// Stable letters and the sensor values that produced them are handed to the
+// UI through a lock-free SPSC queue; Sensors_pollLetter() only dequeues.
+// Until the task is started, pollLetter() samples inline as before.
+// Scoring itself lives in SensorPipeline; this file only reads hardware and
+// can mirror every reading into a SensorTrace for replay on the host.
+
 // DHT
 static SensorPins sensorPins = {-1, DHT11, -1, -1};
 static DHT *dht = nullptr;
+// Latest reading, written by the sampling task; other tasks read it under
+// dhtMux through Sensors_getLastTempC()/Sensors_getLastHumidity().
+static portMUX_TYPE dhtMux = portMUX_INITIALIZER_UNLOCKED;
 static float lastTempC = 25.0f;
 static float lastHumidity = 50.0f;
 static unsigned long lastDhtReadMs = 0;
@@ -19,19 +36,67 @@ static const unsigned long DHT_READ_INTERVAL_MS = 2000;
 // MPU6050
 static Adafruit_MPU6050 mpu;
 static bool mpuReady = false;
-
-// Entropy windows
-static const int ENTROPY_WINDOW = 10;
-static float accelMagWindow[ENTROPY_WINDOW];
-static float gyroMagWindow[ENTROPY_WINDOW];
-static int entropyIndex = 0;
-static int entropyCount = 0;
+static ImuConfig imuConfig = {0, 21};
+static bool imuFifo = false;
+static uint16_t imuRateHz = 0;    // after the sample rate divisor
+static uint8_t imuDrainsPerSample = 1;
+
+// MPU6050 FIFO registers; the Adafruit driver does not expose the FIFO.
+static const uint8_t MPU_ADDR = 0x68;
+static const uint8_t MPU_REG_FIFO_EN = 0x23;
+static const uint8_t MPU_REG_ACCEL_XOUT_H = 0x3B; // accel, temp, gyro
+static const uint8_t MPU_REG_INT_STATUS = 0x3A;
+static const uint8_t MPU_REG_USER_CTRL = 0x6A;
+static const uint8_t MPU_REG_FIFO_COUNTH = 0x72;
+static const uint8_t MPU_REG_FIFO_R_W = 0x74;
+static const uint8_t MPU_FIFO_EN_ACCEL_GYRO = 0x78; // XG, YG, ZG, ACCEL
+static const uint8_t MPU_USER_CTRL_FIFO_EN = 0x40;
+static const uint8_t MPU_USER_CTRL_FIFO_RESET = 0x04;
+static const uint8_t MPU_INT_FIFO_OFLOW = 0x10;
+static const uint16_t MPU_FIFO_BYTES = 1024;
+static const uint8_t MPU_FIFO_SAMPLE_BYTES = 12; // accel xyz, gyro xyz
+// Drain before the FIFO is three quarters full.
+static const uint16_t MPU_FIFO_BUDGET =
+    MPU_FIFO_BYTES / MPU_FIFO_SAMPLE_BYTES * 3 / 4;
+// Whole samples per Wire read; the ESP32 Wire buffer holds 128 bytes.
+static const uint8_t MPU_BURST_BYTES = 10 * MPU_FIFO_SAMPLE_BYTES;
 
 // Letter generation
 static unsigned long lastSampleTime = 0;
-static uint32_t sampleCounter = 0;
-static char currentCandidateLetter = 0;
-static int stableCount = 0;
+
+// Sampling task -> UI queue
+struct SensorLetter {
+  char letter;
+  float tempC;
+  float humidity;
+  unsigned long sampleMs;
+};
+static const size_t LETTER_QUEUE_SIZE = 8;
+// Letters queued while the UI is not polling (settings screen) are stale.
+static const unsigned long LETTER_STALE_MS =
+    SAMPLE_PERIOD_MS * STABLE_SAMPLES_REQUIRED * 2;
+static SpscRing<SensorLetter, LETTER_QUEUE_SIZE> letterQueue;
+static float letterTempC = 25.0f; // reading of the last dequeued letter
+static float letterHumidity = 50.0f;
+
+static TaskHandle_t sensorTaskHandle = nullptr;
+static const UBaseType_t SENSOR_TASK_PRIORITY = 2; // above the WiFi scan
+static const uint32_t SENSOR_TASK_STACK_SIZE = 4096;
+static const BaseType_t SENSOR_TASK_CORE = 0;
+
+// Period jitter, written by the sampling task.
+static portMUX_TYPE timingMux = portMUX_INITIALIZER_UNLOCKED;
+static SensorTimingStats timingStats;
+static unsigned long lastSampleStartUs = 0;
+
+// Sensor trace: records encoded by the sampling task, written out by the UI.
+struct TraceSlot {
+  uint8_t bytes[SENSOR_TRACE_MAX_RECORD];
+};
+static const size_t TRACE_QUEUE_SIZE = 128; // ~0.5 s of 250 Hz IMU data
+static SpscRing<TraceSlot, TRACE_QUEUE_SIZE> traceQueue;
+static volatile bool traceEnabled = false;
+static bool traceHeaderPending = false;
 
 static float clampFloat(float x, float lo, float hi) {
   if (x < lo)
@@ -51,24 +116,10 @@ static float mapFloat(float x, float in_min, float in_max, float out_min,
   return v;
 }
 
-static float computeVariance(const float *arr, int n) {
-  if (n <= 1)
-    return 0.0f;
-  float sum = 0.0f;
-  for (int i = 0; i < n; i++)
-    sum += arr[i];
-  float mean = sum / n;
-  float var = 0.0f;
-  for (int i = 0; i < n; i++) {
-    float d = arr[i] - mean;
-    var += d * d;
-  }
-  var /= (n - 1);
-  return var;
-}
-
 void Sensors_configure(const SensorPins &pins) { sensorPins = pins; }
 
+void Sensors_configureImu(const ImuConfig &cfg) { imuConfig = cfg; }
+
 static void ensureDht() {
   if (!dht && sensorPins.dhtPin >= 0) {
     dht = new DHT(sensorPins.dhtPin, sensorPins.dhtType);
@@ -86,104 +137,182 @@ static void updateDhtIfNeeded() {
 
   float t = dht->readTemperature();
   float h = dht->readHumidity();
+  portENTER_CRITICAL(&dhtMux);
   if (!isnan(t))
     lastTempC = t;
   if (!isnan(h))
     lastHumidity = h;
+  portEXIT_CRITICAL(&dhtMux);
 }
 
-static void readMpuMagnitudes(float &accelMag, float &gyroMag) {
-  if (!mpuReady) {
-    accelMag = 0.0f;
-    gyroMag = 0.0f;
-    return;
+static void pushTrace(const TraceSlot &slot) {
+  if (!traceQueue.push(slot)) {
+    portENTER_CRITICAL(&timingMux);
+    timingStats.traceDropped++;
+    portEXIT_CRITICAL(&timingMux);
   }
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
+}
+
+static void feedImu(const ImuSample &s) {
+  SensorPipeline_addImu(s);
+  if (traceEnabled) {
+    TraceSlot slot;
+    SensorTrace_encodeImu(slot.bytes, s);
+    pushTrace(slot);
+  }
+}
 
-  accelMag = sqrt(a.acceleration.x * a.acceleration.x +
-                  a.acceleration.y * a.acceleration.y +
-                  a.acceleration.z * a.acceleration.z);
+static void writeMpuReg(uint8_t reg, uint8_t value) {
+  Wire.beginTransmission(MPU_ADDR);
+  Wire.write(reg);
+  Wire.write(value);
+  Wire.endTransmission();
+}
 
-  gyroMag =
-      sqrt(g.gyro.x * g.gyro.x + g.gyro.y * g.gyro.y + g.gyro.z * g.gyro.z);
+static uint8_t readMpuRegs(uint8_t reg, uint8_t *buf, uint8_t len) {
+  Wire.beginTransmission(MPU_ADDR);
+  Wire.write(reg);
+  if (Wire.endTransmission(false) != 0)
+    return 0;
+  uint8_t got = Wire.requestFrom(MPU_ADDR, len);
+  if (got > len)
+    got = len;
+  for (uint8_t i = 0; i < got; i++)
+    buf[i] = Wire.read();
+  return got;
 }
 
-static void updateEntropyWindows(float accelMag, float gyroMag,
-                                 float &accelEntropyNorm,
-                                 float &gyroEntropyNorm) {
-  accelMagWindow[entropyIndex] = accelMag;
-  gyroMagWindow[entropyIndex] = gyroMag;
-  entropyIndex = (entropyIndex + 1) % ENTROPY_WINDOW;
-  if (entropyCount < ENTROPY_WINDOW)
-    entropyCount++;
+static void resetMpuFifo() {
+  writeMpuReg(MPU_REG_USER_CTRL, MPU_USER_CTRL_FIFO_RESET);
+  writeMpuReg(MPU_REG_USER_CTRL, MPU_USER_CTRL_FIFO_EN);
+}
 
-  float accelVar = computeVariance(accelMagWindow, entropyCount);
-  float gyroVar = computeVariance(gyroMagWindow, entropyCount);
+static int16_t be16(const uint8_t *p) { return (int16_t)((p[0] << 8) | p[1]); }
 
-  accelEntropyNorm = mapFloat(accelVar, 0.0f, 5.0f, 0.0f, 1.0f, true);
-  gyroEntropyNorm = mapFloat(gyroVar, 0.0f, 5.0f, 0.0f, 1.0f, true);
+static void parseMpuSample(const uint8_t *accel, const uint8_t *gyro,
+                           ImuSample &s) {
+  for (int i = 0; i < 3; i++) {
+    s.accel[i] = be16(accel + 2 * i);
+    s.gyro[i] = be16(gyro + 2 * i);
+  }
 }
 
-static float computeCombinedScore() {
-  updateDhtIfNeeded();
+// One reading straight from the data registers (no FIFO).
+static bool readMpuSample() {
+  uint8_t regs[14];
+  if (readMpuRegs(MPU_REG_ACCEL_XOUT_H, regs, sizeof(regs)) != sizeof(regs))
+    return false;
+  ImuSample s;
+  parseMpuSample(regs, regs + 8, s); // skip the temperature word
+  feedImu(s);
+  portENTER_CRITICAL(&timingMux);
+  timingStats.imuSamples++;
+  portEXIT_CRITICAL(&timingMux);
+  return true;
+}
 
-  float tempNorm = mapFloat(lastTempC, 10.0f, 40.0f, 0.0f, 1.0f, true);
-  float humidNorm = mapFloat(lastHumidity, 20.0f, 90.0f, 0.0f, 1.0f, true);
+// Read every whole sample queued in the IMU FIFO: one status/count read, then
+// bursts of MPU_BURST_BYTES. Returns the number of samples fed to the windows.
+static uint16_t drainMpuFifo() {
+  uint8_t status = 0;
+  uint8_t countBytes[2];
+  if (readMpuRegs(MPU_REG_INT_STATUS, &status, 1) != 1 ||
+      readMpuRegs(MPU_REG_FIFO_COUNTH, countBytes, 2) != 2)
+    return 0;
 
-  float accelMag = 0.0f, gyroMag = 0.0f;
-  readMpuMagnitudes(accelMag, gyroMag);
+  if (status & MPU_INT_FIFO_OFLOW) {
+    // Sample boundaries are lost once the FIFO wraps; start over.
+    resetMpuFifo();
+    portENTER_CRITICAL(&timingMux);
+    timingStats.imuOverflows++;
+    portEXIT_CRITICAL(&timingMux);
+    return 0;
+  }
 
-  float accelNorm = mapFloat(accelMag, 0.0f, 20.0f, 0.0f, 1.0f, true);
-  float gyroNorm = mapFloat(gyroMag, 0.0f, 300.0f, 0.0f, 1.0f, true);
+  uint16_t pending = (uint16_t)((countBytes[0] << 8) | countBytes[1]);
+  pending -= pending % MPU_FIFO_SAMPLE_BYTES;
+  uint16_t samples = 0;
+  uint8_t burst[MPU_BURST_BYTES];
+  while (pending > 0) {
+    uint8_t want =
+        pending > MPU_BURST_BYTES ? MPU_BURST_BYTES : (uint8_t)pending;
+    uint8_t got = readMpuRegs(MPU_REG_FIFO_R_W, burst, want);
+    if (got != want)
+      break;
+    for (uint8_t off = 0; off < got; off += MPU_FIFO_SAMPLE_BYTES) {
+      ImuSample s;
+      parseMpuSample(burst + off, burst + off + 6, s);
+      feedImu(s);
+      samples++;
+    }
+    pending -= got;
+  }
 
-  float accelEntropyNorm = 0.0f;
-  float gyroEntropyNorm = 0.0f;
-  updateEntropyWindows(accelMag, gyroMag, accelEntropyNorm, gyroEntropyNorm);
+  portENTER_CRITICAL(&timingMux);
+  timingStats.imuSamples += samples;
+  portEXIT_CRITICAL(&timingMux);
+  return samples;
+}
 
-  int hallRaw = hallRead();
-  float hallNorm = mapFloat((float)hallRaw, -200.0f, 200.0f, 0.0f, 1.0f, true);
+// Everything except the IMU that one letter sample reads.
+static void readSample(SensorSample &s) {
+  s.timestampMs = millis();
+  updateDhtIfNeeded();
+  s.tempC = lastTempC;
+  s.humidity = lastHumidity;
+  s.hallRaw = (int16_t)hallRead();
 
   // WiFi entropy from radar module
   WifiEntropy we = WifiRadar_getEntropy();
-  float wifiStrengthNorm =
-      mapFloat((float)we.strongest, -100.0f, -30.0f, 0.0f, 1.0f, true);
-  float wifiVarNorm = mapFloat(we.variance, 0.0f, 400.0f, 0.0f, 1.0f, true);
-  float wifiCountNorm =
-      mapFloat((float)we.count, 0.0f, 10.0f, 0.0f, 1.0f, true);
-
-  // Variance scaling from settings: higher = more chaotic, lower = calmer.
-  float varianceScale = Settings_get().varianceScale;
-  accelEntropyNorm = clampFloat(accelEntropyNorm * varianceScale, 0.0f, 1.0f);
-  gyroEntropyNorm = clampFloat(gyroEntropyNorm * varianceScale, 0.0f, 1.0f);
-  wifiVarNorm = clampFloat(wifiVarNorm * varianceScale, 0.0f, 1.0f);
-
-  float score =
-      0.5f * tempNorm + 0.5f * humidNorm + 1.2f * accelNorm + 1.2f * gyroNorm +
-      1.0f * accelEntropyNorm + 1.0f * gyroEntropyNorm + 0.3f * hallNorm +
-      0.8f * wifiStrengthNorm + 0.7f * wifiVarNorm + 0.5f * wifiCountNorm;
-
-  float weightTotal =
-      0.5f + 0.5f + 1.2f + 1.2f + 1.0f + 1.0f + 0.3f + 0.8f + 0.7f + 0.5f;
-
-  score /= weightTotal;
-  return clampFloat(score, 0.0f, 1.0f);
+  s.wifiStrongest = (int16_t)we.strongest;
+  s.wifiVariance = we.variance;
+  s.wifiCount = (int16_t)we.count;
+
+  s.varianceScale = Settings_get().varianceScale;
 }
 
-static float addEntropy(float baseScore) {
-  uint32_t t = millis() ^ (sampleCounter * 2654435761UL);
-  float noise = (float)(t & 0xFF) / 255.0f;
-  float mixed = 0.8f * baseScore + 0.2f * noise;
-  return clampFloat(mixed, 0.0f, 1.0f);
+static mpu6050_bandwidth_t bandwidthFor(uint16_t hz) {
+  if (hz >= 260)
+    return MPU6050_BAND_260_HZ;
+  if (hz >= 184)
+    return MPU6050_BAND_184_HZ;
+  if (hz >= 94)
+    return MPU6050_BAND_94_HZ;
+  if (hz >= 44)
+    return MPU6050_BAND_44_HZ;
+  if (hz >= 21)
+    return MPU6050_BAND_21_HZ;
+  if (hz >= 10)
+    return MPU6050_BAND_10_HZ;
+  return MPU6050_BAND_5_HZ;
 }
 
-static char scoreToLetter(float score) {
-  int idx = (int)(score * 26.0f);
-  if (idx < 0)
-    idx = 0;
-  if (idx > 25)
-    idx = 25;
-  return (char)('A' + idx);
+static void startMpuFifo() {
+  // The gyro output rate is 8 kHz with the low-pass filter off, else 1 kHz.
+  uint32_t baseHz = imuConfig.bandwidthHz >= 260 ? 8000 : 1000;
+  uint32_t divisor = baseHz / imuConfig.sampleRateHz;
+  if (divisor < 1)
+    divisor = 1;
+  if (divisor > 256)
+    divisor = 256;
+  mpu.setSampleRateDivisor((uint8_t)(divisor - 1));
+  imuRateHz = (uint16_t)(baseHz / divisor);
+
+  // Bursts of hundreds of bytes per letter: use 400 kHz fast mode.
+  Wire.setClock(400000);
+  writeMpuReg(MPU_REG_FIFO_EN, MPU_FIFO_EN_ACCEL_GYRO);
+  resetMpuFifo();
+  imuFifo = true;
+
+  // Drain often enough that the FIFO never fills between polls.
+  uint32_t perSample = imuRateHz * SAMPLE_PERIOD_MS / 1000UL;
+  imuDrainsPerSample = (uint8_t)((perSample + MPU_FIFO_BUDGET - 1) /
+                                 MPU_FIFO_BUDGET);
+  if (imuDrainsPerSample < 1)
+    imuDrainsPerSample = 1;
+
+  LOG_INFO("MPU6050 FIFO at %u Hz, %u drain(s) per sample",
+           (unsigned)imuRateHz, (unsigned)imuDrainsPerSample);
 }
 
 void Sensors_begin() {
@@ -199,54 +328,163 @@ void Sensors_begin() {
   }
 
   if (!mpu.begin()) {
-    Serial.println("MPU6050 not found; continuing without IMU data.");
+    LOG_WARN("MPU6050 not found; continuing without IMU data.");
     mpuReady = false;
   } else {
     mpuReady = true;
-    Serial.println("MPU6050 found");
+    LOG_INFO("MPU6050 found");
     mpu.setAccelerometerRange(MPU6050_RANGE_8_G);
     mpu.setGyroRange(MPU6050_RANGE_500_DEG);
-    mpu.setFilterBandwidth(MPU6050_BAND_21_HZ);
+    mpu.setFilterBandwidth(bandwidthFor(imuConfig.bandwidthHz));
+    if (imuConfig.sampleRateHz > 0)
+      startMpuFifo();
   }
 
-  for (int i = 0; i < ENTROPY_WINDOW; i++) {
-    accelMagWindow[i] = 0.0f;
-    gyroMagWindow[i] = 0.0f;
-  }
+  SensorPipeline_begin(imuFifo ? imuRateHz : 0);
 
   lastSampleTime = millis();
 }
 
-bool Sensors_pollLetter(char &outLetter) {
-  unsigned long now = millis();
-  if (now - lastSampleTime < SAMPLE_PERIOD_MS) {
-    return false;
+// One SAMPLE_PERIOD_MS step: true when a letter has been stable long enough.
+static bool sampleLetter(char &outLetter) {
+  if (imuFifo)
+    drainMpuFifo();
+  else if (mpuReady)
+    readMpuSample();
+
+  SensorSample sample;
+  readSample(sample);
+  if (traceEnabled) {
+    TraceSlot slot;
+    SensorTrace_encodeSample(slot.bytes, sample);
+    pushTrace(slot);
   }
-  lastSampleTime = now;
-  sampleCounter++;
+  return SensorPipeline_sample(sample, outLetter);
+}
 
-  float score = computeCombinedScore();
-  score = addEntropy(score);
-  char letter = scoreToLetter(score);
+static void publishLetter(char letter) {
+  SensorLetter item = {letter, lastTempC, lastHumidity, millis()};
+  if (!letterQueue.push(item)) {
+    portENTER_CRITICAL(&timingMux);
+    timingStats.droppedLetters++;
+    portEXIT_CRITICAL(&timingMux);
+  }
+}
 
-  if (letter == currentCandidateLetter) {
-    stableCount++;
-  } else {
-    currentCandidateLetter = letter;
-    stableCount = 1;
+static void recordTiming(unsigned long startUs, unsigned long busyUs) {
+  static bool primed = false;
+  const unsigned long periodUs = SAMPLE_PERIOD_MS * 1000UL;
+
+  portENTER_CRITICAL(&timingMux);
+  if (primed) {
+    unsigned long actual = startUs - lastSampleStartUs;
+    unsigned long jitter =
+        actual > periodUs ? actual - periodUs : periodUs - actual;
+    timingStats.samples++;
+    timingStats.jitterSumUs += jitter;
+    if (jitter > timingStats.maxJitterUs)
+      timingStats.maxJitterUs = jitter;
+  }
+  if (busyUs > timingStats.maxSampleUs)
+    timingStats.maxSampleUs = busyUs;
+  if (busyUs > periodUs)
+    timingStats.overruns++;
+  portEXIT_CRITICAL(&timingMux);
+
+  lastSampleStartUs = startUs;
+  primed = true;
+}
+
+static void sensorTask(void *) {
+  const TickType_t period = pdMS_TO_TICKS(SAMPLE_PERIOD_MS);
+  // Fast IMU rates need extra FIFO drains between letter samples.
+  const TickType_t drainPeriod = period / imuDrainsPerSample;
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    unsigned long startUs = micros();
+    char letter;
+    if (sampleLetter(letter))
+      publishLetter(letter);
+    recordTiming(startUs, micros() - startUs);
+    // Absolute wake times: a slow DHT read does not shift later samples.
+    for (uint8_t i = 1; i < imuDrainsPerSample; i++) {
+      vTaskDelayUntil(&lastWake, drainPeriod);
+      drainMpuFifo();
+    }
+    vTaskDelayUntil(&lastWake,
+                    period - drainPeriod * (imuDrainsPerSample - 1));
   }
+}
 
-  if (stableCount >= STABLE_SAMPLES_REQUIRED) {
-    outLetter = currentCandidateLetter;
-    stableCount = 0;
+void Sensors_startTask() {
+  if (sensorTaskHandle != nullptr)
+    return;
+  xTaskCreatePinnedToCore(sensorTask, "sensorSample", SENSOR_TASK_STACK_SIZE,
+                          nullptr, SENSOR_TASK_PRIORITY, &sensorTaskHandle,
+                          SENSOR_TASK_CORE);
+}
+
+bool Sensors_pollLetter(char &outLetter) {
+  if (sensorTaskHandle == nullptr) {
+    // No sampling task: sample inline, through the same queue.
+    if (imuFifo)
+      drainMpuFifo();
+    unsigned long now = millis();
+    if (now - lastSampleTime >= SAMPLE_PERIOD_MS) {
+      lastSampleTime = now;
+      char letter;
+      if (sampleLetter(letter))
+        publishLetter(letter);
+    }
+  }
+
+  SensorLetter item;
+  unsigned long now = millis();
+  while (letterQueue.pop(item)) {
+    letterTempC = item.tempC;
+    letterHumidity = item.humidity;
+    if (now - item.sampleMs > LETTER_STALE_MS) {
+      portENTER_CRITICAL(&timingMux);
+      timingStats.staleLetters++;
+      portEXIT_CRITICAL(&timingMux);
+      continue;
+    }
+    outLetter = item.letter;
     return true;
   }
   return false;
 }
 
-float Sensors_getLastTempC() { return lastTempC; }
+float Sensors_getLastTempC() {
+  portENTER_CRITICAL(&dhtMux);
+  float t = lastTempC;
+  portEXIT_CRITICAL(&dhtMux);
+  return t;
+}
+
+float Sensors_getLastHumidity() {
+  portENTER_CRITICAL(&dhtMux);
+  float h = lastHumidity;
+  portEXIT_CRITICAL(&dhtMux);
+  return h;
+}
+
+void Sensors_getLetterReading(float &tempC, float &humidity) {
+  tempC = letterTempC;
+  humidity = letterHumidity;
+}
+
+void Sensors_getTimingStats(SensorTimingStats &out) {
+  portENTER_CRITICAL(&timingMux);
+  out = timingStats;
+  portEXIT_CRITICAL(&timingMux);
+}
 
-float Sensors_getLastHumidity() { return lastHumidity; }
+void Sensors_resetTimingStats() {
+  portENTER_CRITICAL(&timingMux);
+  timingStats = SensorTimingStats();
+  portEXIT_CRITICAL(&timingMux);
+}
 
 uint8_t Sensors_getBatteryPercent() {
   // Placeholder until a real battery ADC line is wired; assume full battery.
@@ -265,3 +503,36 @@ uint8_t Sensors_getWifiStrengthPercent() {
     pct = 100.0f;
   return (uint8_t)(pct + 0.5f);
 }
+
+void Sensors_setTraceRecording(bool on) {
+  if (on && !traceEnabled) {
+    traceQueue.clear();
+    traceHeaderPending = true;
+  }
+  traceEnabled = on;
+}
+
+bool Sensors_isTraceRecording() { return traceEnabled; }
+
+size_t Sensors_readTrace(uint8_t *dst, size_t maxBytes) {
+  size_t used = 0;
+  if (traceHeaderPending) {
+    if (maxBytes < SENSOR_TRACE_HEADER_BYTES)
+      return 0;
+    SensorTraceHeader h = {imuFifo ? imuRateHz : (uint16_t)0,
+                           (uint16_t)SAMPLE_PERIOD_MS};
+    used = SensorTrace_encodeHeader(dst, h);
+    traceHeaderPending = false;
+  }
+
+  while (!traceQueue.empty()) {
+    const TraceSlot &slot = traceQueue.at(0);
+    size_t len = SensorTrace_recordSize(slot.bytes[0]);
+    if (used + len > maxBytes)
+      break;
+    memcpy(dst + used, slot.bytes, len);
+    used += len;
+    traceQueue.drop(1);
+  }
+  return used;
+}
@@ -0,0 +1,209 @@
+#include "SensorScore.h"
+
+// Normalization ranges and weights, shared by both paths.
+static constexpr float TEMP_MIN = 10.0f, TEMP_MAX = 40.0f;
+static constexpr float HUMID_MIN = 20.0f, HUMID_MAX = 90.0f;
+static constexpr float ACCEL_MAX = 20.0f;
+static constexpr float GYRO_MAX = 300.0f;
+// Accel/gyro window variance over every FIFO sample. The tail is tighter
+// than with one reading per step (5.0 then); see trace_replay --motion.
+static constexpr float MOTION_VAR_MAX = 3.5f;
+static constexpr float HALL_MIN = -200.0f, HALL_MAX = 200.0f;
+static constexpr float WIFI_RSSI_MIN = -100.0f, WIFI_RSSI_MAX = -30.0f;
+static constexpr float WIFI_VAR_MAX = 400.0f;
+static constexpr float WIFI_COUNT_MAX = 10.0f;
+
+static constexpr float W_TEMP = 0.5f, W_HUMID = 0.5f;
+static constexpr float W_ACCEL = 1.2f, W_GYRO = 1.2f;
+static constexpr float W_ACCEL_VAR = 1.0f, W_GYRO_VAR = 1.0f;
+static constexpr float W_HALL = 0.3f;
+static constexpr float W_WIFI_RSSI = 0.8f, W_WIFI_VAR = 0.7f;
+static constexpr float W_WIFI_COUNT = 0.5f;
+static constexpr float W_TOTAL = W_TEMP + W_HUMID + W_ACCEL + W_GYRO +
+                                 W_ACCEL_VAR + W_GYRO_VAR + W_HALL +
+                                 W_WIFI_RSSI + W_WIFI_VAR + W_WIFI_COUNT;
+static constexpr float NOISE_MIX = 0.2f;
+
+// --- Float reference ---
+
+static float clampFloat(float x, float lo, float hi) {
+  if (x < lo)
+    return lo;
+  if (x > hi)
+    return hi;
+  return x;
+}
+
+static float norm(float x, float lo, float hi) {
+  return clampFloat((x - lo) / (hi - lo), 0.0f, 1.0f);
+}
+
+float SensorScore_float(const SensorReadings &r) {
+  float accelVarNorm = norm(r.accelVar, 0.0f, MOTION_VAR_MAX);
+  float gyroVarNorm = norm(r.gyroVar, 0.0f, MOTION_VAR_MAX);
+  float wifiVarNorm = norm(r.wifiVariance, 0.0f, WIFI_VAR_MAX);
+
+  // Variance scaling from settings: higher = more chaotic, lower = calmer.
+  accelVarNorm = clampFloat(accelVarNorm * r.varianceScale, 0.0f, 1.0f);
+  gyroVarNorm = clampFloat(gyroVarNorm * r.varianceScale, 0.0f, 1.0f);
+  wifiVarNorm = clampFloat(wifiVarNorm * r.varianceScale, 0.0f, 1.0f);
+
+  float score =
+      W_TEMP * norm(r.tempC, TEMP_MIN, TEMP_MAX) +
+      W_HUMID * norm(r.humidity, HUMID_MIN, HUMID_MAX) +
+      W_ACCEL * norm(r.accelMag, 0.0f, ACCEL_MAX) +
+      W_GYRO * norm(r.gyroMag, 0.0f, GYRO_MAX) + W_ACCEL_VAR * accelVarNorm +
+      W_GYRO_VAR * gyroVarNorm +
+      W_HALL * norm((float)r.hallRaw, HALL_MIN, HALL_MAX) +
+      W_WIFI_RSSI * norm((float)r.wifiStrongest, WIFI_RSSI_MIN, WIFI_RSSI_MAX) +
+      W_WIFI_VAR * wifiVarNorm +
+      W_WIFI_COUNT * norm((float)r.wifiCount, 0.0f, WIFI_COUNT_MAX);
+  score = clampFloat(score / W_TOTAL, 0.0f, 1.0f);
+
+  float noise = (float)r.noise / 255.0f;
+  return clampFloat((1.0f - NOISE_MIX) * score + NOISE_MIX * noise, 0.0f,
+                    1.0f);
+}
+
+char SensorScore_letterFromFloat(float score) {
+  int idx = (int)(score * 26.0f);
+  if (idx < 0)
+    idx = 0;
+  if (idx > 25)
+    idx = 25;
+  return (char)('A' + idx);
+}
+
+// --- Q16 fixed point ---
+
+// Inputs are converted to Q16 once. (x - lo) * recip >> 24 then gives a Q16
+// fraction of the range without a divide.
+static const int RECIP_SHIFT = 24;
+
+struct Range {
+  int32_t loQ16;
+  int32_t recip; // 2^24 / (hi - lo)
+};
+
+static constexpr int32_t toQ16(float x) {
+  return (int32_t)(x * 65536.0f + (x < 0 ? -0.5f : 0.5f));
+}
+
+static constexpr Range range(float lo, float hi) {
+  return Range{toQ16(lo), (int32_t)(16777216.0f / (hi - lo) + 0.5f)};
+}
+
+static constexpr int32_t weightQ16(float w) { return toQ16(w / W_TOTAL); }
+
+static const int32_t Q_TEMP = weightQ16(W_TEMP);
+static const int32_t Q_HUMID = weightQ16(W_HUMID);
+static const int32_t Q_ACCEL = weightQ16(W_ACCEL);
+static const int32_t Q_GYRO = weightQ16(W_GYRO);
+static const int32_t Q_ACCEL_VAR = weightQ16(W_ACCEL_VAR);
+static const int32_t Q_GYRO_VAR = weightQ16(W_GYRO_VAR);
+static const int32_t Q_HALL = weightQ16(W_HALL);
+static const int32_t Q_WIFI_RSSI = weightQ16(W_WIFI_RSSI);
+static const int32_t Q_WIFI_VAR = weightQ16(W_WIFI_VAR);
+static const int32_t Q_WIFI_COUNT = weightQ16(W_WIFI_COUNT);
+static const int32_t Q_KEEP = toQ16(1.0f - NOISE_MIX);
+static const int32_t Q_NOISE = toQ16(NOISE_MIX);
+
+static const Range R_TEMP = range(TEMP_MIN, TEMP_MAX);
+static const Range R_HUMID = range(HUMID_MIN, HUMID_MAX);
+static const Range R_ACCEL = range(0.0f, ACCEL_MAX);
+static const Range R_GYRO = range(0.0f, GYRO_MAX);
+static const Range R_MOTION_VAR = range(0.0f, MOTION_VAR_MAX);
+static const Range R_HALL = range(HALL_MIN, HALL_MAX);
+static const Range R_WIFI_RSSI = range(WIFI_RSSI_MIN, WIFI_RSSI_MAX);
+static const Range R_WIFI_VAR = range(0.0f, WIFI_VAR_MAX);
+static const Range R_WIFI_COUNT = range(0.0f, WIFI_COUNT_MAX);
+
+static int32_t clampQ16(int64_t x) {
+  if (x < 0)
+    return 0;
+  if (x > SENSOR_SCORE_ONE)
+    return SENSOR_SCORE_ONE;
+  return (int32_t)x;
+}
+
+// Float inputs outside +-32767 saturate; every range above is far smaller.
+static int32_t floatToQ16(float x) {
+  if (x >= 32767.0f)
+    return INT32_MAX;
+  if (x <= -32767.0f)
+    return INT32_MIN;
+  return (int32_t)(x * 65536.0f);
+}
+
+static int32_t normQ16(int32_t xQ16, const Range &rg) {
+  return clampQ16(((int64_t)xQ16 - rg.loQ16) * rg.recip >> RECIP_SHIFT);
+}
+
+static int32_t normIntQ16(int32_t x, const Range &rg) {
+  return normQ16(x * SENSOR_SCORE_ONE, rg);
+}
+
+int32_t SensorScore_q16(const SensorReadings &r) {
+  int32_t scaleQ16 = floatToQ16(r.varianceScale);
+  int32_t accelVarNorm = normQ16(floatToQ16(r.accelVar), R_MOTION_VAR);
+  int32_t gyroVarNorm = normQ16(floatToQ16(r.gyroVar), R_MOTION_VAR);
+  int32_t wifiVarNorm = normQ16(floatToQ16(r.wifiVariance), R_WIFI_VAR);
+  accelVarNorm = clampQ16((int64_t)accelVarNorm * scaleQ16 >> 16);
+  gyroVarNorm = clampQ16((int64_t)gyroVarNorm * scaleQ16 >> 16);
+  wifiVarNorm = clampQ16((int64_t)wifiVarNorm * scaleQ16 >> 16);
+
+  // Weights are pre-divided by their total, so the sum is already [0, 1].
+  int64_t sum =
+      (int64_t)Q_TEMP * normQ16(floatToQ16(r.tempC), R_TEMP) +
+      (int64_t)Q_HUMID * normQ16(floatToQ16(r.humidity), R_HUMID) +
+      (int64_t)Q_ACCEL * normQ16(floatToQ16(r.accelMag), R_ACCEL) +
+      (int64_t)Q_GYRO * normQ16(floatToQ16(r.gyroMag), R_GYRO) +
+      (int64_t)Q_ACCEL_VAR * accelVarNorm +
+      (int64_t)Q_GYRO_VAR * gyroVarNorm +
+      (int64_t)Q_HALL * normIntQ16(r.hallRaw, R_HALL) +
+      (int64_t)Q_WIFI_RSSI * normIntQ16(r.wifiStrongest, R_WIFI_RSSI) +
+      (int64_t)Q_WIFI_VAR * wifiVarNorm +
+      (int64_t)Q_WIFI_COUNT * normIntQ16(r.wifiCount, R_WIFI_COUNT);
+  int32_t score = clampQ16(sum >> 16);
+
+  // 0.8 * score + 0.2 * noise / 255; the divide by a constant is a multiply.
+  int32_t noiseQ16 = (int32_t)r.noise * SENSOR_SCORE_ONE / 255;
+  int64_t mixed = (int64_t)Q_KEEP * score + (int64_t)Q_NOISE * noiseQ16;
+  return clampQ16(mixed >> 16);
+}
+
+char SensorScore_letterFromQ16(int32_t score) {
+  int32_t idx = (int32_t)(((int64_t)score * 26) >> 16);
+  if (idx < 0)
+    idx = 0;
+  if (idx > 25)
+    idx = 25;
+  return (char)('A' + idx);
+}
+
+char SensorScore_letter(const SensorReadings &r) {
+#ifdef GHOST_FIXED_POINT_SCORE
+  return SensorScore_letterFromQ16(SensorScore_q16(r));
+#else
+  return SensorScore_letterFromFloat(SensorScore_float(r));
+#endif
+}
+
+uint32_t SensorScore_magnitude(int32_t x, int32_t y, int32_t z) {
+  uint32_t ax = (uint32_t)(x < 0 ? -x : x);
+  uint32_t ay = (uint32_t)(y < 0 ? -y : y);
+  uint32_t az = (uint32_t)(z < 0 ? -z : z);
+  // Sort so that a >= b >= c, with min/max rather than branches.
+  uint32_t hi = ax > ay ? ax : ay;
+  uint32_t lo = ax > ay ? ay : ax;
+  uint32_t a = hi > az ? hi : az;
+  uint32_t mid = hi > az ? az : hi;
+  uint32_t b = lo > mid ? lo : mid;
+  uint32_t c = lo > mid ? mid : lo;
+  // One plane fits vectors near an axis, the other those near a diagonal;
+  // the coefficients are in 64ths and were fitted for the least worst-case
+  // error (about 2.9%). Both sums stay below 108 * 32768 < 2^22.
+  uint32_t nearAxis = 63 * a + 19 * b + 2 * c;
+  uint32_t nearDiagonal = 47 * a + 42 * b + 19 * c;
+  return (nearAxis > nearDiagonal ? nearAxis : nearDiagonal) >> 6;
+}
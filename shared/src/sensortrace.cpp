@@ -0,0 +1,122 @@
+#include "SensorTrace.h"
+#include <string.h>
+
+static const uint8_t MAGIC[4] = {'G', 'R', 'T', 'R'};
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+  p = put16(p, (uint16_t)v);
+  return put16(p, (uint16_t)(v >> 16));
+}
+
+static uint8_t *putFloat(uint8_t *p, float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return put32(p, bits);
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+static float getFloat(const uint8_t *p) {
+  uint32_t bits = get32(p);
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+size_t SensorTrace_encodeHeader(uint8_t *dst, const SensorTraceHeader &h) {
+  memcpy(dst, MAGIC, sizeof(MAGIC));
+  uint8_t *p = dst + sizeof(MAGIC);
+  *p++ = SENSOR_TRACE_VERSION;
+  *p++ = 0; // reserved
+  p = put16(p, h.imuRateHz);
+  p = put16(p, h.samplePeriodMs);
+  p = put16(p, 0); // reserved
+  return (size_t)(p - dst);
+}
+
+bool SensorTrace_decodeHeader(const uint8_t *src, size_t len,
+                              SensorTraceHeader &h) {
+  if (len < SENSOR_TRACE_HEADER_BYTES ||
+      memcmp(src, MAGIC, sizeof(MAGIC)) != 0 ||
+      src[4] != SENSOR_TRACE_VERSION)
+    return false;
+  h.imuRateHz = get16(src + 6);
+  h.samplePeriodMs = get16(src + 8);
+  return true;
+}
+
+size_t SensorTrace_encodeImu(uint8_t *dst, const ImuSample &s) {
+  uint8_t *p = dst;
+  *p++ = SENSOR_TRACE_IMU;
+  for (int i = 0; i < 3; i++)
+    p = put16(p, (uint16_t)s.accel[i]);
+  for (int i = 0; i < 3; i++)
+    p = put16(p, (uint16_t)s.gyro[i]);
+  return (size_t)(p - dst);
+}
+
+size_t SensorTrace_encodeSample(uint8_t *dst, const SensorSample &s) {
+  uint8_t *p = dst;
+  *p++ = SENSOR_TRACE_SAMPLE;
+  p = put32(p, s.timestampMs);
+  p = putFloat(p, s.tempC);
+  p = putFloat(p, s.humidity);
+  p = put16(p, (uint16_t)s.hallRaw);
+  p = put16(p, (uint16_t)s.wifiStrongest);
+  p = putFloat(p, s.wifiVariance);
+  p = put16(p, (uint16_t)s.wifiCount);
+  p = putFloat(p, s.varianceScale);
+  return (size_t)(p - dst);
+}
+
+size_t SensorTrace_recordSize(uint8_t type) {
+  if (type == SENSOR_TRACE_IMU)
+    return SENSOR_TRACE_IMU_BYTES;
+  if (type == SENSOR_TRACE_SAMPLE)
+    return SENSOR_TRACE_SAMPLE_BYTES;
+  return 0;
+}
+
+size_t SensorTrace_decode(const uint8_t *src, size_t len,
+                          SensorTraceRecord &out) {
+  if (len == 0)
+    return 0;
+  out.type = src[0];
+  const uint8_t *p = src + 1;
+  if (out.type == SENSOR_TRACE_IMU) {
+    if (len < SENSOR_TRACE_IMU_BYTES)
+      return 0;
+    for (int i = 0; i < 3; i++)
+      out.imu.accel[i] = (int16_t)get16(p + 2 * i);
+    for (int i = 0; i < 3; i++)
+      out.imu.gyro[i] = (int16_t)get16(p + 6 + 2 * i);
+    return SENSOR_TRACE_IMU_BYTES;
+  }
+  if (out.type == SENSOR_TRACE_SAMPLE) {
+    if (len < SENSOR_TRACE_SAMPLE_BYTES)
+      return 0;
+    SensorSample &s = out.sample;
+    s.timestampMs = get32(p);
+    s.tempC = getFloat(p + 4);
+    s.humidity = getFloat(p + 8);
+    s.hallRaw = (int16_t)get16(p + 12);
+    s.wifiStrongest = (int16_t)get16(p + 14);
+    s.wifiVariance = getFloat(p + 16);
+    s.wifiCount = (int16_t)get16(p + 20);
+    s.varianceScale = getFloat(p + 22);
+    return SENSOR_TRACE_SAMPLE_BYTES;
+  }
+  return 0;
+}
@@ -0,0 +1,380 @@
+#include "SessionLog.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const uint8_t MAGIC[4] = {'G', 'R', 'S', 'L'};
+
+// Record tag: the SessionRecordType in the low bits, then flags.
+static const uint8_t BIN_TYPE_MASK = 0x07;
+static const uint8_t BIN_UNIX = 0x08;     // a unix time delta follows
+static const uint8_t BIN_TEMP_NAN = 0x10; // letter: no temperature reading
+static const uint8_t BIN_HUM_NAN = 0x20;  // letter: no humidity reading
+static const uint8_t BIN_WORD_TEXT = 0x10; // word: its text follows
+static const uint8_t BIN_WORD_TAGS = 0x20; // word: a tags byte follows
+static const uint8_t NO_DICT = 0xFF;
+static const int TIMING_FIELDS = 10;
+static_assert(SESSION_BIN_WORD_SLOTS == 256, "addWordId() hashes to 8 bits");
+
+const char *SessionLog_csvHeader() {
+  return "timestamp,source,type,value,extra\r\n";
+}
+
+size_t SessionLog_formatTimestamp(uint32_t unixTime, uint32_t ms, char *dst,
+                                  size_t size) {
+  time_t t = (time_t)unixTime;
+  struct tm tm;
+  int n;
+  if (unixTime > 0 && localtime_r(&t, &tm)) {
+    n = snprintf(dst, size, "%04d-%02d-%02dT%02d-%02d-%02d",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                 tm.tm_min, tm.tm_sec);
+  } else {
+    n = snprintf(dst, size, "0000-00-00T00-00-%lu",
+                 (unsigned long)(ms / 1000UL));
+  }
+  if (n < 0)
+    return 0;
+  return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+// Same text as Dictionary_formatSources(): the lists in `tags`, joined with
+// '+', or the active dictionary when the hit is untagged.
+static void formatSources(const SessionDictNames &dicts, uint8_t tags,
+                          uint8_t dict, char *dst, size_t size) {
+  if (tags == 0) {
+    const char *name = dict < dicts.count ? dicts.names[dict] : nullptr;
+    snprintf(dst, size, "%s", name ? name : "unknown");
+    return;
+  }
+  size_t used = 0;
+  dst[0] = '\0';
+  uint8_t lists = dicts.count < DICT_MAX_TAGS ? dicts.count : DICT_MAX_TAGS;
+  for (uint8_t i = 0; i < lists && used < size; i++) {
+    if (!(tags & (1 << i)))
+      continue;
+    int n = snprintf(dst + used, size - used, "%s%s", used ? "+" : "",
+                     dicts.names[i]);
+    if (n < 0)
+      break;
+    used += (size_t)n;
+  }
+}
+
+size_t SessionLog_formatCsv(const SessionRecord &r,
+                            const SessionDictNames &dicts, char *dst) {
+  if (r.type == SESSION_DICT)
+    return 0;
+  size_t n = SessionLog_formatTimestamp(r.unixTime, r.ms, dst, 32);
+  char *p = dst + n;
+  size_t room = SESSION_LINE_MAX - n - 2; // keep space for "\r\n"
+  int len = 0;
+  switch (r.type) {
+  case SESSION_LETTER:
+    len = snprintf(p, room, ",sensors,letter,%c,temp=%.1f;hum=%.1f",
+                   r.letter.letter, r.letter.tempC, r.letter.humidity);
+    break;
+  case SESSION_WORD: {
+    char sources[SESSION_NAME_MAX * 3];
+    formatSources(dicts, r.word.tags, r.word.dict, sources, sizeof(sources));
+    len = snprintf(p, room, ",dictionary,word,%s,dict=%s", r.word.word,
+                   sources);
+    break;
+  }
+  case SESSION_TIMING: {
+    const SensorTimingStats &st = r.timing;
+    uint32_t meanJitterUs =
+        st.samples ? (uint32_t)(st.jitterSumUs / st.samples) : 0;
+    len = snprintf(p, room,
+                   ",sensors,timing,samples=%lu;mean_jitter_us=%lu;"
+                   "max_jitter_us=%lu;max_sample_us=%lu;overruns=%lu;"
+                   "dropped=%lu;stale=%lu;imu_samples=%lu;imu_overflows=%lu;"
+                   "trace_dropped=%lu",
+                   (unsigned long)st.samples, (unsigned long)meanJitterUs,
+                   (unsigned long)st.maxJitterUs,
+                   (unsigned long)st.maxSampleUs, (unsigned long)st.overruns,
+                   (unsigned long)st.droppedLetters,
+                   (unsigned long)st.staleLetters,
+                   (unsigned long)st.imuSamples,
+                   (unsigned long)st.imuOverflows,
+                   (unsigned long)st.traceDropped);
+    break;
+  }
+  default:
+    len = snprintf(p, room, ",%.*s", (int)SESSION_TEXT_MAX, r.text);
+    break;
+  }
+  if (len < 0)
+    len = 0;
+  if ((size_t)len >= room)
+    len = (int)room - 1;
+  p += len;
+  *p++ = '\r';
+  *p++ = '\n';
+  return (size_t)(p - dst);
+}
+
+// --- Binary format ---
+
+static uint8_t *putVarint(uint8_t *p, uint32_t v) {
+  while (v >= 0x80) {
+    *p++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+static uint8_t *putSigned(uint8_t *p, int32_t v) {
+  return putVarint(p, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static uint8_t *putText(uint8_t *p, const char *text, size_t maxLen) {
+  size_t len = strnlen(text, maxLen);
+  *p++ = (uint8_t)len;
+  memcpy(p, text, len);
+  return p + len;
+}
+
+// Bounds-checked cursor over one record.
+struct BinReader {
+  const uint8_t *p;
+  const uint8_t *end;
+  bool ok;
+
+  uint8_t byte() {
+    if (p >= end) {
+      ok = false;
+      return 0;
+    }
+    return *p++;
+  }
+  uint32_t varint() {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t b = byte();
+      v |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        return v;
+    }
+    ok = false;
+    return 0;
+  }
+  int32_t signedVarint() {
+    uint32_t v = varint();
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+  }
+  void text(char *dst, size_t size) {
+    size_t len = byte();
+    if (len >= size || (size_t)(end - p) < len) {
+      ok = false;
+      len = 0;
+    } else {
+      memcpy(dst, p, len);
+      p += len;
+    }
+    dst[len] = '\0';
+  }
+};
+
+static int32_t toTenths(float v) { return (int32_t)lroundf(v * 10.0f); }
+
+// Remember that `id`'s text is in the file. False if it already was, or if
+// the table is full and the text has to be repeated.
+static bool addWordId(SessionBinState &s, uint32_t id) {
+  uint32_t key = id + 1;
+  uint32_t slot = (uint32_t)(key * 2654435761UL) >> 24; // 256 slots
+  for (size_t i = 0; i < SESSION_BIN_WORD_SLOTS; i++) {
+    uint32_t &w = s.words[(slot + i) % SESSION_BIN_WORD_SLOTS];
+    if (w == key)
+      return false;
+    if (w == 0) {
+      if (s.wordCount >= SESSION_BIN_WORD_SLOTS * 3 / 4)
+        return true;
+      w = key;
+      s.wordCount++;
+      return true;
+    }
+  }
+  return true;
+}
+
+void SessionLog_resetBinary(SessionBinState &s) {
+  memset(&s, 0, sizeof(s));
+  s.dict = NO_DICT;
+}
+
+size_t SessionLog_encodeBinaryHeader(uint8_t *dst,
+                                     const SessionDictNames &dicts) {
+  uint8_t count = dicts.count < SESSION_DICTS_MAX ? dicts.count
+                                                  : (uint8_t)SESSION_DICTS_MAX;
+  memcpy(dst, MAGIC, sizeof(MAGIC));
+  uint8_t *p = dst + sizeof(MAGIC);
+  *p++ = SESSION_BIN_VERSION;
+  *p++ = count;
+  *p++ = 0; // reserved
+  *p++ = 0;
+  for (uint8_t i = 0; i < count; i++)
+    p = putText(p, dicts.names[i] ? dicts.names[i] : "", SESSION_NAME_MAX);
+  return (size_t)(p - dst);
+}
+
+size_t SessionLog_decodeBinaryHeader(const uint8_t *src, size_t len,
+                                     char storage[][SESSION_NAME_MAX + 1],
+                                     SessionDictNames &dicts) {
+  if (len < SESSION_BIN_HEADER_BYTES ||
+      memcmp(src, MAGIC, sizeof(MAGIC)) != 0 ||
+      src[4] != SESSION_BIN_VERSION || src[5] > SESSION_DICTS_MAX)
+    return 0;
+  BinReader in = {src + SESSION_BIN_HEADER_BYTES, src + len, true};
+  dicts.count = src[5];
+  for (uint8_t i = 0; i < dicts.count; i++) {
+    in.text(storage[i], SESSION_NAME_MAX + 1);
+    dicts.names[i] = storage[i];
+  }
+  return in.ok ? (size_t)(in.p - src) : 0;
+}
+
+size_t SessionLog_encodeBinary(const SessionRecord &r, SessionBinState &s,
+                               uint8_t *dst) {
+  uint8_t *p = dst;
+  if (r.type == SESSION_WORD && r.word.dict != s.dict) {
+    *p++ = SESSION_DICT;
+    p = putVarint(p, r.word.dict);
+    s.dict = r.word.dict;
+    memset(s.words, 0, sizeof(s.words));
+    s.wordCount = 0;
+  }
+
+  uint8_t *tag = p++;
+  *tag = r.type & BIN_TYPE_MASK;
+  p = putVarint(p, r.ms - s.ms);
+  if (r.unixTime != s.unixTime) {
+    *tag |= BIN_UNIX;
+    p = putSigned(p, (int32_t)(r.unixTime - s.unixTime));
+  }
+  s.ms = r.ms;
+  s.unixTime = r.unixTime;
+
+  switch (r.type) {
+  case SESSION_LETTER: {
+    const SessionLetter &l = r.letter;
+    *p++ = (uint8_t)l.letter;
+    if (isnan(l.tempC)) {
+      *tag |= BIN_TEMP_NAN;
+    } else {
+      int32_t t = toTenths(l.tempC);
+      p = putSigned(p, t - s.tempTenths);
+      s.tempTenths = t;
+    }
+    if (isnan(l.humidity)) {
+      *tag |= BIN_HUM_NAN;
+    } else {
+      int32_t h = toTenths(l.humidity);
+      p = putSigned(p, h - s.humTenths);
+      s.humTenths = h;
+    }
+    break;
+  }
+  case SESSION_WORD: {
+    const SessionWord &w = r.word;
+    bool hasId = w.id != DICT_NO_WORD;
+    p = putVarint(p, hasId ? w.id + 1 : 0);
+    if (!hasId || addWordId(s, w.id)) {
+      *tag |= BIN_WORD_TEXT;
+      p = putText(p, w.word, LETTER_BUFFER_SIZE);
+    }
+    if (w.tags) {
+      *tag |= BIN_WORD_TAGS;
+      *p++ = w.tags;
+    }
+    break;
+  }
+  case SESSION_TIMING: {
+    const SensorTimingStats &st = r.timing;
+    uint32_t meanJitterUs =
+        st.samples ? (uint32_t)(st.jitterSumUs / st.samples) : 0;
+    const uint32_t fields[TIMING_FIELDS] = {
+        st.samples,        meanJitterUs,    st.maxJitterUs,
+        st.maxSampleUs,    st.overruns,     st.droppedLetters,
+        st.staleLetters,   st.imuSamples,   st.imuOverflows,
+        st.traceDropped};
+    for (int i = 0; i < TIMING_FIELDS; i++)
+      p = putVarint(p, fields[i]);
+    break;
+  }
+  default:
+    p = putText(p, r.text, SESSION_TEXT_MAX - 1);
+    break;
+  }
+  return (size_t)(p - dst);
+}
+
+size_t SessionLog_decodeBinary(const uint8_t *src, size_t len,
+                               SessionBinState &s, SessionRecord &out) {
+  BinReader in = {src, src + len, true};
+  uint8_t tag = in.byte();
+  out.type = tag & BIN_TYPE_MASK;
+  if (out.type == SESSION_DICT) {
+    uint32_t dict = in.varint();
+    if (!in.ok || dict >= SESSION_DICTS_MAX)
+      return 0;
+    s.dict = out.dict = (uint8_t)dict;
+    return (size_t)(in.p - src);
+  }
+
+  s.ms += in.varint();
+  if (tag & BIN_UNIX)
+    s.unixTime += (uint32_t)in.signedVarint();
+  out.ms = s.ms;
+  out.unixTime = s.unixTime;
+
+  switch (out.type) {
+  case SESSION_LETTER: {
+    SessionLetter &l = out.letter;
+    l.letter = (char)in.byte();
+    if (!(tag & BIN_TEMP_NAN))
+      s.tempTenths += in.signedVarint();
+    if (!(tag & BIN_HUM_NAN))
+      s.humTenths += in.signedVarint();
+    l.tempC = (tag & BIN_TEMP_NAN) ? NAN : s.tempTenths / 10.0f;
+    l.humidity = (tag & BIN_HUM_NAN) ? NAN : s.humTenths / 10.0f;
+    break;
+  }
+  case SESSION_WORD: {
+    SessionWord &w = out.word;
+    uint32_t id = in.varint();
+    w.id = id ? id - 1 : DICT_NO_WORD;
+    w.word[0] = '\0';
+    if (tag & BIN_WORD_TEXT)
+      in.text(w.word, sizeof(w.word));
+    w.tags = (tag & BIN_WORD_TAGS) ? in.byte() : 0;
+    w.dict = s.dict;
+    break;
+  }
+  case SESSION_TIMING: {
+    uint32_t fields[TIMING_FIELDS];
+    for (int i = 0; i < TIMING_FIELDS; i++)
+      fields[i] = in.varint();
+    SensorTimingStats &st = out.timing;
+    st.samples = fields[0];
+    st.jitterSumUs = (uint64_t)fields[1] * fields[0];
+    st.maxJitterUs = fields[2];
+    st.maxSampleUs = fields[3];
+    st.overruns = fields[4];
+    st.droppedLetters = fields[5];
+    st.staleLetters = fields[6];
+    st.imuSamples = fields[7];
+    st.imuOverflows = fields[8];
+    st.traceDropped = fields[9];
+    break;
+  }
+  case SESSION_TEXT:
+    in.text(out.text, sizeof(out.text));
+    break;
+  default:
+    return 0;
+  }
+  return in.ok ? (size_t)(in.p - src) : 0;
+}
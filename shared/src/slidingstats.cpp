@@ -0,0 +1,67 @@
+#include "SlidingStats.h"
+
+void SlidingStats_init(SlidingStats &s, float *window, uint16_t capacity) {
+  s.window = window;
+  s.capacity = capacity;
+  SlidingStats_reset(s);
+}
+
+void SlidingStats_reset(SlidingStats &s) {
+  s.count = 0;
+  s.next = 0;
+  s.sinceResync = 0;
+  s.mean = 0.0;
+  s.m2 = 0.0;
+}
+
+static void resync(SlidingStats &s) {
+  double sum = 0.0;
+  for (uint16_t i = 0; i < s.count; i++)
+    sum += s.window[i];
+  double mean = sum / s.count;
+  double m2 = 0.0;
+  for (uint16_t i = 0; i < s.count; i++) {
+    double d = s.window[i] - mean;
+    m2 += d * d;
+  }
+  s.mean = mean;
+  s.m2 = m2;
+  s.sinceResync = 0;
+}
+
+void SlidingStats_add(SlidingStats &s, float x) {
+  if (s.capacity == 0)
+    return;
+
+  if (s.count < s.capacity) {
+    s.window[s.next] = x;
+    s.count++;
+    double delta = x - s.mean;
+    s.mean += delta / s.count;
+    s.m2 += delta * (x - s.mean);
+  } else {
+    // Replace the oldest value: remove and add in one step.
+    float old = s.window[s.next];
+    s.window[s.next] = x;
+    double oldMean = s.mean;
+    double delta = (double)x - old;
+    s.mean += delta / s.count;
+    s.m2 += delta * (x - s.mean + old - oldMean);
+    if (++s.sinceResync >= s.capacity)
+      resync(s);
+  }
+  if (s.m2 < 0.0)
+    s.m2 = 0.0;
+
+  s.next++;
+  if (s.next == s.capacity)
+    s.next = 0;
+}
+
+float SlidingStats_mean(const SlidingStats &s) { return (float)s.mean; }
+
+float SlidingStats_variance(const SlidingStats &s) {
+  if (s.count <= 1)
+    return 0.0f;
+  return (float)(s.m2 / (s.count - 1));
+}
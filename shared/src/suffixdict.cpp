@@ -0,0 +1,136 @@
+#include "SuffixDict.h"
+#include <string.h>
+
+static_assert(sizeof(SuffixDictHeader) == 64,
+              "SuffixDictHeader layout is part of the file format");
+
+static const int SUFFIX_MAX_WORD = 255;
+
+bool SuffixDict_validHeader(const SuffixDictHeader &h) {
+  return h.magic == SUFFIX_DICT_MAGIC &&
+         (h.version == 1 || h.version == SUFFIX_DICT_VERSION) &&
+         h.headerSize == sizeof(SuffixDictHeader) &&
+         h.blockSize == SUFFIX_DICT_BLOCK_SIZE &&
+         h.keyLen == SUFFIX_DICT_KEY_LEN && h.blockCount > 0 &&
+         h.name[SUFFIX_DICT_NAME_LEN - 1] == '\0';
+}
+
+// Last block whose key sorts strictly before the (zero-padded) key of p; the
+// word, if present, is in that block or shortly after it.
+static uint32_t findStartBlock(const SuffixDict &d, const char *p, int len) {
+  uint8_t key[SUFFIX_DICT_KEY_LEN];
+  memset(key, 0, sizeof(key));
+  memcpy(key, p, len < SUFFIX_DICT_KEY_LEN ? len : SUFFIX_DICT_KEY_LEN);
+
+  uint32_t lo = 0, hi = d.blockCount; // first block with key >= p in [lo, hi]
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (memcmp(d.keys + mid * SUFFIX_DICT_KEY_LEN, key, sizeof(key)) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo == 0 ? 0 : lo - 1;
+}
+
+// Compare a NUL-terminated stored word with p[0..len) bytewise.
+static int compareWord(const char *word, const char *p, int len) {
+  for (int i = 0; i < len; i++) {
+    uint8_t a = (uint8_t)word[i];
+    uint8_t b = (uint8_t)p[i];
+    if (a != b)
+      return a == 0 ? -1 : (a < b ? -1 : 1);
+  }
+  return word[len] == '\0' ? 0 : 1;
+}
+
+// 1 = found, 0 = absent, -1 = read error.
+static int containsWord(const SuffixDict &d, const char *p, int len) {
+  for (uint32_t b = findStartBlock(d, p, len); b < d.blockCount; b++) {
+    const char *block = d.readBlock(b, d.ctx);
+    if (!block)
+      return -1;
+    size_t pos = 0;
+    while (pos < d.blockSize && block[pos] != '\0') {
+      const char *word = block + pos;
+      int cmp = compareWord(word, p, len);
+      if (cmp == 0)
+        return 1;
+      if (cmp > 0)
+        return 0; // sorted: every later word is larger too
+      pos += strnlen(word, d.blockSize - pos) + 1;
+    }
+  }
+  return 0;
+}
+
+// Reverse the tail of letters into reversed; returns the longest length
+// worth probing.
+static int reverseTail(const SuffixDict &d, const char *letters, int count,
+                       char *reversed) {
+  int maxLen = count < d.maxWordLength ? count : d.maxWordLength;
+  if (maxLen > SUFFIX_MAX_WORD)
+    maxLen = SUFFIX_MAX_WORD;
+  for (int i = 0; i < maxLen; i++)
+    reversed[i] = letters[count - 1 - i];
+  return maxLen;
+}
+
+// Lengths of the words ending in `last`, as a lengthMask.
+static uint32_t lengthsEndingIn(const SuffixDict &d, char last) {
+  if (d.letterMasks && last >= 'A' && last <= 'Z')
+    return d.letterMasks[last - 'A'];
+  return d.lengthMask;
+}
+
+static bool lengthPresent(uint32_t mask, int len) {
+  return len > 32 || (mask & (1UL << (len - 1)));
+}
+
+bool SuffixDict_findSuffix(const SuffixDict &d, const char *letters, int count,
+                           char *out, size_t outSize) {
+  if (!d.keys || !d.readBlock || count <= 0)
+    return false;
+
+  char reversed[SUFFIX_MAX_WORD];
+  int maxLen = reverseTail(d, letters, count, reversed);
+  uint32_t mask = lengthsEndingIn(d, letters[count - 1]);
+  for (int len = 1; len <= maxLen; len++) {
+    if (!lengthPresent(mask, len))
+      continue;
+    int found = containsWord(d, reversed, len);
+    if (found < 0)
+      return false;
+    if (found == 0)
+      continue;
+    if ((size_t)len >= outSize)
+      return false;
+    for (int i = 0; i < len; i++)
+      out[i] = reversed[len - 1 - i];
+    out[len] = '\0';
+    return true;
+  }
+  return false;
+}
+
+uint8_t SuffixDict_suffixLengths(const SuffixDict &d, const char *letters,
+                                 int count, uint8_t *lengths,
+                                 uint8_t maxLengths) {
+  if (!d.keys || !d.readBlock || count <= 0)
+    return 0;
+
+  char reversed[SUFFIX_MAX_WORD];
+  int maxLen = reverseTail(d, letters, count, reversed);
+  uint32_t mask = lengthsEndingIn(d, letters[count - 1]);
+  uint8_t found = 0;
+  for (int len = 1; len <= maxLen && found < maxLengths; len++) {
+    if (!lengthPresent(mask, len))
+      continue;
+    int present = containsWord(d, reversed, len);
+    if (present < 0)
+      break;
+    if (present > 0)
+      lengths[found++] = (uint8_t)len;
+  }
+  return found;
+}
@@ -0,0 +1,284 @@
+#include "TftDma.h"
+#include "Log.h"
+#include "config_core.h"
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <driver/spi_master.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <string.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include <soc/spi_struct.h>
+#endif
+
+static const uint8_t ILI9341_CASET = 0x2A;
+static const uint8_t ILI9341_PASET = 0x2B;
+static const uint8_t ILI9341_RAMWR = 0x2C;
+
+static const spi_host_device_t TFT_DMA_HOST = VSPI_HOST;
+static const int TFT_DMA_CHANNEL = 1;
+static const uint8_t TRANS_PER_BAND = 6;
+static const uint8_t BAND_SLOTS = 2;
+
+// One staging buffer and the transactions that send it.
+struct BandSlot {
+  spi_transaction_t trans[TRANS_PER_BAND];
+  uint16_t *pixels; // big-endian RGB565, DMA-capable
+  uint8_t pending;  // transactions not yet retired
+  uint32_t fence;   // blit this band belongs to
+  bool last;        // last band of its blit
+  TftDmaCallback done;
+  void *ctx;
+};
+
+static spi_device_handle_t device = nullptr;
+static BandSlot slots[BAND_SLOTS];
+static uint8_t nextSlot = 0;
+static uint8_t bandsInFlight = 0;
+static uint32_t lastFence = 0;      // last fence handed out
+static uint32_t completedFence = 0; // every blit up to here is done
+static int csPin = -1;
+static int dcPin = -1;
+static TftDmaStats stats;
+
+// Transaction user field: slot index << 1 | DC level.
+static void *transUser(uint8_t slot, bool data) {
+  return (void *)(uintptr_t)((slot << 1) | (data ? 1 : 0));
+}
+
+static void IRAM_ATTR preTransfer(spi_transaction_t *t) {
+  gpio_set_level((gpio_num_t)dcPin, (int)((uintptr_t)t->user & 1));
+}
+
+static void beginBusUse() { digitalWrite(csPin, LOW); }
+
+static void endBusUse() {
+  digitalWrite(csPin, HIGH);
+#if defined(ARDUINO_ARCH_ESP32)
+  // The driver leaves the peripheral set up for TX-only transfers; the
+  // Arduino HAL (touch reads) expects MISO and full duplex.
+  SPI3.user.usr_miso = 1;
+  SPI3.user.doutdin = 1;
+#endif
+}
+
+// Retire one finished transaction; false if none finished within `wait`.
+static bool retireOne(TickType_t wait) {
+  spi_transaction_t *t = nullptr;
+  if (spi_device_get_trans_result(device, &t, wait) != ESP_OK || !t)
+    return false;
+  BandSlot &s = slots[(uintptr_t)t->user >> 1];
+  if (--s.pending > 0)
+    return true;
+  bandsInFlight--;
+  if (s.last) {
+    completedFence = s.fence;
+    if (s.done)
+      s.done(s.fence, s.ctx);
+  }
+  if (bandsInFlight == 0)
+    endBusUse();
+  return true;
+}
+
+static void retireFinished() {
+  while (bandsInFlight > 0 && retireOne(0)) {
+  }
+}
+
+// Block for the next transaction, accounting the stall.
+static void retireBlocking() {
+  unsigned long start = micros();
+  retireOne(portMAX_DELAY);
+  stats.waits++;
+  stats.waitUs += micros() - start;
+}
+
+static void setCommand(spi_transaction_t &t, uint8_t slot, uint8_t cmd) {
+  memset(&t, 0, sizeof(t));
+  t.length = 8;
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.tx_data[0] = cmd;
+  t.user = transUser(slot, false);
+}
+
+static void setRange(spi_transaction_t &t, uint8_t slot, uint16_t from,
+                     uint16_t to) {
+  memset(&t, 0, sizeof(t));
+  t.length = 32;
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.tx_data[0] = from >> 8;
+  t.tx_data[1] = from & 0xFF;
+  t.tx_data[2] = to >> 8;
+  t.tx_data[3] = to & 0xFF;
+  t.user = transUser(slot, true);
+}
+
+bool TftDma_begin(const TftDmaConfig &cfg) {
+  if (device)
+    return true;
+  if (cfg.cs < 0 || cfg.dc < 0 || cfg.sclk < 0 || cfg.mosi < 0)
+    return false;
+  for (uint8_t i = 0; i < BAND_SLOTS; i++) {
+    slots[i].pixels = (uint16_t *)heap_caps_malloc(
+        TFT_DMA_BUFFER_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA);
+    if (!slots[i].pixels) {
+      LOG_WARN("TFT DMA buffers unavailable; using CPU SPI");
+      for (uint8_t j = 0; j < i; j++) {
+        heap_caps_free(slots[j].pixels);
+        slots[j].pixels = nullptr;
+      }
+      return false;
+    }
+  }
+
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = cfg.mosi;
+  bus.miso_io_num = -1; // keep the Arduino HAL's MISO routing for touch
+  bus.sclk_io_num = cfg.sclk;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = TFT_DMA_BUFFER_PIXELS * sizeof(uint16_t);
+
+  spi_device_interface_config_t dev = {};
+  dev.clock_speed_hz = (int)cfg.freqHz;
+  dev.mode = 0;
+  dev.spics_io_num = -1; // CS stays under GPIO control, as Adafruit drives it
+  dev.queue_size = TRANS_PER_BAND * BAND_SLOTS;
+  dev.flags = SPI_DEVICE_NO_DUMMY;
+  dev.pre_cb = preTransfer;
+
+  if (spi_bus_initialize(TFT_DMA_HOST, &bus, TFT_DMA_CHANNEL) != ESP_OK ||
+      spi_bus_add_device(TFT_DMA_HOST, &dev, &device) != ESP_OK) {
+    LOG_WARN("TFT DMA init failed; using CPU SPI");
+    device = nullptr;
+    for (uint8_t i = 0; i < BAND_SLOTS; i++) {
+      heap_caps_free(slots[i].pixels);
+      slots[i].pixels = nullptr;
+    }
+    return false;
+  }
+  csPin = cfg.cs;
+  dcPin = cfg.dc;
+  LOG_INFO("TFT DMA ready");
+  return true;
+}
+
+bool TftDma_ready() { return device != nullptr; }
+
+// Stage one band: byte-swap into the buffer, as the panel takes RGB565 MSB
+// first, looking indexed pixels up in the palette on the way.
+static void stageBand(uint16_t *dst, const void *pixels, int32_t first,
+                      int16_t w, int16_t rows, int16_t stride,
+                      const uint16_t *palette) {
+  if (palette) {
+    const uint8_t *src = (const uint8_t *)pixels + first;
+    for (int16_t r = 0; r < rows; r++, src += stride) {
+      for (int16_t i = 0; i < w; i++) {
+        uint16_t c = palette[src[i]];
+        *dst++ = (uint16_t)((c >> 8) | (c << 8));
+      }
+    }
+    return;
+  }
+  const uint16_t *src = (const uint16_t *)pixels + first;
+  for (int16_t r = 0; r < rows; r++, src += stride) {
+    for (int16_t i = 0; i < w; i++) {
+      uint16_t c = src[i];
+      *dst++ = (uint16_t)((c >> 8) | (c << 8));
+    }
+  }
+}
+
+static uint32_t queueBlit(int16_t x, int16_t y, int16_t w, int16_t h,
+                          const void *pixels, int16_t stride,
+                          const uint16_t *palette, TftDmaCallback done,
+                          void *ctx) {
+  uint32_t fence = ++lastFence;
+  if (w <= 0 || h <= 0 || w > TFT_DMA_BUFFER_PIXELS) {
+    // Nothing to send; keep fences completing in order.
+    TftDma_waitAll();
+    completedFence = fence;
+    if (done)
+      done(fence, ctx);
+    return fence;
+  }
+
+  int16_t rowsPerBand = (int16_t)(TFT_DMA_BUFFER_PIXELS / w);
+  for (int16_t row = 0; row < h; row += rowsPerBand) {
+    int16_t bandH = h - row < rowsPerBand ? h - row : rowsPerBand;
+    uint8_t slot = nextSlot;
+    BandSlot &s = slots[slot];
+    while (s.pending > 0)
+      retireBlocking();
+
+    stageBand(s.pixels, pixels, (int32_t)row * stride, w, bandH, stride,
+              palette);
+
+    uint16_t y0 = (uint16_t)(y + row);
+    setCommand(s.trans[0], slot, ILI9341_CASET);
+    setRange(s.trans[1], slot, (uint16_t)x, (uint16_t)(x + w - 1));
+    setCommand(s.trans[2], slot, ILI9341_PASET);
+    setRange(s.trans[3], slot, y0, (uint16_t)(y0 + bandH - 1));
+    setCommand(s.trans[4], slot, ILI9341_RAMWR);
+    spi_transaction_t &px = s.trans[5];
+    memset(&px, 0, sizeof(px));
+    px.length = (size_t)w * bandH * 16;
+    px.tx_buffer = s.pixels;
+    px.user = transUser(slot, true);
+
+    s.pending = TRANS_PER_BAND;
+    s.fence = fence;
+    s.last = row + bandH >= h;
+    s.done = s.last ? done : nullptr;
+    s.ctx = ctx;
+    if (bandsInFlight++ == 0)
+      beginBusUse();
+    for (uint8_t i = 0; i < TRANS_PER_BAND; i++)
+      spi_device_queue_trans(device, &s.trans[i], portMAX_DELAY);
+    nextSlot = (nextSlot + 1) % BAND_SLOTS;
+  }
+  stats.blits++;
+  stats.bytes += (uint64_t)w * h * sizeof(uint16_t);
+  return fence;
+}
+
+uint32_t TftDma_blit(int16_t x, int16_t y, int16_t w, int16_t h,
+                     const uint16_t *pixels, int16_t stride,
+                     TftDmaCallback done, void *ctx) {
+  return queueBlit(x, y, w, h, pixels, stride, nullptr, done, ctx);
+}
+
+uint32_t TftDma_blitIndexed(int16_t x, int16_t y, int16_t w, int16_t h,
+                            const uint8_t *pixels, int16_t stride,
+                            const uint16_t *palette, TftDmaCallback done,
+                            void *ctx) {
+  return queueBlit(x, y, w, h, pixels, stride, palette, done, ctx);
+}
+
+bool TftDma_done(uint32_t fence) {
+  if (!device)
+    return true;
+  retireFinished();
+  return (int32_t)(completedFence - fence) >= 0;
+}
+
+void TftDma_wait(uint32_t fence) {
+  if (!device)
+    return;
+  retireFinished();
+  while ((int32_t)(completedFence - fence) < 0 && bandsInFlight > 0)
+    retireBlocking();
+}
+
+void TftDma_waitAll() {
+  if (!device)
+    return;
+  retireFinished();
+  while (bandsInFlight > 0)
+    retireBlocking();
+}
+
+void TftDma_getStats(TftDmaStats &out) { out = stats; }
+
+void TftDma_resetStats() { stats = TftDmaStats(); }
@@ -1,6 +1,7 @@
 #include "TouchUI.h"
 #include "Dictionary.h"
 #include "Display.h"
+#include "Log.h"
 #include "Settings.h"
 #include "WifiRadar.h"
 #include "config_core.h"
@@ -54,7 +55,7 @@ void TouchUI_begin() {
     ts = new XPT2046_Touchscreen(touchCsPin);
   }
   if (!ts) {
-    Serial.println(F("Touch not configured; skipping touch init"));
+    LOG_WARN("Touch not configured; skipping touch init");
     return;
   }
   ts->begin();
@@ -152,6 +153,8 @@ void TouchUI_update() {
   if (!ts)
     return;
 
+  // The touch controller shares the display's SPI bus.
+  Display_waitBlits();
   if (!ts->touched()) {
     // Reset swipe state when finger lifts.
     swipeActive = false;
@@ -188,15 +191,8 @@ void TouchUI_update() {
     return; // debounce
   lastTouchMs = now;
 
-  Serial.print("Touch: raw(");
-  Serial.print(p.x);
-  Serial.print(",");
-  Serial.print(p.y);
-  Serial.print(") -> screen(");
-  Serial.print(sx);
-  Serial.print(",");
-  Serial.print(sy);
-  Serial.println(")");
+  LOG_DEBUG("Touch: raw(%d,%d) -> screen(%d,%d)", (int)p.x, (int)p.y, (int)sx,
+            (int)sy);
 
   if (currentMode == UI_MODE_SETTINGS) {
     handleSettingsTouch(sx, sy);
@@ -1,7 +1,9 @@
 #include "WifiRadar.h"
 #include "Display.h"
+#include "GlyphCache.h"
 #include "Sensors.h"
 #include "Settings.h"
+#include "SlidingStats.h"
 #include "config_core.h"
 #include <Adafruit_GFX.h>
 #include <WiFi.h>
@@ -18,6 +20,8 @@ static const int WIFI_MAX_AP = 20;
 static int wifiApCount = 0;
 static int wifiRssiList[WIFI_MAX_AP];
 static int wifiChannelList[WIFI_MAX_AP];
+static float rssiWindow[WIFI_MAX_AP];
+static SlidingStats rssiStats; // RSSI spread of the latest scan
 
 static WifiEntropy wifiEnt = {-100, -100, 0.0f, 0};
 static unsigned long lastWifiScanMs = 0;
@@ -33,13 +37,32 @@ static const uint32_t WIFI_SCAN_TASK_STACK_SIZE = 4096;
 static const BaseType_t WIFI_SCAN_TASK_CORE = 0;
 static const TickType_t WIFI_SCAN_TASK_DELAY = pdMS_TO_TICKS(100);
 
-// Off-screen buffer for flicker-free radar drawing
-static GFXcanvas16 radarCanvas(RADAR_W, RADAR_H);
-static GFXcanvas16 radarStatic(RADAR_W, RADAR_H);
+// Off-screen buffer for flicker-free radar drawing. Pixels are indices into
+// radarColors, expanded to RGB565 as they are sent to the panel.
+static GFXcanvas8 radarCanvas(RADAR_W, RADAR_H);
+static GFXcanvas8 radarStatic(RADAR_W, RADAR_H);
 static bool radarStaticReady = false;
 static bool radarReady() { return radarCanvas.getBuffer() != nullptr; }
 static float sweepAngle = 0.0f; // radians, animated
 
+// Radar palette. The first entries are fixed colours at full brightness,
+// dimmed to the current brightness whenever the display palette changes; the
+// overlay word's entries follow its fade and are set every frame.
+enum RadarColor : uint8_t {
+  RADAR_COL_BG,
+  RADAR_COL_RING,  // rings, crosshair and weak APs
+  RADAR_COL_SWEEP, // sweep line and strong APs
+  RADAR_COL_TRAIL, // trail line and medium APs
+  RADAR_COL_TEXT,
+  RADAR_COL_WORD_SHADOW,
+  RADAR_COL_WORD,
+  RADAR_COL_COUNT
+};
+static const uint16_t RADAR_BASE_COLORS[RADAR_COL_WORD_SHADOW] = {
+    0x0000, 0x4208, 0xF800, 0x8000, 0xC618};
+static uint16_t radarColors[RADAR_COL_COUNT];
+static uint32_t radarPaletteEpoch = 0;
+
 // Cached data for continuous redraw even when no new scan arrives.
 static int cachedApCount = 0;
 static int cachedRssi[WIFI_MAX_AP];
@@ -68,21 +91,21 @@ static float mapFloat(float x, float in_min, float in_max, float out_min,
 
 enum class TextAlign { LEFT, CENTER, RIGHT };
 
-static void drawSmallText(GFXcanvas16 &gfx, const String &text, int anchorX,
-                          int anchorY, TextAlign align) {
+// Top-left corner and size of `text` in the small font, anchored inside the
+// canvas.
+static void layoutSmallText(GFXcanvas8 &gfx, const String &text, int anchorX,
+                            int anchorY, TextAlign align, int &textX,
+                            int &textY, uint16_t &w, uint16_t &h) {
   int16_t x1, y1;
-  uint16_t w, h;
-  gfx.setFont();
-  gfx.setTextSize(1);
-  gfx.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  GlyphCache_textBounds(nullptr, text.c_str(), x1, y1, w, h);
 
-  int textX = anchorX;
+  textX = anchorX;
   if (align == TextAlign::RIGHT)
     textX -= w;
   else if (align == TextAlign::CENTER)
     textX -= w / 2;
 
-  int textY = (anchorY > (gfx.height() / 2)) ? (anchorY - (int)h) : anchorY;
+  textY = (anchorY > (gfx.height() / 2)) ? (anchorY - (int)h) : anchorY;
 
   if (textX < 0)
     textX = 0;
@@ -90,17 +113,10 @@ static void drawSmallText(GFXcanvas16 &gfx, const String &text, int anchorX,
     textX = max(0, gfx.width() - (int)w);
   if (textY < 0)
     textY = 0;
-
-  gfx.setTextColor(Display_dimColor(0xC618));
-  gfx.setCursor(textX, textY);
-  gfx.print(text);
 }
 
-static void drawComplication(const ComplicationConfig &cfg, int anchorX,
-                             int anchorY, TextAlign align) {
-  if (cfg.type == ComplicationType::None)
-    return;
-
+// Text shown for a complication; empty when it is off.
+static String complicationText(const ComplicationConfig &cfg) {
   String value;
   switch (cfg.type) {
   case ComplicationType::TemperatureC:
@@ -117,20 +133,174 @@ static void drawComplication(const ComplicationConfig &cfg, int anchorX,
     break;
   case ComplicationType::None:
   default:
-    return;
+    return value;
   }
 
   if (cfg.label.length() > 0) {
     value = cfg.label + " " + value;
   }
+  return value;
+}
+
+// --- Dirty-region compositor ---
+//
+// A frame is described as a list of items: sweep and trail lines, AP dots,
+// complication text and the overlay word. Items that moved or changed look
+// since the frame on the panel mark their old and new areas dirty, and only
+// those areas are restored from radarStatic, redrawn and sent. Every item is
+// redrawn each frame, in the same order; outside the dirty areas that
+// rewrites identical pixels, so overlaps stay stacked correctly.
+
+enum RadarItemSlot {
+  ITEM_SWEEP,
+  ITEM_TRAIL,
+  ITEM_COMPLICATION, // four, in corner order
+  ITEM_OVERLAY = ITEM_COMPLICATION + 4,
+  ITEM_DOT, // one per AP
+  ITEM_COUNT = ITEM_DOT + WIFI_MAX_AP
+};
+
+struct RadarItem {
+  bool used;
+  bool line;              // x0,y0 -> x1,y1 line; else box [x0,x1) x [y0,y1)
+  int16_t x0, y0, x1, y1;
+  uint8_t color;  // RadarColor
+  uint32_t stamp; // text content hash; 0 for shapes
+};
+
+struct DirtyRect {
+  int16_t x0, y0, x1, y1; // half-open
+};
+
+static const uint8_t RADAR_MAX_DIRTY = 24;
+// Above this many dirty pixels one full-frame blit is cheaper.
+static const int32_t RADAR_FULL_FRAME_AREA = (int32_t)RADAR_W * RADAR_H / 2;
+// Merge two regions when the union wastes fewer pixels than a window costs.
+static const int32_t DIRTY_MERGE_SLACK = 32;
+// Lines are covered by boxes of at most this many pixels along their run.
+static const int LINE_SEGMENT_PX = 16;
+
+static RadarItem frameItems[ITEM_COUNT];
+static RadarItem shownItems[ITEM_COUNT]; // what the panel shows
+static String complicationValues[4];
+static bool radarShown = false; // shownItems describes the panel
+static uint32_t radarEpoch = 0;
+static DirtyRect dirtyRects[RADAR_MAX_DIRTY];
+static uint8_t dirtyCount = 0;
+static bool dirtyFull = false;
+
+static int32_t rectArea(const DirtyRect &r) {
+  return (int32_t)(r.x1 - r.x0) * (r.y1 - r.y0);
+}
+
+static void markDirty(int x0, int y0, int x1, int y1) {
+  if (dirtyFull)
+    return;
+  DirtyRect r = {(int16_t)max(x0, 0), (int16_t)max(y0, 0),
+                 (int16_t)min(x1, RADAR_W), (int16_t)min(y1, RADAR_H)};
+  if (r.x0 >= r.x1 || r.y0 >= r.y1)
+    return;
+  for (uint8_t i = 0; i < dirtyCount;) {
+    const DirtyRect &d = dirtyRects[i];
+    DirtyRect u = {min(d.x0, r.x0), min(d.y0, r.y0), max(d.x1, r.x1),
+                   max(d.y1, r.y1)};
+    if (rectArea(u) <= rectArea(d) + rectArea(r) + DIRTY_MERGE_SLACK) {
+      // Absorb it and start over: the grown region may now reach others.
+      r = u;
+      dirtyRects[i] = dirtyRects[--dirtyCount];
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+  if (dirtyCount == RADAR_MAX_DIRTY) {
+    dirtyFull = true;
+    return;
+  }
+  dirtyRects[dirtyCount++] = r;
+}
 
-  drawSmallText(radarCanvas, value, anchorX, anchorY, align);
+static void markItem(const RadarItem &it) {
+  if (!it.used)
+    return;
+  if (!it.line) {
+    markDirty(it.x0, it.y0, it.x1, it.y1);
+    return;
+  }
+  // A box per short run hugs a diagonal far closer than one box end to end.
+  // Pixels stray at most half a pixel from the ideal line; pad by one.
+  int dx = it.x1 - it.x0;
+  int dy = it.y1 - it.y0;
+  int steps = max(abs(dx), abs(dy)) / LINE_SEGMENT_PX + 1;
+  for (int i = 0; i < steps; i++) {
+    int ax = it.x0 + dx * i / steps;
+    int ay = it.y0 + dy * i / steps;
+    int bx = it.x0 + dx * (i + 1) / steps;
+    int by = it.y0 + dy * (i + 1) / steps;
+    markDirty(min(ax, bx) - 1, min(ay, by) - 1, max(ax, bx) + 2,
+              max(ay, by) + 2);
+  }
+}
+
+static bool sameItem(const RadarItem &a, const RadarItem &b) {
+  if (a.used != b.used)
+    return false;
+  if (!a.used)
+    return true;
+  return a.line == b.line && a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 &&
+         a.y1 == b.y1 && a.color == b.color && a.stamp == b.stamp;
+}
+
+static void setLineItem(RadarItem &it, int x0, int y0, int x1, int y1,
+                        uint8_t color) {
+  it.used = true;
+  it.line = true;
+  it.x0 = (int16_t)x0;
+  it.y0 = (int16_t)y0;
+  it.x1 = (int16_t)x1;
+  it.y1 = (int16_t)y1;
+  it.color = color;
+  it.stamp = 0;
+}
+
+static void setBoxItem(RadarItem &it, int x, int y, int w, int h,
+                       uint8_t color, uint32_t stamp) {
+  it.used = true;
+  it.line = false;
+  it.x0 = (int16_t)x;
+  it.y0 = (int16_t)y;
+  it.x1 = (int16_t)(x + w);
+  it.y1 = (int16_t)(y + h);
+  it.color = color;
+  it.stamp = stamp;
+}
+
+static uint32_t textStamp(const String &text) {
+  uint32_t h = 2166136261UL; // FNV-1a
+  for (unsigned int i = 0; i < text.length(); i++)
+    h = (h ^ (uint8_t)text[i]) * 16777619UL;
+  return h;
+}
+
+// Copy the static background back over every dirty region.
+static void restoreDirty() {
+  uint8_t *dst = radarCanvas.getBuffer();
+  const uint8_t *src = radarStatic.getBuffer();
+  for (uint8_t i = 0; i < dirtyCount; i++) {
+    const DirtyRect &r = dirtyRects[i];
+    size_t rowBytes = (size_t)(r.x1 - r.x0);
+    for (int y = r.y0; y < r.y1; y++) {
+      size_t at = (size_t)y * RADAR_W + r.x0;
+      memcpy(dst + at, src + at, rowBytes);
+    }
+  }
 }
 
 void WifiRadar_begin() {
   if (!wifiDataMutex) {
     wifiDataMutex = xSemaphoreCreateMutex();
   }
+  SlidingStats_init(rssiStats, rssiWindow, WIFI_MAX_AP);
   WiFi.mode(WIFI_STA);
   WiFi.disconnect(true);
   delay(100);
@@ -156,7 +326,9 @@ WifiEntropy WifiRadar_getEntropy() {
 void WifiRadar_update() {
   // Check if an async scan finished
   int scanStatus = WiFi.scanComplete();
-  if (scanStatus == WIFI_SCAN_FAILED) {
+  // WIFI_SCAN_FAILED is also what scanComplete() reports once results have
+  // been deleted; only a scan we started can fail.
+  if (scanStatus == WIFI_SCAN_FAILED && wifiScanInProgress) {
     if (wifiDataMutex &&
         xSemaphoreTake(wifiDataMutex, portMAX_DELAY) == pdTRUE) {
       wifiScanInProgress = false;
@@ -187,7 +359,7 @@ void WifiRadar_update() {
         wifiRadarDirty = true;
         WiFi.scanDelete();
       } else {
-        long sum = 0;
+        SlidingStats_reset(rssiStats);
         int strongest = -200;
         int weakest = 0;
 
@@ -205,16 +377,10 @@ void WifiRadar_update() {
           if (r > strongest)
             strongest = r;
 
-          sum += r;
+          SlidingStats_add(rssiStats, (float)r);
         }
 
-        float avg = (float)sum / n;
-        float varSum = 0.0f;
-        for (int i = 0; i < n; i++) {
-          float d = (float)wifiRssiList[i] - avg;
-          varSum += d * d;
-        }
-        float variance = (n > 1) ? varSum / (n - 1) : 0.0f;
+        float variance = SlidingStats_variance(rssiStats);
 
         wifiEnt.strongest = strongest;
         wifiEnt.weakest = weakest;
@@ -272,6 +438,7 @@ void WifiRadar_draw() {
   int rssiCopy[WIFI_MAX_AP];
   int channelCopy[WIFI_MAX_AP];
   bool hasData = cachedValid;
+  bool newData = false;
 
   // Update cache when new scan data is ready
   if (wifiDataMutex && xSemaphoreTake(wifiDataMutex, portMAX_DELAY) == pdTRUE) {
@@ -285,6 +452,7 @@ void WifiRadar_draw() {
       cachedValid = true;
       apCountCopy = cachedApCount;
       hasData = true;
+      newData = true;
     }
     xSemaphoreGive(wifiDataMutex);
   }
@@ -298,10 +466,10 @@ void WifiRadar_draw() {
     apCountCopy = 0;
   }
 
-  Adafruit_ILI9341 &tft = Display_tft();
   const DisplayLayout &layout = Display_getLayout();
 
   if (!radarReady()) {
+    Adafruit_ILI9341 &tft = Display_tft();
     tft.fillRect(layout.radarX, layout.radarY, layout.radarW, layout.radarH,
                  Display_dimColor(0x0000));
     tft.setFont();
@@ -310,28 +478,40 @@ void WifiRadar_draw() {
     tft.print("RADAR MEM");
     tft.setCursor(layout.radarX + 4, layout.radarY + 24);
     tft.print("UNAVAILABLE");
+    Display_drawOverlayWord();
     return;
   }
 
-  // Frame cap unless new scan data arrived; still allow overlay refresh.
+  // Frame cap unless new scan data arrived. The overlay word is part of the
+  // frame, so it fades at the frame rate.
   bool shouldDraw =
-      hasData || (now - lastRadarDrawMs) >= RADAR_FRAME_INTERVAL_MS;
-  if (!shouldDraw) {
-    Display_drawOverlayWord();
+      newData || (now - lastRadarDrawMs) >= RADAR_FRAME_INTERVAL_MS;
+  if (!shouldDraw)
     return;
-  }
   lastRadarDrawMs = now;
 
   // Radar coordinates relative to canvas
   const int radarCenterX = layout.radarW / 2;
   const int radarCenterY = layout.radarH / 2;
   const int radarR = layout.radarRadius;
-  uint16_t circleColor = Display_dimColor(0x4208); // very dark greyish red
+  const uint8_t circleColor = RADAR_COL_RING;
+
+  // Something else drew over the radar: the panel no longer shows our frame.
+  dirtyCount = 0;
+  dirtyFull = !radarShown || Display_getFrameEpoch() != radarEpoch;
+
+  // New palette: the canvas is unchanged, but every pixel expands
+  // differently.
+  if (radarPaletteEpoch != Display_getPaletteEpoch()) {
+    radarPaletteEpoch = Display_getPaletteEpoch();
+    for (uint8_t i = 0; i < RADAR_COL_WORD_SHADOW; i++)
+      radarColors[i] = Display_dimColor(RADAR_BASE_COLORS[i]);
+    dirtyFull = true;
+  }
 
   // Pre-render static background once to reduce per-frame work.
   if (!radarStaticReady && radarStatic.getBuffer() != nullptr) {
-    uint16_t bg = Display_dimColor(0x0000);
-    radarStatic.fillScreen(bg);
+    radarStatic.fillScreen(RADAR_COL_BG);
     radarStatic.drawCircle(radarCenterX, radarCenterY, radarR, circleColor);
     radarStatic.drawCircle(radarCenterX, radarCenterY, radarR * 2 / 3,
                            circleColor);
@@ -341,39 +521,25 @@ void WifiRadar_draw() {
     radarStatic.drawLine(radarCenterX, radarCenterY - radarR, radarCenterX,
                          radarCenterY + radarR, circleColor);
     radarStaticReady = true;
+    dirtyFull = true;
   }
+  bool haveStatic = radarStatic.getBuffer() != nullptr && radarStaticReady;
+  if (!haveStatic)
+    dirtyFull = true;
 
-  // Copy static background into dynamic canvas.
-  if (radarStatic.getBuffer() != nullptr && radarStaticReady) {
-    memcpy(radarCanvas.getBuffer(), radarStatic.getBuffer(),
-           RADAR_W * RADAR_H * sizeof(uint16_t));
-  } else {
-    uint16_t bg = Display_dimColor(0x0000);
-    radarCanvas.fillScreen(bg);
-    // Fallback: draw rings and crosshair directly when static buffer
-    // unavailable.
-    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR, circleColor);
-    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR * 2 / 3,
-                           circleColor);
-    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR / 3, circleColor);
-    radarCanvas.drawLine(radarCenterX - radarR, radarCenterY,
-                         radarCenterX + radarR, radarCenterY, circleColor);
-    radarCanvas.drawLine(radarCenterX, radarCenterY - radarR, radarCenterX,
-                         radarCenterY + radarR, circleColor);
-  }
-
-  // Sweeping radar line (animated)
+  // Describe this frame.
   sweepAngle += 0.12f; // adjust speed to taste
   if (sweepAngle > 2.0f * PI)
     sweepAngle -= 2.0f * PI;
   int sweepX = radarCenterX + (int)(cosf(sweepAngle) * radarR);
   int sweepY = radarCenterY + (int)(sinf(sweepAngle) * radarR);
-  uint16_t sweepBright = Display_dimColor(0xF800);
-  uint16_t sweepDim = Display_dimColor(0x8000);
-  radarCanvas.drawLine(radarCenterX, radarCenterY, sweepX, sweepY, sweepBright);
   int trailX = radarCenterX + (int)(cosf(sweepAngle - 0.1f) * (radarR - 6));
   int trailY = radarCenterY + (int)(sinf(sweepAngle - 0.1f) * (radarR - 6));
-  radarCanvas.drawLine(radarCenterX, radarCenterY, trailX, trailY, sweepDim);
+  memset(frameItems, 0, sizeof(frameItems));
+  setLineItem(frameItems[ITEM_SWEEP], radarCenterX, radarCenterY, sweepX,
+              sweepY, RADAR_COL_SWEEP);
+  setLineItem(frameItems[ITEM_TRAIL], radarCenterX, radarCenterY, trailX,
+              trailY, RADAR_COL_TRAIL);
 
   if (apCountCopy > 0 && hasData) {
     for (int i = 0; i < apCountCopy; i++) {
@@ -394,37 +560,125 @@ void WifiRadar_draw() {
       int py = radarCenterY + (int)(sinf(angle) * radius);
 
       // Red-only intensity: bright = strong, dim = weak
-      uint16_t color;
+      uint8_t color;
       if (rssi > -60) {
-        color = Display_dimColor(0xF800); // bright red
+        color = RADAR_COL_SWEEP; // bright red
       } else if (rssi > -75) {
-        color = Display_dimColor(0x8000); // dark red
+        color = RADAR_COL_TRAIL; // dark red
       } else {
         color = circleColor; // very dark
       }
 
-      radarCanvas.fillCircle(px, py, 3, color); // larger dots (~25%+)
+      // Radius-3 dot (larger dots, ~25%+)
+      setBoxItem(frameItems[ITEM_DOT + i], px - 3, py - 3, 7, 7, color, 0);
     }
   }
 
   const int inset = 4;
-  int compLeftX = inset;
-  int compRightX = layout.radarW - inset;
-  int compTopY = inset;
-  int compBottomY = layout.radarH - inset;
-
-  drawComplication(Settings_getTopLeftComplication(), compLeftX, compTopY,
-                   TextAlign::LEFT);
-  drawComplication(Settings_getTopRightComplication(), compRightX, compTopY,
-                   TextAlign::RIGHT);
-  drawComplication(Settings_getBottomLeftComplication(), compLeftX, compBottomY,
-                   TextAlign::LEFT);
-  drawComplication(Settings_getBottomRightComplication(), compRightX,
-                   compBottomY, TextAlign::RIGHT);
-
-  tft.drawRGBBitmap(layout.radarX, layout.radarY, radarCanvas.getBuffer(),
-                    layout.radarW, layout.radarH);
-
-  // Redraw overlay after radar refresh so it stays on top
-  Display_drawOverlayWord();
+  const ComplicationConfig *corners[4] = {
+      &Settings_getTopLeftComplication(), &Settings_getTopRightComplication(),
+      &Settings_getBottomLeftComplication(),
+      &Settings_getBottomRightComplication()};
+  const int anchorX[4] = {inset, layout.radarW - inset, inset,
+                          layout.radarW - inset};
+  const int anchorY[4] = {inset, inset, layout.radarH - inset,
+                          layout.radarH - inset};
+  const uint8_t textColor = RADAR_COL_TEXT;
+  for (int i = 0; i < 4; i++) {
+    complicationValues[i] = complicationText(*corners[i]);
+    if (complicationValues[i].length() == 0)
+      continue;
+    int textX, textY;
+    uint16_t w, h;
+    layoutSmallText(radarCanvas, complicationValues[i], anchorX[i],
+                    anchorY[i], (i & 1) ? TextAlign::RIGHT : TextAlign::LEFT,
+                    textX, textY, w, h);
+    setBoxItem(frameItems[ITEM_COMPLICATION + i], textX, textY, w, h,
+               textColor, textStamp(complicationValues[i]));
+  }
+
+  // The stamp covers the fade colours, so a fade step resends the word with
+  // its new palette entries.
+  DisplayRect overlay;
+  uint32_t overlayStamp;
+  if (Display_getOverlayWordRect(layout.radarX, layout.radarY, overlay,
+                                 radarColors[RADAR_COL_WORD_SHADOW],
+                                 radarColors[RADAR_COL_WORD], overlayStamp)) {
+    setBoxItem(frameItems[ITEM_OVERLAY], overlay.x, overlay.y, overlay.w,
+               overlay.h, 0, overlayStamp);
+  }
+
+  // Work out what changed since the frame on the panel.
+  if (!dirtyFull) {
+    for (int i = 0; i < ITEM_COUNT; i++) {
+      if (!sameItem(frameItems[i], shownItems[i])) {
+        markItem(shownItems[i]);
+        markItem(frameItems[i]);
+      }
+    }
+    int32_t area = 0;
+    for (uint8_t i = 0; i < dirtyCount; i++)
+      area += rectArea(dirtyRects[i]);
+    if (area > RADAR_FULL_FRAME_AREA)
+      dirtyFull = true;
+  }
+
+  if (dirtyFull && haveStatic) {
+    memcpy(radarCanvas.getBuffer(), radarStatic.getBuffer(), RADAR_W * RADAR_H);
+  } else if (dirtyFull) {
+    radarCanvas.fillScreen(RADAR_COL_BG);
+    // Fallback: draw rings and crosshair directly when static buffer
+    // unavailable.
+    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR, circleColor);
+    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR * 2 / 3,
+                           circleColor);
+    radarCanvas.drawCircle(radarCenterX, radarCenterY, radarR / 3, circleColor);
+    radarCanvas.drawLine(radarCenterX - radarR, radarCenterY,
+                         radarCenterX + radarR, radarCenterY, circleColor);
+    radarCanvas.drawLine(radarCenterX, radarCenterY - radarR, radarCenterX,
+                         radarCenterY + radarR, circleColor);
+  } else if (dirtyCount == 0) {
+    return; // nothing moved
+  } else {
+    restoreDirty();
+  }
+
+  // Draw every item, back to front.
+  for (int i = ITEM_SWEEP; i <= ITEM_TRAIL; i++) {
+    const RadarItem &it = frameItems[i];
+    radarCanvas.drawLine(it.x0, it.y0, it.x1, it.y1, it.color);
+  }
+  for (int i = ITEM_DOT; i < ITEM_COUNT; i++) {
+    const RadarItem &it = frameItems[i];
+    if (it.used)
+      radarCanvas.fillCircle(it.x0 + 3, it.y0 + 3, 3, it.color);
+  }
+  for (int i = 0; i < 4; i++) {
+    const RadarItem &it = frameItems[ITEM_COMPLICATION + i];
+    if (!it.used)
+      continue;
+    GlyphCache_drawText(radarCanvas, nullptr, it.x0, it.y0,
+                        complicationValues[i].c_str(), textColor);
+  }
+  Display_drawOverlayWordOn(radarCanvas, layout.radarX, layout.radarY,
+                            RADAR_COL_WORD_SHADOW, RADAR_COL_WORD);
+
+  // Hand the changed regions to the panel; the canvas and palette are free
+  // to change as soon as Display_blitIndexed() returns.
+  uint8_t *buf = radarCanvas.getBuffer();
+  if (dirtyFull) {
+    Display_blitIndexed(layout.radarX, layout.radarY, layout.radarW,
+                        layout.radarH, buf, RADAR_W, radarColors);
+  } else {
+    for (uint8_t i = 0; i < dirtyCount; i++) {
+      const DirtyRect &r = dirtyRects[i];
+      Display_blitIndexed(layout.radarX + r.x0, layout.radarY + r.y0,
+                          r.x1 - r.x0, r.y1 - r.y0,
+                          buf + (size_t)r.y0 * RADAR_W + r.x0, RADAR_W,
+                          radarColors);
+    }
+  }
+  memcpy(shownItems, frameItems, sizeof(shownItems));
+  radarShown = true;
+  radarEpoch = Display_getFrameEpoch();
 }
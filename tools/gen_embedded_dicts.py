@@ -0,0 +1,238 @@
+"""Generate EmbeddedDicts.h: every word list in a board's data/ directory as
+constexpr DictMatcher tables (nodes + offsets + characters) that live in flash.
+
+Used as a PlatformIO pre-build script (extra_scripts = pre:...), where the
+header is written to $BUILD_DIR/generated and GHOST_EMBEDDED_DICTS is defined,
+or standalone:
+
+    python tools/gen_embedded_dicts.py boards/esp_wroom_32/data out/EmbeddedDicts.h
+
+The automaton layout mirrors DictMatcherBuilder::build() in
+shared/src/dictmatcher.cpp: breadth-first node order, contiguous children
+sorted by label, and output links to the next shorter word on the fail
+chain, with 24-bit indices (NO_WORD is all ones in 24 bits). Words are
+uppercased, deduplicated and sorted by (length, text) like dictc images.
+Each entry also records the size and FNV-1a hash of its source file, so the
+firmware can tell when the SPIFFS copy has been edited since the build.
+"""
+
+import os
+import re
+import sys
+
+MAX_WORD_LEN = 32  # LETTER_BUFFER_SIZE in shared/include/config_core.h
+NO_WORD = 0xFFFFFF  # DICT_NODE_NONE
+
+
+def read_words(path):
+    # Bytes throughout: bytes.upper() only touches ASCII, like the firmware.
+    words = set()
+    with open(path, "rb") as f:
+        for line in f:
+            w = line.strip().upper()
+            if w and len(w) <= MAX_WORD_LEN:
+                words.add(w)
+    return sorted(words, key=lambda w: (len(w), w))
+
+
+def fnv1a(path):
+    h = 0x811C9DC5
+    with open(path, "rb") as f:
+        data = f.read()
+    for b in bytearray(data):
+        h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+    return len(data), h
+
+
+def build_automaton(words):
+    # Insertion trie: children[node] = {label: node}, word[node] = id.
+    children = [{}]
+    word = [NO_WORD]
+    for wid, w in enumerate(words):
+        node = 0
+        for ch in w:
+            nxt = children[node].get(ch)
+            if nxt is None:
+                nxt = len(children)
+                children.append({})
+                word.append(NO_WORD)
+                children[node][ch] = nxt
+            node = nxt
+        word[node] = wid
+
+    # Breadth-first renumbering with label-sorted, contiguous children.
+    order = [0]
+    nodes = []
+    i = 0
+    while i < len(order):
+        old = order[i]
+        first = len(order)
+        for label in sorted(children[old]):
+            order.append(children[old][label])
+        nodes.append({"first": first, "count": len(order) - first,
+                      "fail": 0, "word": NO_WORD, "output": 0, "label": 0,
+                      "depth": 0})
+        i += 1
+    for new, old in enumerate(order):
+        nodes[new]["word"] = word[old]
+    for new, node in enumerate(nodes):
+        for k in range(node["count"]):
+            child = nodes[node["first"] + k]
+            child["label"] = sorted(children[order[new]])[k]
+            child["depth"] = node["depth"] + 1
+
+    def find_child(state, label):
+        n = nodes[state]
+        for k in range(n["count"]):
+            if nodes[n["first"] + k]["label"] == label:
+                return n["first"] + k
+        return None
+
+    for idx, parent in enumerate(nodes):
+        for k in range(parent["count"]):
+            child = nodes[parent["first"] + k]
+            target = 0
+            if idx != 0:
+                f = parent["fail"]
+                while True:
+                    t = find_child(f, child["label"])
+                    if t is not None:
+                        target = t
+                        break
+                    if f == 0:
+                        break
+                    f = nodes[f]["fail"]
+            child["fail"] = target
+            if nodes[target]["word"] != NO_WORD:
+                child["output"] = target
+            else:
+                child["output"] = nodes[target]["output"]
+    return nodes
+
+
+def c_ident(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def c_string(words):
+    out = []
+    for w in words:
+        for b in w:
+            if 32 <= b < 127 and chr(b) not in '"\\?':
+                out.append(chr(b))
+            else:
+                out.append("\\%03o" % b)
+        out.append("\\000")
+    text = "".join(out)
+    # Break into lines without splitting an escape sequence.
+    lines, line = [], ""
+    for token in re.findall(r"\\[0-7]{3}|.", text):
+        if len(line) + len(token) > 72:
+            lines.append(line)
+            line = ""
+        line += token
+    lines.append(line)
+    return "\n".join('    "%s"' % l for l in lines)
+
+
+def emit_table(stem, words):
+    ident = c_ident(stem)
+    nodes = build_automaton(words)
+    offsets, pos = [], 0
+    for w in words:
+        offsets.append(pos)
+        pos += len(w) + 1
+
+    out = ["// %s: %d words, %d states" % (stem, len(words), len(nodes))]
+    out.append("constexpr DictNode %s_NODES[] = {" % ident)
+    for n in nodes:
+        out.append("    {%uu, %u, %uu, %u, %uu, %u, 0x%06Xu, 0}," %
+                   (n["first"], n["count"], n["fail"], n["label"],
+                    n["output"], n["depth"], n["word"]))
+    out.append("};")
+    out.append("constexpr uint32_t %s_OFFSETS[] = {" % ident)
+    for i in range(0, len(offsets), 10):
+        out.append("    " + ", ".join("%uu" % o for o in offsets[i:i + 10]) +
+                   ",")
+    out.append("};")
+    out.append("constexpr char %s_CHARS[] =" % ident)
+    out.append(c_string(words) + ";")
+    matcher = "{%s_NODES, %du, %s_OFFSETS, %du, %s_CHARS}" % (
+        ident, len(nodes), ident, len(words), ident)
+    return "\n".join(out), matcher
+
+
+def generate(data_dir, out_path):
+    lists = sorted(f for f in os.listdir(data_dir) if f.endswith(".txt"))
+    body, entries = [], []
+    for name in lists:
+        stem = name[:-4]
+        path = os.path.join(data_dir, name)
+        words = read_words(path)
+        size, digest = fnv1a(path)
+        if words:
+            table, matcher = emit_table(stem, words)
+            body.append(table)
+        else:
+            matcher = "{nullptr, 0, nullptr, 0, nullptr}"
+        entries.append('    {"/%s", %uu, 0x%08Xu, %s},' %
+                       (name, size, digest, matcher))
+
+    text = "\n".join([
+        "#pragma once",
+        "// Generated by tools/gen_embedded_dicts.py from %s. Do not edit." %
+        os.path.relpath(data_dir).replace("\\", "/"),
+        '#include "DictMatcher.h"',
+        "",
+        "namespace EmbeddedDicts {",
+        "",
+        "\n\n".join(body),
+        "",
+        "struct Entry {",
+        "  const char *path;    // matching SPIFFS text list",
+        "  uint32_t sourceSize; // bytes and FNV-1a hash of the data/ file",
+        "  uint32_t sourceHash;",
+        "  DictMatcher matcher;",
+        "};",
+        "",
+        "constexpr Entry ENTRIES[] = {",
+        "\n".join(entries),
+        "};",
+        "constexpr size_t COUNT = sizeof(ENTRIES) / sizeof(ENTRIES[0]);",
+        "",
+        "} // namespace EmbeddedDicts",
+        "",
+    ])
+
+    old = None
+    if os.path.exists(out_path):
+        with open(out_path, "r") as f:
+            old = f.read()
+    if old != text:  # keep the timestamp stable so nothing rebuilds needlessly
+        os.makedirs(os.path.dirname(out_path) or ".", exist_ok=True)
+        with open(out_path, "w") as f:
+            f.write(text)
+    return len(lists)
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__)
+        return 2
+    count = generate(argv[1], argv[2])
+    print("%s: %d embedded dictionaries" % (argv[2], count))
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+except NameError:
+    env = None
+
+if env is not None:
+    data_dir = os.path.join(env.subst("$PROJECT_DIR"), "data")
+    gen_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    generate(data_dir, os.path.join(gen_dir, "EmbeddedDicts.h"))
+    env.Append(CPPPATH=[gen_dir], CPPDEFINES=["GHOST_EMBEDDED_DICTS"])
+elif __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,48 @@
+#pragma once
+#include "SensorScore.h"
+#include <math.h>
+#include <random>
+#include <vector>
+
+// Synthetic SensorReadings shared by score_bench and score_test. Half look
+// like a device on a desk, half are spread a little past every normalization
+// range so the clamps are exercised too.
+static std::vector<SensorReadings> makeScoreReadings(size_t count) {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::normal_distribution<float> gauss(0.0f, 1.0f);
+  std::exponential_distribution<float> expo(1.0f / 1.5f);
+  auto span = [&](float lo, float hi) { return lo + (hi - lo) * unit(rng); };
+
+  std::vector<SensorReadings> v(count);
+  for (size_t i = 0; i < count; i++) {
+    SensorReadings &r = v[i];
+    if (i % 2 == 0) {
+      r.tempC = 22.0f + 3.0f * gauss(rng);
+      r.humidity = 45.0f + 8.0f * gauss(rng);
+      r.accelMag = fabsf(9.81f + 1.5f * gauss(rng));
+      r.gyroMag = fabsf(0.5f * gauss(rng));
+      r.accelVar = expo(rng);
+      r.gyroVar = expo(rng) * 0.2f;
+      r.hallRaw = (int16_t)(20.0f * gauss(rng));
+      r.wifiStrongest = (int16_t)(-60.0f + 10.0f * gauss(rng));
+      r.wifiVariance = 120.0f * expo(rng);
+      r.wifiCount = (int16_t)span(0.0f, 12.0f);
+      r.varianceScale = 1.0f;
+    } else {
+      r.tempC = span(5.0f, 45.0f);
+      r.humidity = span(10.0f, 95.0f);
+      r.accelMag = span(0.0f, 25.0f);
+      r.gyroMag = span(0.0f, 350.0f);
+      r.accelVar = span(0.0f, 6.0f);
+      r.gyroVar = span(0.0f, 6.0f);
+      r.hallRaw = (int16_t)span(-250.0f, 250.0f);
+      r.wifiStrongest = (int16_t)span(-105.0f, -25.0f);
+      r.wifiVariance = span(0.0f, 500.0f);
+      r.wifiCount = (int16_t)span(0.0f, 15.0f);
+      r.varianceScale = span(0.25f, 3.0f);
+    }
+    r.noise = (uint8_t)(rng() & 0xFF);
+  }
+  return v;
+}
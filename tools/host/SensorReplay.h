@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+// Host-only backend for the Sensors_* API: letters come from a recorded
+// SensorTrace instead of hardware. Open a trace, then call Sensors_begin()
+// and Sensors_pollLetter() as the firmware does.
+
+enum SensorReplaySpeed : uint8_t {
+  SENSOR_REPLAY_MAX_SPEED = 0, // every poll runs until the next letter
+  SENSOR_REPLAY_REAL_TIME      // steps are released on their recorded times
+};
+
+bool SensorReplay_open(const char *path, SensorReplaySpeed speed);
+void SensorReplay_close();
+// True once every record has been consumed.
+bool SensorReplay_finished();
+// Steps (SAMPLE_PERIOD_MS samples) replayed so far.
+uint32_t SensorReplay_stepCount();
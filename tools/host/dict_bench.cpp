@@ -0,0 +1,467 @@
+// Host benchmark: letters/sec of the Aho-Corasick dictionary matcher versus the
+// previous linear suffix scan, on words.txt and a synthetic 50k-word list.
+// Both paths must report the identical hit sequence or the run fails.
+// The SD suffix dictionary (dictc -s) is checked against a length-sorted
+// automaton, which reports the same shortest-suffix hits, and its block reads
+// per letter are reported. Finally three overlapping lists are merged into
+// one tagged automaton; its per-letter list tags must equal running the lists
+// separately, each candidate must carry its own word's lists alone (a short
+// word from one list that is a suffix of a word from another included), and
+// its memory is compared with the separate automata.
+// The match policy engine's candidate lists (every word ending on a letter,
+// longest first) are checked against a brute-force scan and the SD format.
+//
+//   dict_bench [words.txt] [letters]
+
+#include "DictMatcher.h"
+#include "SuffixDict.h"
+#include "dict_compile.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const int LETTER_BUFFER_SIZE = 32; // mirrors config_core.h
+static const double MIN_RUN_SECONDS = 0.2;
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next() {
+    state = state * 1664525UL + 1013904223UL;
+    return state >> 8;
+  }
+};
+
+static std::vector<std::string> loadWords(const char *path) {
+  std::vector<std::string> words;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+      line.pop_back();
+    if (line.empty() || line.size() > (size_t)LETTER_BUFFER_SIZE)
+      continue;
+    for (char &c : line)
+      if (c >= 'a' && c <= 'z')
+        c = (char)(c - 'a' + 'A');
+    words.push_back(line);
+  }
+  return words;
+}
+
+static std::vector<std::string> syntheticWords(size_t count) {
+  std::vector<std::string> words;
+  words.reserve(count);
+  Lcg rng = {0xC0FFEEUL};
+  for (size_t i = 0; i < count; i++) {
+    size_t len = 3 + rng.next() % 8;
+    std::string w;
+    for (size_t j = 0; j < len; j++)
+      w.push_back((char)('A' + rng.next() % 26));
+    words.push_back(w);
+  }
+  return words;
+}
+
+static std::vector<char> letterStream(size_t count) {
+  std::vector<char> letters(count);
+  Lcg rng = {0x5EEDUL};
+  for (size_t i = 0; i < count; i++)
+    letters[i] = (char)('A' + rng.next() % 26);
+  return letters;
+}
+
+// Previous Dictionary_checkForWord: first list entry that is a suffix wins.
+static void runScan(const std::vector<std::string> &words,
+                    const std::vector<char> &letters,
+                    std::vector<uint32_t> &hits) {
+  char buf[LETTER_BUFFER_SIZE];
+  int count = 0;
+  for (size_t n = 0; n < letters.size(); n++) {
+    if (count < LETTER_BUFFER_SIZE) {
+      buf[count++] = letters[n];
+    } else {
+      memmove(buf, buf + 1, LETTER_BUFFER_SIZE - 1);
+      buf[LETTER_BUFFER_SIZE - 1] = letters[n];
+    }
+    for (size_t i = 0; i < words.size(); i++) {
+      int len = (int)words[i].size();
+      if (len > count || memcmp(buf + count - len, words[i].data(), len) != 0)
+        continue;
+      hits.push_back((uint32_t)n);
+      int keep = count < 2 ? count : 2;
+      memmove(buf, buf + count - keep, keep);
+      count = keep;
+      break;
+    }
+  }
+}
+
+static void runAutomaton(const DictMatcher &m, const std::vector<char> &letters,
+                         std::vector<uint32_t> &hits) {
+  char buf[LETTER_BUFFER_SIZE];
+  int count = 0;
+  uint32_t state = DICT_ROOT_STATE;
+  for (size_t n = 0; n < letters.size(); n++) {
+    if (count < LETTER_BUFFER_SIZE) {
+      buf[count++] = letters[n];
+    } else {
+      memmove(buf, buf + 1, LETTER_BUFFER_SIZE - 1);
+      buf[LETTER_BUFFER_SIZE - 1] = letters[n];
+    }
+    state = DictMatcher_step(m, state, letters[n]);
+    if (DictMatcher_matchAt(m, state) == DICT_NO_WORD)
+      continue;
+    hits.push_back((uint32_t)n);
+    int keep = count < 2 ? count : 2;
+    memmove(buf, buf + count - keep, keep);
+    count = keep;
+    state = DICT_ROOT_STATE;
+    for (int i = 0; i < count; i++)
+      state = DictMatcher_step(m, state, buf[i]);
+  }
+}
+
+struct MemoryBlocks {
+  const std::vector<uint8_t> *file;
+  uint32_t blocksOffset;
+  size_t reads;
+};
+
+static const char *readMemoryBlock(uint32_t block, void *ctx) {
+  MemoryBlocks *mem = (MemoryBlocks *)ctx;
+  mem->reads++;
+  return (const char *)mem->file->data() + mem->blocksOffset +
+         block * SUFFIX_DICT_BLOCK_SIZE;
+}
+
+static void runSuffixDict(const SuffixDict &d, const std::vector<char> &letters,
+                          std::vector<uint32_t> &hits) {
+  char buf[LETTER_BUFFER_SIZE];
+  char word[LETTER_BUFFER_SIZE + 1];
+  int count = 0;
+  for (size_t n = 0; n < letters.size(); n++) {
+    if (count < LETTER_BUFFER_SIZE) {
+      buf[count++] = letters[n];
+    } else {
+      memmove(buf, buf + 1, LETTER_BUFFER_SIZE - 1);
+      buf[LETTER_BUFFER_SIZE - 1] = letters[n];
+    }
+    if (!SuffixDict_findSuffix(d, buf, count, word, sizeof(word)))
+      continue;
+    hits.push_back((uint32_t)n);
+    int keep = count < 2 ? count : 2;
+    memmove(buf, buf + count - keep, keep);
+    count = keep;
+  }
+}
+
+// Candidate lengths per letter (longest first) from a full suffix scan over
+// an unreset sliding window; one 0 terminates each letter's list.
+static void runAllSuffixesScan(const std::vector<std::string> &words,
+                               const std::vector<char> &letters,
+                               std::vector<uint8_t> &out) {
+  std::vector<uint8_t> lens;
+  for (size_t n = 0; n < letters.size(); n++) {
+    size_t count = n + 1 < (size_t)LETTER_BUFFER_SIZE ? n + 1
+                                                       : LETTER_BUFFER_SIZE;
+    const char *buf = letters.data() + n + 1 - count;
+    lens.clear();
+    for (const std::string &w : words) {
+      if (w.size() <= count &&
+          memcmp(buf + count - w.size(), w.data(), w.size()) == 0)
+        lens.push_back((uint8_t)w.size());
+    }
+    std::sort(lens.rbegin(), lens.rend());
+    out.insert(out.end(), lens.begin(), lens.end());
+    out.push_back(0);
+  }
+}
+
+static void runAllSuffixesAutomaton(const DictMatcher &m,
+                                    const std::vector<char> &letters,
+                                    std::vector<uint8_t> &out) {
+  DictOutput found[LETTER_BUFFER_SIZE];
+  uint32_t state = DICT_ROOT_STATE;
+  for (size_t n = 0; n < letters.size(); n++) {
+    state = DictMatcher_step(m, state, letters[n]);
+    uint32_t count = DictMatcher_outputs(m, state, found, LETTER_BUFFER_SIZE);
+    for (uint32_t i = 0; i < count; i++)
+      out.push_back(found[i].length);
+    out.push_back(0);
+  }
+}
+
+static void runAllSuffixesSd(const SuffixDict &d,
+                             const std::vector<char> &letters,
+                             std::vector<uint8_t> &out) {
+  uint8_t lengths[LETTER_BUFFER_SIZE];
+  for (size_t n = 0; n < letters.size(); n++) {
+    int count = n + 1 < (size_t)LETTER_BUFFER_SIZE ? (int)n + 1
+                                                    : LETTER_BUFFER_SIZE;
+    const char *buf = letters.data() + n + 1 - count;
+    uint8_t found =
+        SuffixDict_suffixLengths(d, buf, count, lengths, LETTER_BUFFER_SIZE);
+    while (found > 0)
+      out.push_back(lengths[--found]);
+    out.push_back(0);
+  }
+}
+
+template <typename Fn>
+static double lettersPerSecond(size_t letters, std::vector<uint32_t> &hits,
+                               Fn fn) {
+  using Clock = std::chrono::steady_clock;
+  size_t total = 0;
+  Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  do {
+    hits.clear();
+    fn(hits);
+    total += letters;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < MIN_RUN_SECONDS);
+  return total / elapsed;
+}
+
+static bool benchList(const char *label, const std::vector<std::string> &words,
+                      const std::vector<char> &letters) {
+  DictMatcherBuilder builder;
+  for (const std::string &w : words)
+    builder.addWord(w.data(), w.size());
+  DictMatcher m = builder.build();
+
+  // Candidate lists for the match policies: every overlapping word, each
+  // distinct word once (the automaton drops duplicates).
+  std::vector<std::string> unique = words;
+  std::sort(unique.begin(), unique.end());
+  unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+  std::vector<uint8_t> scanAll, acAll;
+  std::vector<uint32_t> unused;
+  double scanAllRate = lettersPerSecond(letters.size(), unused, [&](auto &) {
+    scanAll.clear();
+    runAllSuffixesScan(unique, letters, scanAll);
+  });
+  double acAllRate = lettersPerSecond(letters.size(), unused, [&](auto &) {
+    acAll.clear();
+    runAllSuffixesAutomaton(m, letters, acAll);
+  });
+
+  std::vector<uint32_t> scanHits, acHits;
+  double scanRate = lettersPerSecond(letters.size(), scanHits, [&](auto &h) {
+    runScan(words, letters, h);
+  });
+  double acRate = lettersPerSecond(letters.size(), acHits, [&](auto &h) {
+    runAutomaton(m, letters, h);
+  });
+
+  printf("%-12s words=%-6zu states=%-7u matcherBytes=%-8zu hits=%zu\n", label,
+         words.size(), m.nodeCount, builder.memoryBytes(), acHits.size());
+  printf("  linear scan : %12.0f letters/s\n", scanRate);
+  printf("  automaton   : %12.0f letters/s  (%.1fx)\n", acRate,
+         acRate / scanRate);
+  printf("  all (scan)  : %12.0f letters/s  candidates=%zu\n", scanAllRate,
+         scanAll.size() - letters.size());
+  printf("  all (links) : %12.0f letters/s  (%.1fx)\n", acAllRate,
+         acAllRate / scanAllRate);
+  if (scanAll != acAll) {
+    printf("  MISMATCH: output links disagree with the suffix scan\n");
+    return false;
+  }
+  if (scanHits != acHits) {
+    printf("  MISMATCH: scan reported %zu hits, automaton %zu\n",
+           scanHits.size(), acHits.size());
+    return false;
+  }
+  return true;
+}
+
+static bool benchSuffixDict(const char *label,
+                            std::vector<std::string> words,
+                            const std::vector<char> &letters) {
+  std::sort(words.begin(), words.end(),
+            [](const std::string &a, const std::string &b) {
+              return a.size() != b.size() ? a.size() < b.size() : a < b;
+            });
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+
+  std::vector<uint8_t> file;
+  DictCompile_suffixPack(words, label, file);
+  const SuffixDictHeader *h = (const SuffixDictHeader *)file.data();
+  MemoryBlocks mem = {&file, h->blocksOffset, 0};
+  const uint32_t *letterMasks =
+      (const uint32_t *)(file.data() + h->letterMaskOffset);
+  SuffixDict d = {file.data() + h->indexOffset,
+                  h->blockCount,
+                  h->blockSize,
+                  h->lengthMask,
+                  letterMasks,
+                  h->maxWordLength,
+                  readMemoryBlock,
+                  &mem};
+
+  DictMatcherBuilder builder; // length-sorted ids: reports shortest suffix
+  for (const std::string &w : words)
+    builder.addWord(w.data(), w.size());
+  DictMatcher m = builder.build();
+
+  std::vector<uint32_t> sfxHits, acHits;
+  runAutomaton(m, letters, acHits);
+  std::vector<uint8_t> sfxAll, acAll;
+  runAllSuffixesSd(d, letters, sfxAll);
+  runAllSuffixesAutomaton(m, letters, acAll);
+  if (sfxAll != acAll) {
+    printf("%-12s MISMATCH: suffix dict candidate lengths differ\n", label);
+    return false;
+  }
+  double rate = lettersPerSecond(letters.size(), sfxHits, [&](auto &hits) {
+    mem.reads = 0;
+    runSuffixDict(d, letters, hits);
+  });
+
+  printf("%-12s sd suffix   : %12.0f letters/s  %.2f block reads/letter  "
+         "%u blocks, %u-byte RAM index\n",
+         label, rate, (double)mem.reads / letters.size(), h->blockCount,
+         (unsigned)(h->blockCount * h->keyLen +
+                    SUFFIX_DICT_LETTERS * sizeof(uint32_t)));
+  if (sfxHits != acHits) {
+    printf("  MISMATCH: suffix dict reported %zu hits, automaton %zu\n",
+           sfxHits.size(), acHits.size());
+    return false;
+  }
+  return true;
+}
+
+// Tag bits of every list whose own automaton reports a word at each letter.
+static void runSeparate(const std::vector<DictMatcher> &lists,
+                        const std::vector<char> &letters,
+                        std::vector<uint8_t> &tags) {
+  std::vector<uint32_t> states(lists.size(), DICT_ROOT_STATE);
+  for (size_t n = 0; n < letters.size(); n++) {
+    uint8_t mask = 0;
+    for (size_t i = 0; i < lists.size(); i++) {
+      states[i] = DictMatcher_step(lists[i], states[i], letters[n]);
+      if (DictMatcher_matchAt(lists[i], states[i]) != DICT_NO_WORD)
+        mask |= (uint8_t)(1 << i);
+    }
+    tags[n] = mask;
+  }
+}
+
+static void runCombined(const DictMatcher &m, const std::vector<char> &letters,
+                        std::vector<uint8_t> &tags) {
+  uint32_t state = DICT_ROOT_STATE;
+  for (size_t n = 0; n < letters.size(); n++) {
+    state = DictMatcher_step(m, state, letters[n]);
+    tags[n] = DictMatcher_tagsAt(m, state);
+  }
+}
+
+// A word that is a suffix of a word from another list keeps its own list:
+// after G-H-O-S-T both words are candidates, each tagged with its list alone.
+static bool checkSuffixAttribution() {
+  static const char *const CASES[][2] = {{"HOST", "GHOST"}, {"GHOST", "HOST"}};
+  bool ok = true;
+  for (const auto &c : CASES) {
+    DictMatcherBuilder b;
+    b.addWord(c[0], strlen(c[0]), 1);
+    b.addWord(c[1], strlen(c[1]), 2);
+    DictMatcher m = b.build();
+    uint32_t state = DICT_ROOT_STATE;
+    for (const char *p = "GHOST"; *p; p++)
+      state = DictMatcher_step(m, state, *p);
+    DictOutput out[4];
+    uint32_t n = DictMatcher_outputs(m, state, out, 4);
+    if (n != 2) {
+      printf("  MISMATCH: %s + %s: %u candidates, want 2\n", c[0], c[1], n);
+      ok = false;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      const char *word = DictMatcher_word(m, out[i].word);
+      uint8_t want = strcmp(word, c[0]) == 0 ? 1 : 2;
+      if (out[i].tags != want) {
+        printf("  MISMATCH: %s (list 0) + %s (list 1): %s tagged %u, want "
+               "%u\n",
+               c[0], c[1], word, out[i].tags, want);
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+// Overlapping lists in the spirit of Default/Paranormal/Short: a shared core
+// plus words unique to each list.
+static bool benchCombined(const std::vector<std::string> &pool,
+                          const std::vector<char> &letters) {
+  const size_t LISTS = 3;
+  std::vector<std::vector<std::string>> lists(LISTS);
+  Lcg rng = {0xD1C7UL};
+  for (const std::string &w : pool) {
+    uint32_t r = rng.next() % 8;
+    for (size_t i = 0; i < LISTS; i++)
+      if (r == 0 || r % LISTS == i) // 1 in 8 words is in every list
+        lists[i].push_back(w);
+  }
+
+  std::vector<DictMatcherBuilder> separate(LISTS);
+  std::vector<DictMatcher> matchers;
+  size_t separateBytes = 0;
+  DictMatcherBuilder combined;
+  for (size_t i = 0; i < LISTS; i++) {
+    for (const std::string &w : lists[i]) {
+      separate[i].addWord(w.data(), w.size());
+      combined.addWord(w.data(), w.size(), (uint8_t)(1 << i));
+    }
+    matchers.push_back(separate[i].build());
+    separateBytes += separate[i].memoryBytes();
+  }
+  DictMatcher m = combined.build();
+
+  std::vector<uint8_t> sepTags(letters.size()), allTags(letters.size());
+  std::vector<uint32_t> unused;
+  double sepRate = lettersPerSecond(letters.size(), unused, [&](auto &) {
+    runSeparate(matchers, letters, sepTags);
+  });
+  double allRate = lettersPerSecond(letters.size(), unused, [&](auto &) {
+    runCombined(m, letters, allTags);
+  });
+
+  printf("combined     lists=%zu/%zu/%zu words=%u\n", lists[0].size(),
+         lists[1].size(), lists[2].size(), m.wordCount);
+  printf("  separate    : %12.0f letters/s  %8zu bytes\n", sepRate,
+         separateBytes);
+  size_t combinedBytes = combined.memoryBytes();
+  printf("  tagged      : %12.0f letters/s  %8zu bytes (%.0f%%)\n", allRate,
+         combinedBytes, 100.0 * combinedBytes / separateBytes);
+  if (sepTags != allTags) {
+    printf("  MISMATCH: combined tags differ from separate automata\n");
+    return false;
+  }
+  return checkSuffixAttribution();
+}
+
+int main(int argc, char **argv) {
+  const char *wordsPath =
+      argc > 1 ? argv[1] : "boards/esp_wroom_32/data/words.txt";
+  size_t letterCount = argc > 2 ? (size_t)strtoul(argv[2], nullptr, 10) : 20000;
+
+  std::vector<char> letters = letterStream(letterCount);
+  std::vector<std::string> shipped = loadWords(wordsPath);
+  if (shipped.empty()) {
+    fprintf(stderr, "no words loaded from %s\n", wordsPath);
+    return 1;
+  }
+
+  std::vector<std::string> synthetic = syntheticWords(50000);
+  bool ok = benchList("words.txt", shipped, letters);
+  ok = benchList("synthetic", synthetic, letters) && ok;
+  ok = benchSuffixDict("words.txt", shipped, letters) && ok;
+  ok = benchSuffixDict("synthetic", synthetic, letters) && ok;
+  ok = benchCombined(synthetic, letters) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include "dict_compile.h"
+#include "DictImage.h"
+#include "SuffixDict.h"
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+// Same normalization as the firmware's text loader: trim, uppercase, drop
+// blanks and words that cannot fit the letter buffer.
+std::vector<std::string> DictCompile_readWords(const std::string &path,
+                                               size_t maxLen, bool &ok) {
+  std::vector<std::string> words;
+  std::ifstream in(path.c_str());
+  ok = (bool)in;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t b = line.find_first_not_of(" \t\r\n");
+    size_t e = line.find_last_not_of(" \t\r\n");
+    if (b == std::string::npos)
+      continue;
+    std::string w = line.substr(b, e - b + 1);
+    if (w.size() > maxLen || w.size() > 255)
+      continue;
+    for (char &c : w)
+      if (c >= 'a' && c <= 'z')
+        c = (char)(c - 'a' + 'A');
+    words.push_back(w);
+  }
+  std::sort(words.begin(), words.end(),
+            [](const std::string &a, const std::string &b) {
+              return a.size() != b.size() ? a.size() < b.size() : a < b;
+            });
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  return words;
+}
+
+static void align4(std::vector<uint8_t> &out) {
+  while (out.size() & 3)
+    out.push_back(0);
+}
+
+template <typename T>
+static uint32_t appendSection(std::vector<uint8_t> &out, const T *items,
+                              size_t count) {
+  align4(out);
+  uint32_t offset = (uint32_t)out.size();
+  const uint8_t *bytes = (const uint8_t *)items;
+  out.insert(out.end(), bytes, bytes + count * sizeof(T));
+  return offset;
+}
+
+bool DictCompile_image(const std::vector<std::string> &words,
+                       const std::string &name, std::vector<uint8_t> &out) {
+  if (words.empty())
+    return false;
+
+  DictMatcherBuilder builder;
+  size_t charCount = 0;
+  for (const std::string &w : words)
+    charCount += w.size() + 1;
+  builder.reserve(words.size(), charCount);
+  for (const std::string &w : words)
+    builder.addWord(w.data(), w.size());
+  DictMatcher m = builder.build();
+
+  DictImageHeader h;
+  memset(&h, 0, sizeof(h));
+  h.magic = DICT_IMAGE_MAGIC;
+  h.version = DICT_IMAGE_VERSION;
+  h.headerSize = sizeof(DictImageHeader);
+  h.wordCount = m.wordCount;
+  h.nodeCount = m.nodeCount;
+  h.maxWordLength = (uint8_t)words.back().size();
+  strncpy(h.name, name.c_str(), DICT_IMAGE_NAME_LEN - 1);
+
+  out.assign(sizeof(h), 0);
+  h.nodesOffset = appendSection(out, m.nodes, m.nodeCount);
+  h.wordOffsetsOffset = appendSection(out, m.wordOffsets, m.wordCount);
+  const char *lastWord = DictMatcher_word(m, m.wordCount - 1);
+  h.charsSize = (uint32_t)(lastWord + strlen(lastWord) + 1 - m.chars);
+  h.charsOffset = appendSection(out, m.chars, h.charsSize);
+  align4(out);
+
+  h.imageSize = (uint32_t)out.size();
+  h.checksum = DictImage_crc32(out.data() + sizeof(h), out.size() - sizeof(h));
+  memcpy(out.data(), &h, sizeof(h));
+  return true;
+}
+
+bool DictCompile_suffixPack(const std::vector<std::string> &words,
+                            const std::string &name,
+                            std::vector<uint8_t> &out) {
+  if (words.empty())
+    return false;
+
+  std::vector<std::string> reversed;
+  reversed.reserve(words.size());
+  SuffixDictHeader h;
+  memset(&h, 0, sizeof(h));
+  uint32_t letterMasks[SUFFIX_DICT_LETTERS] = {0};
+  for (const std::string &w : words) {
+    reversed.push_back(std::string(w.rbegin(), w.rend()));
+    if (w.size() <= 32) {
+      h.lengthMask |= 1UL << (w.size() - 1);
+      char last = w.back();
+      if (last >= 'A' && last <= 'Z')
+        letterMasks[last - 'A'] |= 1UL << (w.size() - 1);
+    }
+    if (w.size() > h.maxWordLength)
+      h.maxWordLength = (uint8_t)w.size();
+  }
+  std::sort(reversed.begin(), reversed.end());
+
+  const size_t blockSize = SUFFIX_DICT_BLOCK_SIZE;
+  std::vector<uint8_t> blocks;
+  std::vector<uint8_t> keys;
+  size_t used = blockSize; // force a new block for the first word
+  for (const std::string &r : reversed) {
+    if (used + r.size() + 1 > blockSize) {
+      blocks.resize(blocks.size() + blockSize, 0);
+      used = 0;
+      uint8_t key[SUFFIX_DICT_KEY_LEN] = {0};
+      memcpy(key, r.data(), std::min(r.size(), sizeof(key)));
+      keys.insert(keys.end(), key, key + sizeof(key));
+    }
+    memcpy(&blocks[blocks.size() - blockSize + used], r.c_str(), r.size() + 1);
+    used += r.size() + 1;
+  }
+
+  h.magic = SUFFIX_DICT_MAGIC;
+  h.version = SUFFIX_DICT_VERSION;
+  h.headerSize = sizeof(SuffixDictHeader);
+  h.wordCount = (uint32_t)words.size();
+  h.blockCount = (uint32_t)(blocks.size() / blockSize);
+  h.blockSize = SUFFIX_DICT_BLOCK_SIZE;
+  h.keyLen = SUFFIX_DICT_KEY_LEN;
+  h.indexOffset = sizeof(h);
+  h.letterMaskOffset = (uint32_t)(h.indexOffset + keys.size());
+  h.indexCrc = DictImage_crc32((const uint8_t *)letterMasks,
+                               sizeof(letterMasks),
+                               DictImage_crc32(keys.data(), keys.size()));
+  h.blocksOffset = (uint32_t)((h.letterMaskOffset + sizeof(letterMasks) +
+                               blockSize - 1) /
+                              blockSize * blockSize);
+  strncpy(h.name, name.c_str(), SUFFIX_DICT_NAME_LEN - 1);
+
+  out.assign(h.blocksOffset, 0);
+  memcpy(out.data(), &h, sizeof(h));
+  memcpy(out.data() + h.indexOffset, keys.data(), keys.size());
+  memcpy(out.data() + h.letterMaskOffset, letterMasks, sizeof(letterMasks));
+  out.insert(out.end(), blocks.begin(), blocks.end());
+  return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Host-side dictionary image compilation shared by dictc and the benchmarks.
+
+// Read a word list; sorted by (length, text) and deduplicated. `ok` is false
+// if the file could not be opened.
+std::vector<std::string> DictCompile_readWords(const std::string &path,
+                                               size_t maxLen, bool &ok);
+
+// Build a DictImage from sorted, unique words. Returns false if empty.
+bool DictCompile_image(const std::vector<std::string> &words,
+                       const std::string &name, std::vector<uint8_t> &out);
+
+// Build a SuffixDict file (reversed, suffix-sorted, block-packed) for lists
+// streamed from SD. Returns false if empty.
+bool DictCompile_suffixPack(const std::vector<std::string> &words,
+                            const std::string &name, std::vector<uint8_t> &out);
@@ -0,0 +1,182 @@
+// Host benchmark: dictionary switch cost of the text loader (parse every line,
+// build the automaton) versus a precompiled DictImage (one buffer, validated
+// in place). The image is timed on its first open, which checks the CRC, and
+// on a switch back to an already verified file, which only repeats the index
+// checks. Reports time, heap allocations and peak heap for each path on
+// words.txt and a synthetic 50k-word list.
+//
+//   dict_load_bench [words.txt]
+
+#include "DictImage.h"
+#include "DictMatcher.h"
+#include "dict_compile.h"
+#include <chrono>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const size_t LETTER_BUFFER_SIZE = 32; // mirrors config_core.h
+static const int ITERATIONS = 20;
+
+// --- Heap accounting: every operator new is counted while `tracking` is set.
+static bool tracking = false;
+static size_t allocCount = 0;
+static size_t liveBytes = 0;
+static size_t peakBytes = 0;
+
+void *operator new(size_t size) {
+  size_t *p = (size_t *)malloc(size + sizeof(size_t) * 2);
+  if (!p)
+    throw std::bad_alloc();
+  p[0] = size;
+  if (tracking) {
+    allocCount++;
+    liveBytes += size;
+    if (liveBytes > peakBytes)
+      peakBytes = liveBytes;
+  }
+  return p + 2;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr)
+    return;
+  size_t *p = (size_t *)ptr - 2;
+  if (tracking && liveBytes >= p[0])
+    liveBytes -= p[0];
+  free(p);
+}
+
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
+
+struct LoadStats {
+  double ms;
+  size_t allocs;
+  size_t peak;
+  uint32_t words;
+};
+
+template <typename Fn> static LoadStats measure(Fn load) {
+  using Clock = std::chrono::steady_clock;
+  LoadStats stats = {0.0, 0, 0, 0};
+  for (int i = 0; i < ITERATIONS; i++) {
+    allocCount = liveBytes = peakBytes = 0;
+    tracking = true;
+    Clock::time_point start = Clock::now();
+    stats.words = load();
+    double ms =
+        std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    tracking = false;
+    stats.ms += ms / ITERATIONS;
+    stats.allocs = allocCount;
+    stats.peak = peakBytes;
+  }
+  return stats;
+}
+
+// Mirrors loadDictionaryFromSPIFFS: one line string per word, then build.
+static uint32_t loadText(const std::string &text) {
+  DictMatcherBuilder builder;
+  builder.reserve(512, text.size() + 1);
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t b = line.find_first_not_of(" \t\r");
+    if (b == std::string::npos)
+      continue;
+    std::string w = line.substr(b, line.find_last_not_of(" \t\r") - b + 1);
+    if (w.size() > LETTER_BUFFER_SIZE)
+      continue;
+    for (char &c : w)
+      if (c >= 'a' && c <= 'z')
+        c = (char)(c - 'a' + 'A');
+    builder.addWord(w.data(), w.size());
+  }
+  return builder.build().wordCount;
+}
+
+// Mirrors loadDictionaryImageFromSPIFFS: one buffer, validated in place.
+static uint32_t loadImage(const std::vector<uint8_t> &file, bool checkCrc) {
+  uint8_t *buf = new uint8_t[file.size()];
+  memcpy(buf, file.data(), file.size()); // stands in for File::read
+  DictImageView view;
+  uint32_t words = DictImage_open(buf, file.size(), view, checkCrc)
+                       ? view.matcher.wordCount
+                       : 0;
+  delete[] buf;
+  return words;
+}
+
+static void report(const char *label, const LoadStats &s) {
+  printf("  %-6s %9.3f ms  %7zu allocs  %9zu peak bytes  (%u words)\n", label,
+         s.ms, s.allocs, s.peak, s.words);
+}
+
+static bool benchList(const char *label, const std::string &text) {
+  // Reuse dictc's normalization by round-tripping through a temp file.
+  std::string tmpPath = std::string("dict_load_bench.") + label + ".txt";
+  {
+    std::ofstream out(tmpPath.c_str());
+    out << text;
+  }
+  bool ok = false;
+  std::vector<std::string> sorted =
+      DictCompile_readWords(tmpPath, LETTER_BUFFER_SIZE, ok);
+  remove(tmpPath.c_str());
+  std::vector<uint8_t> image;
+  if (!ok || !DictCompile_image(sorted, label, image)) {
+    fprintf(stderr, "%s: could not compile image\n", label);
+    return false;
+  }
+
+  printf("%s (%zu bytes text, %zu bytes image)\n", label, text.size(),
+         image.size());
+  LoadStats textStats = measure([&] { return loadText(text); });
+  LoadStats imageStats = measure([&] { return loadImage(image, true); });
+  LoadStats reopenStats = measure([&] { return loadImage(image, false); });
+  report("text", textStats);
+  report("image", imageStats);
+  report("reopen", reopenStats);
+  return textStats.words == imageStats.words &&
+         textStats.words == reopenStats.words;
+}
+
+static std::string syntheticText(size_t count) {
+  std::string text;
+  uint32_t state = 0xC0FFEEUL;
+  for (size_t i = 0; i < count; i++) {
+    state = state * 1664525UL + 1013904223UL;
+    size_t len = 3 + (state >> 8) % 8;
+    for (size_t j = 0; j < len; j++) {
+      state = state * 1664525UL + 1013904223UL;
+      text.push_back((char)('A' + (state >> 8) % 26));
+    }
+    text.push_back('\n');
+  }
+  return text;
+}
+
+int main(int argc, char **argv) {
+  const char *wordsPath =
+      argc > 1 ? argv[1] : "boards/esp_wroom_32/data/words.txt";
+  std::ifstream in(wordsPath, std::ios::binary);
+  if (!in) {
+    fprintf(stderr, "cannot read %s\n", wordsPath);
+    return 1;
+  }
+  std::stringstream ss;
+  ss << in.rdbuf();
+
+  bool ok = benchList("words", ss.str());
+  ok = benchList("synthetic", syntheticText(50000)) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Dictionary compiler: turns word lists into DictImage binaries that the
+// firmware uses in place (see shared/include/DictImage.h).
+//
+//   dictc [-m maxLen] [-n name] [-o out.dict] in.txt
+//   dictc [-m maxLen] [-p partition.bin] a.txt b.txt ...
+//   dictc -s [-m maxLen] [-n name] [-o out.sfx] big.txt
+//
+// Each input becomes a sibling .dict file unless -o is given. With -p the
+// images are also concatenated, in argument order, into a blob suitable for
+// flashing to the "dicts" data partition. With -s the output is instead a
+// suffix-sorted .sfx file streamed from the SD card's /dictionary folder
+// (see shared/include/SuffixDict.h), for lists too large for RAM.
+
+#include "DictImage.h"
+#include "SuffixDict.h"
+#include "dict_compile.h"
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const size_t DEFAULT_MAX_LEN = 32; // LETTER_BUFFER_SIZE
+
+static std::string baseName(const std::string &path) {
+  size_t slash = path.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+static std::string outputPathFor(const std::string &txtPath,
+                                 const char *ext) {
+  size_t dot = txtPath.find_last_of('.');
+  size_t slash = txtPath.find_last_of("/\\");
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    return txtPath + ext;
+  return txtPath.substr(0, dot) + ext;
+}
+
+static bool writeFile(const std::string &path, const std::vector<uint8_t> &d) {
+  std::ofstream f(path.c_str(), std::ios::binary);
+  f.write((const char *)d.data(), (std::streamsize)d.size());
+  return (bool)f;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: dictc [-s] [-m maxLen] [-n name] [-o out] "
+                  "[-p partition.bin] in.txt [more.txt ...]\n");
+}
+
+int main(int argc, char **argv) {
+  size_t maxLen = DEFAULT_MAX_LEN;
+  std::string outPath, name, packPath;
+  std::vector<std::string> inputs;
+  bool suffixPack = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "-s") {
+      suffixPack = true;
+    } else if (arg == "-m" && hasValue) {
+      maxLen = (size_t)strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "-n" && hasValue) {
+      name = argv[++i];
+    } else if (arg == "-o" && hasValue) {
+      outPath = argv[++i];
+    } else if (arg == "-p" && hasValue) {
+      packPath = argv[++i];
+    } else if (!arg.empty() && arg[0] == '-') {
+      usage();
+      return 2;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty() ||
+      (inputs.size() > 1 && (!outPath.empty() || !name.empty())) ||
+      (suffixPack && !packPath.empty())) {
+    usage();
+    return 2;
+  }
+
+  std::vector<uint8_t> pack;
+  int failures = 0;
+  for (const std::string &in : inputs) {
+    bool readOk = false;
+    std::vector<std::string> words =
+        DictCompile_readWords(in, maxLen, readOk);
+    if (!readOk) {
+      fprintf(stderr, "%s: cannot read\n", in.c_str());
+      failures++;
+      continue;
+    }
+
+    std::vector<uint8_t> image;
+    std::string imageName = name.empty() ? baseName(in) : name;
+    bool built = suffixPack ? DictCompile_suffixPack(words, imageName, image)
+                            : DictCompile_image(words, imageName, image);
+    if (!built) {
+      fprintf(stderr, "%s: no words, skipped\n", in.c_str());
+      continue;
+    }
+
+    std::string out =
+        outPath.empty() ? outputPathFor(in, suffixPack ? ".sfx" : ".dict")
+                        : outPath;
+    if (!writeFile(out, image)) {
+      fprintf(stderr, "%s: write failed\n", out.c_str());
+      failures++;
+      continue;
+    }
+    if (suffixPack) {
+      const SuffixDictHeader *h = (const SuffixDictHeader *)image.data();
+      printf("%s -> %s: %u words, %u blocks, %zu bytes (%u bytes RAM index)\n",
+             in.c_str(), out.c_str(), h->wordCount, h->blockCount,
+             image.size(),
+             (unsigned)(h->blockCount * h->keyLen +
+                        SUFFIX_DICT_LETTERS * sizeof(uint32_t)));
+      continue;
+    }
+    const DictImageHeader *h = (const DictImageHeader *)image.data();
+    printf("%s -> %s: %u words, %u states, %u bytes\n", in.c_str(),
+           out.c_str(), h->wordCount, h->nodeCount, h->imageSize);
+    pack.insert(pack.end(), image.begin(), image.end());
+  }
+
+  if (!packPath.empty()) {
+    if (!writeFile(packPath, pack)) {
+      fprintf(stderr, "%s: write failed\n", packPath.c_str());
+      failures++;
+    } else {
+      printf("%s: %zu bytes\n", packPath.c_str(), pack.size());
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
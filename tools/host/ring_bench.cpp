@@ -0,0 +1,117 @@
+// Host benchmark for SpscRing: the sliding letter window as a memmove'd array
+// versus a ring, and cross-thread producer/consumer throughput. Correctness
+// is covered by tests/ring_test.cpp.
+//
+//   ring_bench [items]
+
+#include "SpscRing.h"
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+static const int LETTER_BUFFER_SIZE = 32; // mirrors config_core.h
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static char letterAt(size_t n) { return (char)('A' + (n * 7) % 26); }
+
+// Previous Dictionary_appendLetter: shift the whole window once it is full.
+static uint32_t runMemmoveWindow(size_t items, char *window, int &count) {
+  uint32_t checksum = 0;
+  count = 0;
+  for (size_t n = 0; n < items; n++) {
+    if (count < LETTER_BUFFER_SIZE) {
+      window[count++] = letterAt(n);
+    } else {
+      memmove(window, window + 1, LETTER_BUFFER_SIZE - 1);
+      window[LETTER_BUFFER_SIZE - 1] = letterAt(n);
+    }
+    checksum = checksum * 31 + (uint8_t)window[count - 1];
+  }
+  return checksum;
+}
+
+static uint32_t runRingWindow(size_t items,
+                              SpscRing<char, LETTER_BUFFER_SIZE> &ring) {
+  uint32_t checksum = 0;
+  ring.clear();
+  for (size_t n = 0; n < items; n++) {
+    if (ring.full())
+      ring.drop(1);
+    ring.push(letterAt(n));
+    checksum = checksum * 31 + (uint8_t)ring.newest();
+  }
+  return checksum;
+}
+
+static void benchWindow(size_t items) {
+  char window[LETTER_BUFFER_SIZE];
+  int count = 0;
+  SpscRing<char, LETTER_BUFFER_SIZE> ring;
+
+  Clock::time_point start = Clock::now();
+  uint32_t moveSum = runMemmoveWindow(items, window, count);
+  double moveSec = secondsSince(start);
+
+  start = Clock::now();
+  uint32_t ringSum = runRingWindow(items, ring);
+  double ringSec = secondsSince(start);
+
+  printf("letter window (%d slots, %zu letters)\n", LETTER_BUFFER_SIZE, items);
+  printf("  memmove     : %12.0f letters/s\n", items / moveSec);
+  printf("  ring        : %12.0f letters/s  (%.1fx)\n", items / ringSec,
+         moveSec / ringSec);
+  // Keep the timed loops from being optimized away.
+  if (moveSum == 1 && ringSum == 1)
+    printf("  (unreachable)\n");
+}
+
+// One producer thread pushes 0..items-1 while this thread pops them. Both
+// sides yield when blocked so the run also completes on a single core.
+template <size_t N> static void benchThreads(size_t items) {
+  SpscRing<uint32_t, N> ring;
+  size_t producerStalls = 0;
+
+  Clock::time_point start = Clock::now();
+  std::thread producer([&]() {
+    for (uint32_t v = 0; v < items;) {
+      if (ring.push(v)) {
+        v++;
+      } else {
+        producerStalls++;
+        std::this_thread::yield(); // lets the consumer run on one core
+      }
+    }
+  });
+
+  size_t popped = 0;
+  while (popped < items) {
+    uint32_t v;
+    if (ring.pop(v))
+      popped++;
+    else
+      std::this_thread::yield();
+  }
+  producer.join();
+  double sec = secondsSince(start);
+
+  printf("spsc threads (%zu slots)\n", N);
+  printf("  push/pop    : %12.0f items/s  producer stalls=%zu\n", items / sec,
+         producerStalls);
+}
+
+int main(int argc, char **argv) {
+  size_t items = argc > 1 ? (size_t)strtoul(argv[1], nullptr, 10) : 20000000;
+
+  benchWindow(items);
+  benchThreads<32>(items);
+  benchThreads<1024>(items);
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Host benchmark for SensorScore: float scoring pipeline versus the Q16
+// fixed-point one, and sqrtf versus the approximate integer magnitude.
+// tests/score_test.cpp checks that the two paths agree. Timings are for the
+// host CPU, whose FPU divides and takes square roots in hardware; the
+// ESP32's FPU has no divide or square root instruction.
+//
+//   score_bench [readings]
+
+#include "ScoreReadings.h"
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void benchScore(const std::vector<SensorReadings> &readings) {
+  size_t n = readings.size();
+  std::vector<char> floatLetters(n), fixedLetters(n);
+
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < n; i++) {
+    float score = SensorScore_float(readings[i]);
+    floatLetters[i] = SensorScore_letterFromFloat(score);
+  }
+  double floatSec = secondsSince(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < n; i++)
+    fixedLetters[i] = SensorScore_letterFromQ16(SensorScore_q16(readings[i]));
+  double fixedSec = secondsSince(start);
+
+  size_t agree = 0;
+  for (size_t i = 0; i < n; i++)
+    agree += floatLetters[i] == fixedLetters[i];
+
+  printf("combined score (%zu readings)\n", n);
+  printf("  float       : %12.0f scores/s\n", n / floatSec);
+  printf("  q16         : %12.0f scores/s  (%.2fx)  letters agree %.4f%%\n",
+         n / fixedSec, floatSec / fixedSec, 100.0 * agree / n);
+}
+
+// Previous SensorScore_magnitude(): exact bit-by-bit integer square root.
+static uint32_t exactMagnitude(int32_t x, int32_t y, int32_t z) {
+  uint32_t v = (uint32_t)(x * x) + (uint32_t)(y * y) + (uint32_t)(z * z);
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > v)
+    bit >>= 2;
+  while (bit != 0) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+static void benchMagnitude(size_t count) {
+  std::mt19937 rng(99);
+  std::uniform_int_distribution<int> raw(-32768, 32767);
+  std::vector<int16_t> v(count * 3);
+  for (size_t i = 0; i < v.size(); i++)
+    v[i] = (int16_t)raw(rng);
+
+  volatile uint32_t sinkInt = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < count; i++)
+    sinkInt = sinkInt + SensorScore_magnitude(v[3 * i], v[3 * i + 1],
+                                              v[3 * i + 2]);
+  double intSec = secondsSince(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < count; i++)
+    sinkInt = sinkInt + exactMagnitude(v[3 * i], v[3 * i + 1], v[3 * i + 2]);
+  double exactSec = secondsSince(start);
+
+  volatile float sinkFloat = 0.0f;
+  start = Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    float x = v[3 * i], y = v[3 * i + 1], z = v[3 * i + 2];
+    sinkFloat = sinkFloat + sqrtf(x * x + y * y + z * z);
+  }
+  double floatSec = secondsSince(start);
+
+  printf("vector magnitude (%zu vectors)\n", count);
+  printf("  sqrtf       : %12.0f vectors/s\n", count / floatSec);
+  printf("  exact isqrt : %12.0f vectors/s  (%.2fx)\n", count / exactSec,
+         floatSec / exactSec);
+  printf("  approximate : %12.0f vectors/s  (%.2fx)\n", count / intSec,
+         floatSec / intSec);
+}
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? (size_t)strtoul(argv[1], nullptr, 10) : 2000000;
+
+  benchScore(makeScoreReadings(count));
+  benchMagnitude(count);
+  return 0;
+}
@@ -0,0 +1,144 @@
+// Sensors_* implementation for host builds, backed by a SensorTrace file.
+// Records go through the same SensorPipeline as on the device, so a trace
+// replays to the exact letter sequence it was recorded with.
+
+#include "SensorReplay.h"
+#include "SensorPipeline.h"
+#include "SensorTrace.h"
+#include "Sensors.h"
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<uint8_t> traceData;
+static size_t traceOffset = 0;
+static SensorTraceHeader traceHeader = {0, 0};
+static SensorReplaySpeed replaySpeed = SENSOR_REPLAY_MAX_SPEED;
+static bool replayOpen = false;
+
+static Clock::time_point replayStart;
+static bool haveFirstStep = false;
+static uint32_t firstStepMs = 0;
+static uint32_t stepCount = 0;
+
+static SensorSample lastSample = {0, 25.0f, 50.0f, 0, -100, 0.0f, 0, 1.0f};
+static SensorTimingStats timingStats = SensorTimingStats();
+
+bool SensorReplay_open(const char *path, SensorReplaySpeed speed) {
+  SensorReplay_close();
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    traceData.insert(traceData.end(), buf, buf + n);
+  fclose(f);
+
+  if (!SensorTrace_decodeHeader(traceData.data(), traceData.size(),
+                                traceHeader)) {
+    traceData.clear();
+    return false;
+  }
+  traceOffset = SENSOR_TRACE_HEADER_BYTES;
+  replaySpeed = speed;
+  replayOpen = true;
+  return true;
+}
+
+void SensorReplay_close() {
+  traceData.clear();
+  traceOffset = 0;
+  replayOpen = false;
+}
+
+bool SensorReplay_finished() {
+  return !replayOpen || traceOffset >= traceData.size();
+}
+
+uint32_t SensorReplay_stepCount() { return stepCount; }
+
+// Real time: has the step recorded at timestampMs come due yet?
+static bool stepDue(uint32_t timestampMs) {
+  if (replaySpeed != SENSOR_REPLAY_REAL_TIME)
+    return true;
+  if (!haveFirstStep) {
+    haveFirstStep = true;
+    firstStepMs = timestampMs;
+    replayStart = Clock::now();
+    return true;
+  }
+  uint32_t offsetMs = timestampMs - firstStepMs;
+  return Clock::now() - replayStart >= std::chrono::milliseconds(offsetMs);
+}
+
+void Sensors_configure(const SensorPins &) {}
+
+void Sensors_configureImu(const ImuConfig &) {}
+
+void Sensors_begin() {
+  SensorPipeline_begin(traceHeader.imuRateHz);
+  haveFirstStep = false;
+  stepCount = 0;
+}
+
+void Sensors_startTask() {}
+
+bool Sensors_pollLetter(char &outLetter) {
+  SensorTraceRecord rec;
+  while (replayOpen && traceOffset < traceData.size()) {
+    const uint8_t *p = traceData.data() + traceOffset;
+    size_t len = SensorTrace_decode(p, traceData.size() - traceOffset, rec);
+    if (len == 0) {
+      fprintf(stderr, "sensor trace: bad record at byte %zu\n", traceOffset);
+      traceOffset = traceData.size();
+      break;
+    }
+    if (rec.type == SENSOR_TRACE_SAMPLE && !stepDue(rec.sample.timestampMs))
+      return false;
+    traceOffset += len;
+
+    if (rec.type == SENSOR_TRACE_IMU) {
+      SensorPipeline_addImu(rec.imu);
+      timingStats.imuSamples++;
+      continue;
+    }
+    lastSample = rec.sample;
+    stepCount++;
+    timingStats.samples++;
+    if (SensorPipeline_sample(rec.sample, outLetter))
+      return true;
+  }
+  return false;
+}
+
+void Sensors_getTimingStats(SensorTimingStats &out) { out = timingStats; }
+
+void Sensors_resetTimingStats() { timingStats = SensorTimingStats(); }
+
+void Sensors_setTraceRecording(bool) {}
+
+bool Sensors_isTraceRecording() { return false; }
+
+size_t Sensors_readTrace(uint8_t *, size_t) { return 0; }
+
+float Sensors_getLastTempC() { return lastSample.tempC; }
+
+float Sensors_getLastHumidity() { return lastSample.humidity; }
+
+uint8_t Sensors_getBatteryPercent() { return 100; }
+
+uint8_t Sensors_getWifiStrengthPercent() {
+  if (lastSample.wifiCount <= 0)
+    return 0;
+  // Same -100..-30 dBm mapping as the firmware.
+  int pct = ((lastSample.wifiStrongest + 100) * 100 + 35) / 70;
+  if (pct < 0)
+    pct = 0;
+  if (pct > 100)
+    pct = 100;
+  return (uint8_t)pct;
+}
@@ -0,0 +1,224 @@
+// Converts a binary session log (.grs, see SessionLog.h) into the CSV the
+// firmware writes with logging.format "csv": the same header, columns and
+// line endings.
+//
+//   session_decode <session.grs> [out.csv]
+//   session_decode --selftest [records]
+//
+// Without out.csv the CSV goes to stdout. --selftest encodes a synthetic
+// session both ways, decodes the binary copy and fails unless the two CSVs
+// are identical; it also prints both sizes.
+
+#include "SessionLog.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static bool readFile(const char *path, std::vector<uint8_t> &out) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return false;
+  }
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    out.insert(out.end(), buf, buf + n);
+  fclose(f);
+  return true;
+}
+
+// Zeros to the end: reserved space of a pre-allocated file (logging.
+// prealloc_kb) that was not trimmed. No record is all zeros.
+static bool zeroTail(const std::vector<uint8_t> &in, size_t pos) {
+  for (; pos < in.size(); pos++) {
+    if (in[pos])
+      return false;
+  }
+  return true;
+}
+
+// Decode a whole file into CSV text. Stops at the first bad record, which
+// after a power cut is the truncated last one.
+static bool decode(const std::vector<uint8_t> &in, std::string &csv) {
+  char storage[SESSION_DICTS_MAX][SESSION_NAME_MAX + 1];
+  SessionDictNames dicts;
+  size_t pos = SessionLog_decodeBinaryHeader(in.data(), in.size(), storage,
+                                             dicts);
+  if (pos == 0) {
+    fprintf(stderr, "not a session log (bad header)\n");
+    return false;
+  }
+  csv = SessionLog_csvHeader();
+
+  SessionBinState state;
+  SessionLog_resetBinary(state);
+  std::unordered_map<uint32_t, std::string> words; // active dictionary's
+  char line[SESSION_LINE_MAX];
+  while (pos < in.size() && !zeroTail(in, pos)) {
+    SessionRecord r;
+    size_t n =
+        SessionLog_decodeBinary(in.data() + pos, in.size() - pos, state, r);
+    if (n == 0) {
+      fprintf(stderr, "stopped at byte %zu of %zu: bad or truncated record\n",
+              pos, in.size());
+      return false;
+    }
+    pos += n;
+    if (r.type == SESSION_DICT) {
+      words.clear();
+      continue;
+    }
+    if (r.type == SESSION_WORD && r.word.id != DICT_NO_WORD) {
+      if (r.word.word[0])
+        words[r.word.id] = r.word.word;
+      else if (words.count(r.word.id))
+        snprintf(r.word.word, sizeof(r.word.word), "%s",
+                 words[r.word.id].c_str());
+      else
+        snprintf(r.word.word, sizeof(r.word.word), "#%u", r.word.id);
+    }
+    csv.append(line, SessionLog_formatCsv(r, dicts, line));
+  }
+  return true;
+}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next() {
+    state = state * 1664525UL + 1013904223UL;
+    return state >> 8;
+  }
+};
+
+// A session as the firmware logs it: a letter every 200 ms with slowly
+// drifting readings, a word now and then, a timing row a minute and a
+// dictionary switch halfway.
+static std::vector<SessionRecord> synthesize(uint32_t count) {
+  static const char *const WORDS[] = {"GHOST", "COLD", "YES", "SPIRIT",
+                                      "NO",    "DARK", "HELLO"};
+  std::vector<SessionRecord> out;
+  Lcg rng = {7};
+  uint32_t ms = 1500;
+  uint32_t unixTime = 1700000000;
+  float temp = 21.4f, hum = 48.0f;
+  for (uint32_t i = 0; i < count; i++) {
+    SessionRecord r;
+    memset(&r, 0, sizeof(r));
+    ms += 200 + rng.next() % 8;
+    if (i == count / 4)
+      unixTime = 0; // clock lost
+    r.ms = ms;
+    r.unixTime = unixTime ? unixTime + ms / 1000 : 0;
+    uint32_t pick = rng.next() % 100;
+    if (i % 300 == 299) {
+      r.type = SESSION_TIMING;
+      r.timing.samples = 300;
+      r.timing.jitterSumUs = 300ULL * (rng.next() % 900);
+      r.timing.maxJitterUs = rng.next() % 5000;
+      r.timing.maxSampleUs = rng.next() % 20000;
+      r.timing.imuSamples = 15000;
+      r.timing.droppedLetters = i / 1000;
+    } else if (pick < 8) {
+      uint32_t w = rng.next() % 7;
+      r.type = SESSION_WORD;
+      snprintf(r.word.word, sizeof(r.word.word), "%s", WORDS[w]);
+      bool sdList = i > count * 3 / 4;
+      r.word.id = sdList ? DICT_NO_WORD : w * 37;
+      r.word.dict = i < count / 2 ? 3 : (sdList ? 4 : 0);
+      r.word.tags = r.word.dict == 3 ? (uint8_t)(1 + w % 7) : 0;
+    } else if (pick < 9) {
+      r.type = SESSION_TEXT;
+      snprintf(r.text, sizeof(r.text), "touch,tap,%u,x=%u;y=%u", i,
+               rng.next() % 320, rng.next() % 240);
+    } else {
+      r.type = SESSION_LETTER;
+      r.letter.letter = (char)('A' + rng.next() % 26);
+      if (i % 10 == 0) { // DHT22: 0.1 steps every 2 s
+        temp += ((int)(rng.next() % 3) - 1) * 0.1f;
+        hum += ((int)(rng.next() % 5) - 2) * 0.1f;
+      }
+      r.letter.tempC = pick == 99 ? NAN : temp;
+      r.letter.humidity = hum;
+    }
+    out.push_back(r);
+  }
+  return out;
+}
+
+static int selftest(uint32_t count) {
+  static const char *const NAMES[] = {"Default", "Paranormal", "Short",
+                                      "All", "ghosts_big"};
+  SessionDictNames dicts;
+  dicts.count = 5;
+  for (uint8_t i = 0; i < dicts.count; i++)
+    dicts.names[i] = NAMES[i];
+
+  std::vector<SessionRecord> records = synthesize(count);
+  std::string csv = SessionLog_csvHeader();
+  std::vector<uint8_t> bin(SESSION_BIN_HEADER_MAX);
+  bin.resize(SessionLog_encodeBinaryHeader(bin.data(), dicts));
+  SessionBinState state;
+  SessionLog_resetBinary(state);
+  char line[SESSION_LINE_MAX];
+  uint8_t rec[SESSION_LINE_MAX];
+  size_t letterBytes = 0, letters = 0;
+  for (const SessionRecord &r : records) {
+    csv.append(line, SessionLog_formatCsv(r, dicts, line));
+    size_t n = SessionLog_encodeBinary(r, state, rec);
+    bin.insert(bin.end(), rec, rec + n);
+    if (r.type == SESSION_LETTER) {
+      letterBytes += n;
+      letters++;
+    }
+  }
+
+  std::string decoded;
+  if (!decode(bin, decoded))
+    return 1;
+  printf("%u records: csv %zu bytes, binary %zu bytes (%.1f%%), "
+         "%.1f bytes per letter\n",
+         count, csv.size(), bin.size(), 100.0 * bin.size() / csv.size(),
+         letters ? (double)letterBytes / letters : 0.0);
+  if (decoded != csv) {
+    size_t i = 0;
+    while (i < csv.size() && i < decoded.size() && csv[i] == decoded[i])
+      i++;
+    size_t from = csv.rfind('\n', i);
+    from = from == std::string::npos ? 0 : from + 1;
+    printf("  MISMATCH at byte %zu:\n  csv:     %.80s\n  decoded: %.80s\n",
+           i, csv.c_str() + from, decoded.c_str() + from);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: session_decode <session.grs> [out.csv]\n"
+                    "       session_decode --selftest [records]\n");
+    return 2;
+  }
+  if (strcmp(argv[1], "--selftest") == 0)
+    return selftest(argc > 2 ? strtoul(argv[2], nullptr, 10) : 20000);
+
+  std::vector<uint8_t> in;
+  if (!readFile(argv[1], in))
+    return 1;
+  std::string csv;
+  bool ok = decode(in, csv);
+  FILE *out = argc > 2 ? fopen(argv[2], "wb") : stdout;
+  if (!out) {
+    fprintf(stderr, "cannot write %s\n", argv[2]);
+    return 1;
+  }
+  fwrite(csv.data(), 1, csv.size(), out);
+  if (out != stdout)
+    fclose(out);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Control surface of the host simulator: the virtual clock, the cooperative
+// FreeRTOS scheduler, the directory-backed file systems and the emulated
+// display and sensors. Firmware code never includes this; only the
+// simulator and benchmarks do.
+//
+// Everything runs on virtual time. FreeRTOS tasks are real threads, but
+// only one thread (the main loop or one task) runs at a time: a task runs
+// until it blocks in vTaskDelay()/vTaskDelayUntil(), and the clock only
+// moves in Sim_advanceUs() or delay(). Runs are therefore reproducible.
+// ESP.getCycleCount() is the exception: it follows the host clock at
+// 240 MHz, so cycle-counter profiling measures the host's real work.
+
+// Virtual clock in microseconds since boot.
+uint64_t Sim_nowUs();
+// Move the clock forward, running every task that becomes due on the way.
+void Sim_advanceUs(uint64_t us);
+// Run tasks already due at the current time.
+void Sim_runDueTasks();
+uint32_t Sim_taskCount();
+
+// Charge `ns` of CPU time spent driving a peripheral (a blocking SPI write)
+// to the caller. On the main loop this moves the clock, running tasks that
+// fall due. Tasks stand for the other core: a task is held until the time
+// has passed while the main loop carries on. Returns whether the main loop
+// was charged.
+bool Sim_cpuBusyNs(uint64_t ns);
+
+// GPIO output levels as last set by digitalWrite() or gpio_set_level().
+int Sim_gpioLevel(uint8_t pin);
+
+// Directories backing SD and SPIFFS. Paths inside the firmware are mapped
+// below these roots. An empty SD root makes SD.begin() fail (no card).
+void Sim_setSdRoot(const char *dir);
+void Sim_setSpiffsRoot(const char *dir);
+
+// The SD card is timed on its SPI bus at the clock given to SD.begin(), in
+// whole commands: writes pay 1 ms of card busy time, reads 0.2 ms, plus
+// 512 bytes per sector moved. File data passes through a one-sector cache
+// per file as in FatFs; flush() and close() write the cached sector and the
+// directory entry, and every path component looked up reads a sector. Like
+// the panel, the time blocks the main loop but not tasks.
+struct SimSdStats {
+  uint32_t opens;         // files and directories opened
+  uint32_t lookups;       // paths resolved (open, exists, mkdir, ...)
+  uint32_t writeCalls;    // File::write() calls
+  uint32_t flushes;       // flush()/close() calls with data to write back
+  uint32_t commands;      // card commands
+  uint32_t fatWrites;     // FAT and FSINFO sectors written
+  uint64_t sectorsWritten;
+  uint64_t busUs;         // card time, all callers
+  uint64_t loopBlockedUs; // the part the main loop waited for
+};
+void Sim_getSdStats(SimSdStats &out);
+void Sim_resetSdStats();
+
+// Serial output goes to this stream (stdout by default); nullptr drops it.
+void Sim_setSerialOutput(FILE *out);
+
+// Emulated peripherals. The IMU produces synthetic motion at the rate the
+// firmware programs; without it Adafruit_MPU6050::begin() fails.
+void Sim_setImuPresent(bool present);
+void Sim_setWifiNetworkCount(int count);
+
+// Emulated panel. The framebuffer holds what the glass shows in the current
+// rotation, after hardware scrolling. The SPI link is timed at the clock
+// given to begin(): a CPU-driven window costs its bytes plus a fixed
+// command overhead and blocks the caller; DMA transactions (driver/
+// spi_master.h) queue on the same bus and only block when the firmware
+// waits for a result.
+struct SimDisplayStats {
+  uint64_t pixelsWritten; // pixels sent to the controller
+  uint32_t windows;       // address windows set (transactions)
+  uint64_t cpuBusUs;      // bus time driven by the CPU (caller blocked)
+  uint64_t dmaBusUs;      // bus time of DMA transactions
+  uint64_t dmaWaitUs;     // time the main loop blocked on DMA results
+};
+int16_t Sim_displayWidth();
+int16_t Sim_displayHeight();
+uint16_t Sim_displayPixel(int16_t x, int16_t y);
+void Sim_getDisplayStats(SimDisplayStats &out);
+void Sim_resetDisplayStats();
+bool Sim_writeDisplayPpm(const char *path);
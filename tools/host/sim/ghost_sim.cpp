@@ -0,0 +1,159 @@
+// Runs the unmodified esp_wroom_32 setup()/loop() on the host against the
+// simulator shims, on virtual time, and reports what the firmware did.
+//
+//   ghost_sim [--sd <dir>] [--spiffs <dir>] [--seconds N] [--tick-ms N]
+//             [--dump frame.ppm] [--quiet]
+//
+// --sd backs the SD card with a directory (no card when omitted); --spiffs
+// defaults to the board's data/ directory. Each loop() iteration advances
+// the clock by --tick-ms, running the sensor and WiFi tasks as they become
+// due. --dump writes the final panel contents as a binary PPM.
+
+#include "SimHost.h"
+#include <chrono>
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+
+void setup();
+void loop();
+
+#ifndef GHOST_SIM_DATA_DIR
+#define GHOST_SIM_DATA_DIR "boards/esp_wroom_32/data"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Print every regular file below dir with its size.
+static void listFiles(const std::string &dir, const std::string &rel) {
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return;
+  while (dirent *e = readdir(d)) {
+    if (e->d_name[0] == '.')
+      continue;
+    std::string path = dir + "/" + e->d_name;
+    std::string name = rel + "/" + e->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+      continue;
+    if (S_ISDIR(st.st_mode))
+      listFiles(path, name);
+    else
+      printf("  %-32s %8lld bytes\n", name.c_str(), (long long)st.st_size);
+  }
+  closedir(d);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: ghost_sim [--sd <dir>] [--spiffs <dir>] "
+                  "[--seconds N] [--tick-ms N] [--dump frame.ppm] "
+                  "[--quiet]\n");
+}
+
+int main(int argc, char **argv) {
+  const char *sdDir = "";
+  const char *spiffsDir = GHOST_SIM_DATA_DIR;
+  const char *dumpPath = nullptr;
+  double seconds = 60;
+  uint32_t tickMs = 10;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--sd") && hasValue) {
+      sdDir = argv[++i];
+    } else if (!strcmp(argv[i], "--spiffs") && hasValue) {
+      spiffsDir = argv[++i];
+    } else if (!strcmp(argv[i], "--seconds") && hasValue) {
+      seconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--tick-ms") && hasValue) {
+      tickMs = (uint32_t)atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--dump") && hasValue) {
+      dumpPath = argv[++i];
+    } else if (!strcmp(argv[i], "--quiet")) {
+      quiet = true;
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (tickMs == 0 || seconds <= 0) {
+    usage();
+    return 2;
+  }
+
+  Sim_setSdRoot(sdDir);
+  Sim_setSpiffsRoot(spiffsDir);
+  if (quiet)
+    Sim_setSerialOutput(nullptr);
+
+  Clock::time_point t0 = Clock::now();
+  setup();
+  uint64_t bootUs = Sim_nowUs();
+  Sim_resetDisplayStats(); // rates below cover the loop() run only
+  Sim_resetSdStats();
+
+  uint64_t endUs = bootUs + (uint64_t)(seconds * 1e6);
+  uint64_t loops = 0;
+  while (Sim_nowUs() < endUs) {
+    loop();
+    loops++;
+    Sim_advanceUs((uint64_t)tickMs * 1000);
+  }
+  double wallS = std::chrono::duration<double>(Clock::now() - t0).count();
+  double simS = (Sim_nowUs() - bootUs) / 1e6;
+
+  SimDisplayStats ds;
+  Sim_getDisplayStats(ds);
+  fflush(stdout);
+  printf("\n--- ghost_sim ---\n");
+  printf("virtual time : %.1f s (+%.1f s boot), %llu loops (%.1f/s), %u "
+         "tasks\n",
+         simS, bootUs / 1e6, (unsigned long long)loops,
+         simS > 0 ? loops / simS : 0.0, Sim_taskCount());
+  printf("wall time    : %.3f s (%.0fx real time)\n", wallS,
+         wallS > 0 ? (simS + bootUs / 1e6) / wallS : 0.0);
+  printf("display      : %llu pixels in %u windows (%.0f px/s, %.1f "
+         "windows/s)\n",
+         (unsigned long long)ds.pixelsWritten, ds.windows,
+         simS > 0 ? ds.pixelsWritten / simS : 0.0,
+         simS > 0 ? ds.windows / simS : 0.0);
+  // The loop task blocks for CPU-driven transfers and for DMA results.
+  double runUs = simS * 1e6;
+  double blockedUs = (double)ds.cpuBusUs + (double)ds.dmaWaitUs;
+  printf("spi bus      : %.1f s CPU-driven + %.1f s DMA (%.0f%% busy); loop "
+         "blocked %.1f%%, idle %.1f%%\n",
+         ds.cpuBusUs / 1e6, ds.dmaBusUs / 1e6,
+         runUs > 0 ? 100.0 * (ds.cpuBusUs + ds.dmaBusUs) / runUs : 0.0,
+         runUs > 0 ? 100.0 * blockedUs / runUs : 0.0,
+         runUs > 0 ? 100.0 * (runUs - blockedUs) / runUs : 0.0);
+  if (sdDir[0]) {
+    SimSdStats sd;
+    Sim_getSdStats(sd);
+    printf("sd card      : %u commands, %llu sectors written (%u FAT), "
+           "%.2f s busy; loop blocked %.2f%%\n",
+           sd.commands, (unsigned long long)sd.sectorsWritten, sd.fatWrites,
+           sd.busUs / 1e6,
+           runUs > 0 ? 100.0 * sd.loopBlockedUs / runUs : 0.0);
+    listFiles(sdDir, "");
+  }
+
+  int rc = 0;
+  if (dumpPath) {
+    if (Sim_writeDisplayPpm(dumpPath)) {
+      printf("frame        : %s (%dx%d)\n", dumpPath, Sim_displayWidth(),
+             Sim_displayHeight());
+    } else {
+      fprintf(stderr, "cannot write %s\n", dumpPath);
+      rc = 1;
+    }
+  }
+  fflush(stdout);
+  // The firmware tasks never return; leave them parked.
+  _Exit(rc);
+}
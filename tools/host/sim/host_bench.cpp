@@ -0,0 +1,428 @@
+// Google Benchmark suite over the firmware's hot paths, built against the
+// simulator shims: dictionary matching, sensor scoring, and rendering into
+// canvases and the emulated panel. Rendering benchmarks report the pixels
+// and address windows each frame sends to the controller, which is what the
+// SPI bus pays for on the device.
+//
+//   host_bench [--benchmark_filter=<regex>] [--benchmark_min_time=<s>]
+
+#include "BoardConfig.h"
+#include "DictMatcher.h"
+#include "Display.h"
+#include "GlyphCache.h"
+#include "SDManager.h"
+#include "SensorScore.h"
+#include "Settings.h"
+#include "SimHost.h"
+#include "WifiRadar.h"
+#include "config_core.h"
+#include "dict_compile.h"
+#include <Adafruit_GFX.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#ifndef GHOST_SIM_DATA_DIR
+#define GHOST_SIM_DATA_DIR "boards/esp_wroom_32/data"
+#endif
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next() {
+    state = state * 1664525UL + 1013904223UL;
+    return state >> 8;
+  }
+};
+
+// --- Dictionary ---
+
+static void BM_DictMatcherStep(benchmark::State &state) {
+  bool ok = false;
+  std::vector<std::string> words = DictCompile_readWords(
+      std::string(GHOST_SIM_DATA_DIR) + "/words.txt", 32, ok);
+  if (!ok || words.empty()) {
+    state.SkipWithError("cannot read words.txt");
+    return;
+  }
+  DictMatcherBuilder builder;
+  for (const std::string &w : words)
+    builder.addWord(w.c_str(), w.size());
+  DictMatcher m = builder.build();
+
+  std::vector<char> letters(4096);
+  Lcg rng = {0x5EEDUL};
+  for (char &c : letters)
+    c = (char)('A' + rng.next() % 26);
+
+  uint32_t s = DICT_ROOT_STATE;
+  uint32_t hits = 0;
+  for (auto _ : state) {
+    for (char c : letters) {
+      s = DictMatcher_step(m, s, c);
+      hits += DictMatcher_matchAt(m, s) != DICT_NO_WORD;
+    }
+  }
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations() * letters.size());
+}
+BENCHMARK(BM_DictMatcherStep);
+
+// --- Sensor scoring ---
+
+static std::vector<SensorReadings> makeReadings(size_t count) {
+  std::vector<SensorReadings> v(count);
+  Lcg rng = {1234};
+  for (SensorReadings &r : v) {
+    r.tempC = 15.0f + (rng.next() % 2000) / 100.0f;
+    r.humidity = 20.0f + (rng.next() % 6000) / 100.0f;
+    r.accelMag = 9.0f + (rng.next() % 300) / 100.0f;
+    r.gyroMag = (rng.next() % 200) / 100.0f;
+    r.accelVar = (rng.next() % 400) / 100.0f;
+    r.gyroVar = (rng.next() % 100) / 100.0f;
+    r.hallRaw = (int16_t)(rng.next() % 80) - 40;
+    r.wifiStrongest = -(int16_t)(30 + rng.next() % 60);
+    r.wifiVariance = (rng.next() % 30000) / 100.0f;
+    r.wifiCount = (int16_t)(rng.next() % 12);
+    r.varianceScale = 1.0f;
+    r.noise = (uint8_t)rng.next();
+  }
+  return v;
+}
+
+static void BM_SensorScoreFloat(benchmark::State &state) {
+  std::vector<SensorReadings> readings = makeReadings(1024);
+  uint32_t sum = 0;
+  for (auto _ : state) {
+    for (const SensorReadings &r : readings)
+      sum += (uint8_t)SensorScore_letterFromFloat(SensorScore_float(r));
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations() * readings.size());
+}
+BENCHMARK(BM_SensorScoreFloat);
+
+static void BM_SensorScoreQ16(benchmark::State &state) {
+  std::vector<SensorReadings> readings = makeReadings(1024);
+  uint32_t sum = 0;
+  for (auto _ : state) {
+    for (const SensorReadings &r : readings)
+      sum += (uint8_t)SensorScore_letterFromQ16(SensorScore_q16(r));
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations() * readings.size());
+}
+BENCHMARK(BM_SensorScoreQ16);
+
+// --- Rendering ---
+
+// Bring up the panel and the static frame once, as setup() does, without
+// starting the sampling or scan tasks.
+static void initDisplayOnce() {
+  static bool ready = false;
+  if (ready)
+    return;
+  ready = true;
+  Sim_setSerialOutput(nullptr);
+  Sim_setSpiffsRoot(GHOST_SIM_DATA_DIR);
+  Settings_loadDefaults();
+  Board_initPins();
+  Board_initDisplay();
+  Display_begin();
+  Display_applyBrightness(Settings_get().brightnessLevel);
+  Display_drawStaticFrame();
+  WifiRadar_begin();
+}
+
+static void reportPanelTraffic(benchmark::State &state) {
+  SimDisplayStats st;
+  Sim_getDisplayStats(st);
+  double frames = (double)state.iterations();
+  state.counters["px/frame"] = frames ? st.pixelsWritten / frames : 0;
+  state.counters["windows/frame"] = frames ? st.windows / frames : 0;
+  // Virtual time the loop spends blocked on the SPI bus.
+  state.counters["blocked_us/frame"] =
+      frames ? (st.cpuBusUs + st.dmaWaitUs) / frames : 0;
+}
+
+// A radar-like frame drawn into a 16-bit canvas: rings, cross hairs, a
+// sweep line, a few blips and labels.
+static void BM_Canvas16RadarFrame(benchmark::State &state) {
+  GFXcanvas16 canvas(160, 160);
+  int frame = 0;
+  for (auto _ : state) {
+    canvas.fillScreen(0x0000);
+    for (int r = 25; r <= 75; r += 25)
+      canvas.drawCircle(80, 80, r, 0x4208);
+    canvas.drawFastHLine(5, 80, 150, 0x4208);
+    canvas.drawFastVLine(80, 5, 150, 0x4208);
+    int sx = (frame * 7) % 150 + 5;
+    canvas.drawLine(80, 80, sx, 5, 0xF800);
+    for (int i = 0; i < 8; i++)
+      canvas.fillCircle(20 + i * 15, 40 + (i * 37) % 80, 3, 0xF800);
+    canvas.setFont();
+    canvas.setTextColor(0xC618);
+    canvas.setCursor(4, 4);
+    canvas.print("8 APs");
+    canvas.setFont(&FreeSans12pt7b);
+    canvas.setCursor(40, 150);
+    canvas.print("GHOST");
+    canvas.setFont();
+    frame++;
+  }
+  benchmark::DoNotOptimize(canvas.getBuffer());
+}
+BENCHMARK(BM_Canvas16RadarFrame);
+
+// Display_dimColor() over a spread of RGB565 colours, 256 per iteration.
+static void BM_DimColor(benchmark::State &state) {
+  initDisplayOnce();
+  uint16_t colors[256];
+  Lcg rng = {7};
+  for (uint16_t &c : colors)
+    c = (uint16_t)rng.next();
+  for (auto _ : state) {
+    uint16_t acc = 0;
+    for (uint16_t c : colors)
+      acc ^= Display_dimColor(c);
+    benchmark::DoNotOptimize(acc);
+  }
+  state.SetItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_DimColor);
+
+// One glyph per iteration into a canvas, cycling through the digits and
+// capitals: Adafruit_GFX print() versus the glyph cache. Arg 0 is the
+// built-in 5x7 font, arg 1 FreeSans 12pt.
+static const GFXfont *benchFont(int64_t arg) {
+  return arg == 0 ? nullptr : &FreeSans12pt7b;
+}
+
+static const char GLYPH_CYCLE[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+static void BM_GlyphDrawGfx(benchmark::State &state) {
+  const GFXfont *font = benchFont(state.range(0));
+  GFXcanvas16 canvas(64, 48);
+  canvas.setFont(font);
+  canvas.setTextWrap(false);
+  canvas.setTextColor(0xF800);
+  size_t i = 0;
+  for (auto _ : state) {
+    canvas.setCursor(8, font ? 32 : 8);
+    canvas.write((uint8_t)GLYPH_CYCLE[i]);
+    i = (i + 1) % (sizeof(GLYPH_CYCLE) - 1);
+  }
+  benchmark::DoNotOptimize(canvas.getBuffer());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GlyphDrawGfx)->Arg(0)->Arg(1);
+
+static void BM_GlyphDrawCache(benchmark::State &state) {
+  const GFXfont *font = benchFont(state.range(0));
+  GlyphCache_addFont(font);
+  GFXcanvas16 canvas(64, 48);
+  size_t i = 0;
+  for (auto _ : state) {
+    char text[2] = {GLYPH_CYCLE[i], '\0'};
+    GlyphCache_drawText(canvas, font, 8, font ? 32 : 8, text, 0xF800);
+    i = (i + 1) % (sizeof(GLYPH_CYCLE) - 1);
+  }
+  benchmark::DoNotOptimize(canvas.getBuffer());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GlyphDrawCache)->Arg(0)->Arg(1);
+
+// Bounds of a complication-sized string, as layout code asks for them.
+static void BM_TextBoundsGfx(benchmark::State &state) {
+  const GFXfont *font = benchFont(state.range(0));
+  GFXcanvas16 canvas(160, 160);
+  canvas.setFont(font);
+  int16_t x1, y1;
+  uint16_t w, h;
+  for (auto _ : state) {
+    canvas.getTextBounds("HUM 45%", 0, 0, &x1, &y1, &w, &h);
+    benchmark::DoNotOptimize(w);
+  }
+}
+BENCHMARK(BM_TextBoundsGfx)->Arg(0)->Arg(1);
+
+static void BM_TextBoundsCache(benchmark::State &state) {
+  const GFXfont *font = benchFont(state.range(0));
+  int16_t x1, y1;
+  uint16_t w, h;
+  for (auto _ : state) {
+    GlyphCache_textBounds(font, "HUM 45%", x1, y1, w, h);
+    benchmark::DoNotOptimize(w);
+  }
+}
+BENCHMARK(BM_TextBoundsCache)->Arg(0)->Arg(1);
+
+// Pushing a full-width canvas to the panel, the CPU driving SPI.
+static void BM_PanelPushCanvas(benchmark::State &state) {
+  initDisplayOnce();
+  GFXcanvas16 canvas(HEARTBEAT_W, HEARTBEAT_H);
+  canvas.fillScreen(0x1234);
+  Adafruit_ILI9341 &tft = Display_tft();
+  Sim_resetDisplayStats();
+  for (auto _ : state)
+    tft.drawRGBBitmap(0, 0, canvas.getBuffer(), HEARTBEAT_W, HEARTBEAT_H);
+  reportPanelTraffic(state);
+}
+BENCHMARK(BM_PanelPushCanvas);
+
+// The same canvas through Display_blit(), which queues it for SPI DMA. Each
+// frame is followed by 5 ms of other work, as in the loop.
+static void BM_DisplayBlit(benchmark::State &state) {
+  initDisplayOnce();
+  GFXcanvas16 canvas(HEARTBEAT_W, HEARTBEAT_H);
+  canvas.fillScreen(0x1234);
+  Display_waitBlits();
+  Sim_resetDisplayStats();
+  for (auto _ : state) {
+    Display_blit(0, 0, HEARTBEAT_W, HEARTBEAT_H, canvas.getBuffer(),
+                 HEARTBEAT_W);
+    Sim_advanceUs(5000);
+  }
+  Display_waitBlits();
+  reportPanelTraffic(state);
+}
+BENCHMARK(BM_DisplayBlit);
+
+// The heartbeat strip at the loop rate (10 ms per frame) and the given BPM,
+// with a letter every 28 columns of scroll so the strip stays populated.
+static void BM_DisplayHeartbeat(benchmark::State &state) {
+  initDisplayOnce();
+  uint16_t bpm = (uint16_t)state.range(0);
+  int letterFrames = 100 * 120 / bpm; // 1 s at 120 BPM
+  Display_setHeartbeatBpm(bpm);
+  Sim_resetDisplayStats();
+  int frame = 0;
+  for (auto _ : state) {
+    Sim_advanceUs(10000);
+    Display_heartbeatStep(frame % letterFrames == 0 ? (char)('A' + frame % 26)
+                                                    : 0);
+    Display_updateHeartbeat();
+    frame++;
+  }
+  reportPanelTraffic(state);
+  Display_setHeartbeatBpm(Settings_get().heartbeatBpm);
+}
+BENCHMARK(BM_DisplayHeartbeat)->Arg(120)->Arg(240);
+
+// One radar frame per iteration (the 40 ms frame cap), with the scan cache
+// refreshed by WifiRadar_update() as the scan task would.
+static void BM_WifiRadarDraw(benchmark::State &state) {
+  initDisplayOnce();
+  Sim_resetDisplayStats();
+  for (auto _ : state) {
+    Sim_advanceUs(40000);
+    WifiRadar_update();
+    WifiRadar_draw();
+  }
+  reportPanelTraffic(state);
+}
+BENCHMARK(BM_WifiRadarDraw);
+
+// A dictionary hit: the overlay word, then its fade over the next frames.
+static void BM_DisplayWord(benchmark::State &state) {
+  initDisplayOnce();
+  Sim_resetDisplayStats();
+  int frame = 0;
+  for (auto _ : state) {
+    Sim_advanceUs(10000);
+    if (frame % 100 == 0)
+      Display_displayWord("PHANTOM");
+    Display_drawOverlayWord();
+    frame++;
+  }
+  reportPanelTraffic(state);
+}
+BENCHMARK(BM_DisplayWord);
+
+// --- Session log ---
+
+// An SD card in a fresh temporary directory with a session log open.
+static void initSessionLogOnce() {
+  static bool ready = false;
+  if (ready)
+    return;
+  ready = true;
+  initDisplayOnce();
+  static char sdDir[] = "/tmp/ghost_bench_sd_XXXXXX";
+  if (!mkdtemp(sdDir))
+    return;
+  Sim_setSdRoot(sdDir);
+  Board_initPins();
+  SDManager::begin(Board_getSdSpi(), Board_getSdCsPin());
+  SDManager::ensureDirectories();
+  SDManager::startSessionLog();
+}
+
+// Logging a letter once per sample period, as loop() does. The time is the
+// call alone; blocked_us/call is SD card time the loop waited for, which the
+// writer task takes off it. The argument is logging.prealloc_kb for a fresh
+// session; fat_writes counts FAT sectors the card wrote as the file grew and
+// max_write_us is the writer's longest block, flush or reservation.
+static void BM_SessionLogLetter(benchmark::State &state) {
+  initSessionLogOnce();
+  Settings_get().logPreallocKb = (uint16_t)state.range(0);
+  SDManager::startSessionLog();
+  Sim_resetSdStats();
+  int i = 0;
+  for (auto _ : state) {
+    SDManager::logSessionLetter((char)('A' + i++ % 26), 21.5f, 40.2f);
+    state.PauseTiming();
+    Sim_advanceUs(SAMPLE_PERIOD_MS * 1000);
+    state.ResumeTiming();
+  }
+  SimSdStats sd;
+  Sim_getSdStats(sd);
+  SDManager::SessionLogStats ls;
+  SDManager::getSessionLogStats(ls);
+  double calls = (double)state.iterations();
+  state.counters["blocked_us/call"] = calls ? sd.loopBlockedUs / calls : 0;
+  state.counters["card_us/call"] = calls ? sd.busUs / calls : 0;
+  state.counters["dropped"] = ls.dropped;
+  SDManager::endSessionLog();
+  Sim_getSdStats(sd);
+  SDManager::getSessionLogStats(ls);
+  state.counters["fat_writes"] = sd.fatWrites;
+  state.counters["max_write_us"] = ls.maxWriteUs;
+}
+BENCHMARK(BM_SessionLogLetter)->Arg(0)->Arg(256)->Iterations(20000);
+
+// One event a second through SDManager::logEvent(). The counters are SD
+// card operations per event, from opens and path lookups down to card
+// commands, and the card time the loop waited for.
+static void BM_EventLog(benchmark::State &state) {
+  initSessionLogOnce();
+  Sim_resetSdStats();
+  int i = 0;
+  for (auto _ : state) {
+    SDManager::logEvent(LOG_LEVEL_INFO, "Dictionary switched to list %d", i++);
+    state.PauseTiming();
+    Sim_advanceUs(1000000);
+    state.ResumeTiming();
+  }
+  SimSdStats sd;
+  Sim_getSdStats(sd);
+  double events = (double)state.iterations();
+  if (events == 0)
+    return;
+  state.counters["opens/event"] = sd.opens / events;
+  state.counters["lookups/event"] = sd.lookups / events;
+  state.counters["writes/event"] = sd.writeCalls / events;
+  state.counters["flushes/event"] = sd.flushes / events;
+  state.counters["commands/event"] = sd.commands / events;
+  state.counters["blocked_us/event"] = sd.loopBlockedUs / events;
+  SDManager::EventLogStats es;
+  SDManager::getEventLogStats(es);
+  state.counters["dropped"] = es.dropped;
+  state.counters["rotations"] = es.rotations;
+}
+BENCHMARK(BM_EventLog)->Iterations(5000);
+
+BENCHMARK_MAIN();
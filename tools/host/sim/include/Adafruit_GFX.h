@@ -0,0 +1,153 @@
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+// Adafruit_GFX subset for the host. Primitives follow the library's
+// algorithms, so the same pixels are touched as on the device. Glyph shapes
+// are generated placeholders (the FreeSans bitmaps are not redistributed
+// here) with realistic metrics, so text costs and positions are right even
+// though letters do not look like letters.
+
+struct GFXglyph {
+  uint16_t bitmapOffset;
+  uint8_t width;
+  uint8_t height;
+  uint8_t xAdvance;
+  int8_t xOffset;
+  int8_t yOffset;
+};
+
+struct GFXfont {
+  uint8_t *bitmap;
+  GFXglyph *glyph;
+  uint16_t first;
+  uint16_t last;
+  uint8_t yAdvance;
+};
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite() {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) {
+    drawPixel(x, y, color);
+  }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color);
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                              uint16_t color);
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                              uint16_t color);
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         uint16_t color);
+  virtual void endWrite() {}
+
+  virtual void setRotation(uint8_t r);
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color);
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners,
+                        uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners,
+                        int16_t delta, uint16_t color);
+  void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                     uint16_t color);
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r,
+                     uint16_t color);
+  void drawRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w,
+                     int16_t h);
+  virtual void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+                             int16_t w, int16_t h);
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t size);
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h);
+  void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h) {
+    getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s > 0 ? s : 1; }
+  void setFont(const GFXfont *f = nullptr);
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) {
+    textcolor = c;
+    textbgcolor = bg;
+  }
+  void setTextWrap(bool w) { wrap = w; }
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+  uint8_t getRotation() const { return rotation; }
+  int16_t getCursorX() const { return cursor_x; }
+  int16_t getCursorY() const { return cursor_y; }
+
+protected:
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx,
+                  int16_t *miny, int16_t *maxx, int16_t *maxy);
+
+  int16_t WIDTH;
+  int16_t HEIGHT;
+  int16_t _width;
+  int16_t _height;
+  int16_t cursor_x = 0;
+  int16_t cursor_y = 0;
+  uint16_t textcolor = 0xFFFF;
+  uint16_t textbgcolor = 0xFFFF;
+  uint8_t textsize_x = 1;
+  uint8_t textsize_y = 1;
+  uint8_t rotation = 0;
+  bool wrap = true;
+  const GFXfont *gfxFont = nullptr;
+};
+
+// Off-screen canvases; the buffer is always allocated on the host.
+class GFXcanvas16 : public Adafruit_GFX {
+public:
+  GFXcanvas16(uint16_t w, uint16_t h);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  uint16_t *getBuffer() const { return const_cast<uint16_t *>(buffer.data()); }
+
+private:
+  bool toRaw(int16_t &x, int16_t &y) const;
+  std::vector<uint16_t> buffer;
+};
+
+class GFXcanvas8 : public Adafruit_GFX {
+public:
+  GFXcanvas8(uint16_t w, uint16_t h);
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  uint8_t getPixel(int16_t x, int16_t y) const;
+  uint8_t *getBuffer() const { return const_cast<uint8_t *>(buffer.data()); }
+
+private:
+  bool toRaw(int16_t &x, int16_t &y) const;
+  std::vector<uint8_t> buffer;
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <Adafruit_GFX.h>
+#include <SPI.h>
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_BLACK 0x0000
+#define ILI9341_WHITE 0xFFFF
+#define ILI9341_RED 0xF800
+#define ILI9341_GREEN 0x07E0
+#define ILI9341_BLUE 0x001F
+
+// SPI panel driver over an emulated controller. GRAM is 240x320 in panel
+// order; rotation and vertical scrolling are applied the way the ILI9341
+// does (mirroring aside), and every address window and pixel sent is counted
+// and timed so host runs can compare how much a frame costs on the bus.
+class Adafruit_SPITFT : public Adafruit_GFX {
+public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override {
+    drawPixel(x, y, color);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                     uint16_t color) override {
+    fillRect(x, y, w, h, color);
+  }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                      uint16_t color) override {
+    fillRect(x, y, 1, h, color);
+  }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                      uint16_t color) override {
+    fillRect(x, y, w, 1, color);
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    fillRect(x, y, 1, h, color);
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    fillRect(x, y, w, 1, color);
+  }
+  void fillScreen(uint16_t color) override {
+    fillRect(0, 0, _width, _height, color);
+  }
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w,
+                     int16_t h) override;
+
+  void startWrite() override {}
+  void endWrite() override {}
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true,
+                   bool bigEndian = false);
+  void writeColor(uint16_t color, uint32_t len);
+  void dmaWait() {}
+  bool dmaBusy() const { return false; }
+  // Pins the host SPI master samples for the DMA path (host only).
+  int8_t simCsPin() const { return csPin; }
+  int8_t simDcPin() const { return dcPin; }
+
+protected:
+  void storeWindowPixel(uint16_t color);
+  void storePixel(int16_t x, int16_t y, uint16_t color);
+
+  int16_t winX = 0, winY = 0, winW = 0, winH = 0;
+  int32_t winPos = 0;
+  int8_t csPin = -1; // the DMA path honours CS and DC; see spi_master.h
+  int8_t dcPin = -1;
+};
+
+class Adafruit_ILI9341 : public Adafruit_SPITFT {
+public:
+  Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+  Adafruit_ILI9341(SPIClass *spi, int8_t dc, int8_t cs = -1, int8_t rst = -1);
+
+  void begin(uint32_t freq = 0);
+  void setRotation(uint8_t r) override;
+  void invertDisplay(bool invert) { (void)invert; }
+  void scrollTo(uint16_t y);
+  void setScrollMargins(uint16_t top, uint16_t bottom);
+};
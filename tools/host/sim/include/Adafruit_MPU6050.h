@@ -0,0 +1,45 @@
+#pragma once
+#include <Adafruit_Sensor.h>
+#include <Wire.h>
+
+typedef enum {
+  MPU6050_BAND_260_HZ,
+  MPU6050_BAND_184_HZ,
+  MPU6050_BAND_94_HZ,
+  MPU6050_BAND_44_HZ,
+  MPU6050_BAND_21_HZ,
+  MPU6050_BAND_10_HZ,
+  MPU6050_BAND_5_HZ,
+} mpu6050_bandwidth_t;
+
+typedef enum {
+  MPU6050_RANGE_2_G,
+  MPU6050_RANGE_4_G,
+  MPU6050_RANGE_8_G,
+  MPU6050_RANGE_16_G,
+} mpu6050_accel_range_t;
+
+typedef enum {
+  MPU6050_RANGE_250_DEG,
+  MPU6050_RANGE_500_DEG,
+  MPU6050_RANGE_1000_DEG,
+  MPU6050_RANGE_2000_DEG,
+} mpu6050_gyro_range_t;
+
+// Driver subset over the emulated device: configuration goes to the same
+// registers the real driver writes.
+class Adafruit_MPU6050 {
+public:
+  bool begin(uint8_t address = 0x68, TwoWire *wire = &Wire);
+  void setAccelerometerRange(mpu6050_accel_range_t range);
+  void setGyroRange(mpu6050_gyro_range_t range);
+  void setFilterBandwidth(mpu6050_bandwidth_t bandwidth);
+  void setSampleRateDivisor(uint8_t divisor);
+  bool getEvent(sensors_event_t *accel, sensors_event_t *gyro,
+                sensors_event_t *temp);
+
+private:
+  void writeReg(uint8_t reg, uint8_t value);
+  TwoWire *wire = &Wire;
+  uint8_t address = 0x68;
+};
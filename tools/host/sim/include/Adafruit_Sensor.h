@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+struct sensors_vec_t {
+  float x;
+  float y;
+  float z;
+};
+
+struct sensors_event_t {
+  int32_t version;
+  int32_t sensor_id;
+  int32_t type;
+  int32_t timestamp;
+  sensors_vec_t acceleration;
+  sensors_vec_t gyro;
+  float temperature;
+};
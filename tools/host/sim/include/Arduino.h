@@ -0,0 +1,207 @@
+#pragma once
+// Host stand-in for the subset of the ESP32 Arduino core used by shared/ and
+// the board glue. Time is virtual (see SimHost.h): millis()/micros() only
+// move when the simulator advances the clock or code calls delay().
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define PI 3.1415926535897932384626433832795
+#define F(s) (s)
+#define IRAM_ATTR
+#define OUTPUT 0x03
+#define INPUT 0x01
+#define HIGH 0x1
+#define LOW 0x0
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class String {
+public:
+  String() {}
+  String(const char *s) : str(s ? s : "") {}
+  String(const std::string &s) : str(s) {}
+  explicit String(char c) : str(1, c) {}
+  String(int v) : str(std::to_string(v)) {}
+  String(unsigned int v) : str(std::to_string(v)) {}
+  String(long v) : str(std::to_string(v)) {}
+  String(unsigned long v) : str(std::to_string(v)) {}
+  String(long long v) : str(std::to_string(v)) {}
+  String(unsigned long long v) : str(std::to_string(v)) {}
+  String(unsigned char v) : str(std::to_string(v)) {}
+  String(float v, unsigned int decimals = 2) { setFloat(v, decimals); }
+  String(double v, unsigned int decimals = 2) { setFloat(v, decimals); }
+
+  unsigned int length() const { return (unsigned int)str.size(); }
+  const char *c_str() const { return str.c_str(); }
+  bool reserve(unsigned int size) {
+    str.reserve(size);
+    return true;
+  }
+  char charAt(unsigned int i) const { return i < str.size() ? str[i] : 0; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char &operator[](unsigned int i) { return str[i]; }
+
+  bool concat(const String &s) {
+    str += s.str;
+    return true;
+  }
+  String &operator+=(const String &s) {
+    str += s.str;
+    return *this;
+  }
+  String &operator+=(const char *s) {
+    str += s ? s : "";
+    return *this;
+  }
+  String &operator+=(char c) {
+    str += c;
+    return *this;
+  }
+
+  bool operator==(const String &o) const { return str == o.str; }
+  bool operator==(const char *o) const { return str == (o ? o : ""); }
+  bool operator!=(const String &o) const { return str != o.str; }
+  bool operator!=(const char *o) const { return !(*this == o); }
+  bool operator<(const String &o) const { return str < o.str; }
+  bool equals(const String &o) const { return str == o.str; }
+  bool equalsIgnoreCase(const String &o) const;
+  bool startsWith(const String &p) const {
+    return str.compare(0, p.str.size(), p.str) == 0;
+  }
+  bool endsWith(const String &s) const {
+    return str.size() >= s.str.size() &&
+           str.compare(str.size() - s.str.size(), s.str.size(), s.str) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String &s, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  String substring(unsigned int from) const;
+  String substring(unsigned int from, unsigned int to) const;
+
+  void replace(const String &find, const String &with);
+  void remove(unsigned int index) { remove(index, length()); }
+  void remove(unsigned int index, unsigned int count);
+  void toUpperCase();
+  void toLowerCase();
+  void trim();
+  long toInt() const { return strtol(str.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(str.c_str(), nullptr); }
+
+  friend String operator+(const String &a, const String &b) {
+    return String(a.str + b.str);
+  }
+  friend String operator+(const String &a, const char *b) {
+    return String(a.str + (b ? b : ""));
+  }
+  friend String operator+(const char *a, const String &b) {
+    return String((a ? a : "") + b.str);
+  }
+  friend String operator+(const String &a, char c) {
+    return String(a.str + c);
+  }
+
+private:
+  void setFloat(double v, unsigned int decimals);
+  std::string str;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size);
+  size_t write(const char *s) {
+    return s ? write((const uint8_t *)s, strlen(s)) : 0;
+  }
+
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) {
+    return print((unsigned long)v, base);
+  }
+  size_t print(long v, int base = 10);
+  size_t print(unsigned long v, int base = 10);
+  size_t print(long long v) { return printf("%lld", v); }
+  size_t print(unsigned long long v) { return printf("%llu", v); }
+  size_t print(unsigned char v, int base = 10) {
+    return print((unsigned long)v, base);
+  }
+  size_t print(double v, int decimals = 2) {
+    return printf("%.*f", decimals, v);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename T> size_t println(const T &v, int arg) {
+    size_t n = print(v, arg);
+    return n + println();
+  }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  String readStringUntil(char terminator);
+};
+
+// Serial writes to stdout unless the simulator silences it.
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  using Print::write;
+};
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int hallRead();
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long max);
+long random(long min, long max);
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz() { return 240; }
+};
+extern EspClass ESP;
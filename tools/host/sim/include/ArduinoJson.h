@@ -0,0 +1,153 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// The slice of the ArduinoJson 6/7 API that SDManager uses: documents,
+// object access, `value | default` reads, to<JsonObject>(), and pretty
+// serialization to and from a Stream. Values live in a plain tree; capacity
+// arguments are accepted and ignored.
+
+struct JsonNode {
+  enum Type { Null, Bool, Int, Float, Str, Object, Array } type = Null;
+  bool b = false;
+  long long i = 0;
+  double f = 0;
+  std::string s;
+  std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> members;
+  std::vector<std::unique_ptr<JsonNode>> items;
+
+  JsonNode *find(const char *key) const;
+  JsonNode *getOrAdd(const char *key);
+  void clear();
+};
+
+class JsonObject;
+
+// A value, or the place where one would be created on assignment.
+class JsonVariant {
+public:
+  JsonVariant() {}
+  JsonVariant(JsonNode *parent, const std::string &key, JsonNode *node)
+      : parent(parent), key(key), node(node) {}
+
+  JsonVariant operator[](const char *k) const;
+  JsonVariant operator[](const String &k) const { return (*this)[k.c_str()]; }
+
+  template <typename T> bool is() const;
+  template <typename T> T as() const;
+  template <typename T> T to();
+
+  JsonVariant &operator=(bool v);
+  JsonVariant &operator=(int v) { return setInt(v); }
+  JsonVariant &operator=(unsigned int v) { return setInt(v); }
+  JsonVariant &operator=(long v) { return setInt(v); }
+  JsonVariant &operator=(unsigned long v) { return setInt((long long)v); }
+  JsonVariant &operator=(unsigned char v) { return setInt(v); }
+  JsonVariant &operator=(unsigned short v) { return setInt(v); }
+  JsonVariant &operator=(short v) { return setInt(v); }
+  JsonVariant &operator=(float v) { return setFloat(v); }
+  JsonVariant &operator=(double v) { return setFloat(v); }
+  JsonVariant &operator=(const char *v);
+  JsonVariant &operator=(const String &v) { return *this = v.c_str(); }
+
+  // Reads with a fallback when the value is missing or of another type.
+  const char *operator|(const char *def) const;
+  const char *operator|(std::nullptr_t) const {
+    return *this | (const char *)nullptr;
+  }
+  bool operator|(bool def) const;
+  int operator|(int def) const { return (int)intOr(def); }
+  unsigned int operator|(unsigned int def) const {
+    return (unsigned int)intOr(def);
+  }
+  long operator|(long def) const { return (long)intOr(def); }
+  unsigned char operator|(unsigned char def) const {
+    return (unsigned char)intOr(def);
+  }
+  unsigned short operator|(unsigned short def) const {
+    return (unsigned short)intOr(def);
+  }
+  float operator|(float def) const { return (float)floatOr(def); }
+  double operator|(double def) const { return floatOr(def); }
+
+  bool isNull() const { return !node || node->type == JsonNode::Null; }
+  JsonNode *raw() const { return node; }
+
+protected:
+  JsonNode *materialize();
+  JsonVariant &setInt(long long v);
+  JsonVariant &setFloat(double v);
+  long long intOr(long long def) const;
+  double floatOr(double def) const;
+
+  JsonNode *parent = nullptr;
+  std::string key;
+  JsonNode *node = nullptr;
+};
+
+class JsonObject : public JsonVariant {
+public:
+  JsonObject() {}
+  explicit JsonObject(const JsonVariant &v) : JsonVariant(v) {}
+};
+
+template <> inline bool JsonVariant::is<JsonObject>() const {
+  return node && node->type == JsonNode::Object;
+}
+template <> inline bool JsonVariant::is<const char *>() const {
+  return node && node->type == JsonNode::Str;
+}
+template <> inline bool JsonVariant::is<bool>() const {
+  return node && node->type == JsonNode::Bool;
+}
+template <> inline bool JsonVariant::is<int>() const {
+  return node && node->type == JsonNode::Int;
+}
+
+template <> inline JsonObject JsonVariant::as<JsonObject>() const {
+  return is<JsonObject>() ? JsonObject(*this) : JsonObject();
+}
+template <> inline const char *JsonVariant::as<const char *>() const {
+  return *this | (const char *)nullptr;
+}
+template <> inline String JsonVariant::as<String>() const {
+  return String(*this | "");
+}
+template <> inline int JsonVariant::as<int>() const { return *this | 0; }
+template <> inline bool JsonVariant::as<bool>() const { return *this | false; }
+
+template <> JsonObject JsonVariant::to<JsonObject>();
+
+class JsonDocument : public JsonVariant {
+public:
+  explicit JsonDocument(size_t capacity = 0)
+      : JsonVariant(nullptr, std::string(), nullptr), root(new JsonNode()) {
+    (void)capacity;
+    node = root.get();
+  }
+  void clear() { root->clear(); }
+
+private:
+  std::unique_ptr<JsonNode> root;
+};
+
+typedef JsonDocument DynamicJsonDocument;
+
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory };
+  DeserializationError(Code code = Ok) : code(code) {}
+  explicit operator bool() const { return code != Ok; }
+  const char *c_str() const;
+  Code value() const { return code; }
+
+private:
+  Code code;
+};
+
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input);
+DeserializationError deserializeJson(JsonDocument &doc, const char *input);
+size_t serializeJson(const JsonVariant &src, Print &out);
+size_t serializeJsonPretty(const JsonVariant &src, Print &out);
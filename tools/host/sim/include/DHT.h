@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+#define DHT11 11
+#define DHT22 22
+
+// Emulated DHT: slow sinusoidal drift of temperature and humidity plus
+// sensor-resolution noise, as a function of virtual time.
+class DHT {
+public:
+  DHT(uint8_t pin, uint8_t type) : pin(pin), type(type) {}
+  void begin() {}
+  float readTemperature(bool fahrenheit = false);
+  float readHumidity();
+
+private:
+  uint8_t pin;
+  uint8_t type;
+};
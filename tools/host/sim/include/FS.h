@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+
+// File systems backed by a host directory (Sim_setSdRoot/Sim_setSpiffsRoot).
+// Modes follow the ESP32 core: FILE_WRITE truncates, FILE_APPEND appends.
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+namespace fs {
+
+struct FileImpl;
+
+class File : public Stream {
+public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t *buf, size_t size);
+  void flush() override;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  const char *name() const;
+  const char *path() const;
+  bool isDirectory() const;
+  File openNextFile(const char *mode = FILE_READ);
+  void rewindDirectory();
+
+private:
+  std::shared_ptr<FileImpl> impl;
+};
+
+class FS {
+public:
+  explicit FS(const char *label) : label(label) {}
+  File open(const char *path, const char *mode = FILE_READ,
+            bool create = false);
+  File open(const String &path, const char *mode = FILE_READ) {
+    return open(path.c_str(), mode);
+  }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool rename(const char *from, const char *to);
+  bool mkdir(const char *path);
+  bool rmdir(const char *path);
+  void setRoot(const char *dir);
+  bool mounted() const { return !root.empty(); }
+
+protected:
+  std::string hostPath(const char *path) const;
+  bool timed() const; // SD card accesses are timed (see SimHost.h)
+  const char *label;
+  std::string root;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
@@ -0,0 +1,5 @@
+#pragma once
+#include <Adafruit_GFX.h>
+
+// Placeholder glyphs with FreeSans 24pt metrics (see Adafruit_GFX.h).
+extern const GFXfont FreeSans24pt7b;
@@ -0,0 +1,5 @@
+#pragma once
+#include <Adafruit_GFX.h>
+
+// Placeholder glyphs with FreeSans 9pt metrics (see Adafruit_GFX.h).
+extern const GFXfont FreeSans9pt7b;
@@ -0,0 +1,18 @@
+#pragma once
+#include <FS.h>
+#include <SPI.h>
+
+class SDFS : public fs::FS {
+public:
+  SDFS() : fs::FS("SD") {}
+  // Fails like a missing card when no SD root directory is set.
+  bool begin(uint8_t ssPin = 5, SPIClass &spi = SPI,
+             uint32_t frequency = 4000000, const char *mountpoint = "/sd",
+             uint8_t maxFiles = 5, bool formatIfEmpty = false);
+  void end() {}
+  uint64_t cardSize();
+  // Not in the ESP32 SD library: stands in for truncate() on the card's
+  // mount point, which the ESP32 FAT VFS provides.
+  bool truncate(const char *path, uint32_t size);
+};
+extern SDFS SD;
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+
+#define VSPI 3
+#define HSPI 2
+
+// Buses carry nothing on the host; the devices on them are emulated
+// directly.
+class SPIClass {
+public:
+  explicit SPIClass(uint8_t bus = VSPI) : bus(bus) {}
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1,
+             int8_t ss = -1) {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+  void end() {}
+
+private:
+  uint8_t bus;
+};
+extern SPIClass SPI;
@@ -0,0 +1,11 @@
+#pragma once
+#include <FS.h>
+
+class SPIFFSFS : public fs::FS {
+public:
+  SPIFFSFS() : fs::FS("SPIFFS") {}
+  bool begin(bool formatOnFail = false, const char *basePath = "/spiffs",
+             uint8_t maxOpenFiles = 10, const char *partitionLabel = nullptr);
+  void end() {}
+};
+extern SPIFFSFS SPIFFS;
@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+
+#define WIFI_STA 1
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+// Scans finish a fixed virtual time after they start and report a
+// synthetic set of access points whose RSSI drifts between scans.
+class WiFiClass {
+public:
+  bool mode(int m) {
+    (void)m;
+    return true;
+  }
+  bool disconnect(bool wifiOff = false) {
+    (void)wifiOff;
+    return true;
+  }
+  int16_t scanNetworks(bool async = false, bool showHidden = false);
+  int16_t scanComplete();
+  void scanDelete();
+  int32_t RSSI(uint8_t i);
+  int32_t channel(uint8_t i);
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// I2C bus with an emulated MPU6050 at 0x68 (see sim_devices.cpp). Other
+// addresses do not acknowledge.
+class TwoWire {
+public:
+  bool begin() { return true; }
+  bool begin(int sda, int scl, uint32_t frequency = 0) {
+    (void)sda;
+    (void)scl;
+    (void)frequency;
+    return true;
+  }
+  void setClock(uint32_t frequency) { clockHz = frequency; }
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t value);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity);
+  int available() { return (int)(rxLen - rxPos); }
+  int read() { return rxPos < rxLen ? rxBuf[rxPos++] : -1; }
+
+  uint32_t clockHz = 100000;
+
+private:
+  uint8_t txAddress = 0;
+  uint8_t txBuf[32];
+  size_t txLen = 0;
+  uint8_t rxBuf[128]; // the ESP32 Wire buffer size
+  size_t rxLen = 0;
+  size_t rxPos = 0;
+};
+extern TwoWire Wire;
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+class TS_Point {
+public:
+  TS_Point() : x(0), y(0), z(0) {}
+  TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+// Nobody touches the headless simulator: the panel never reports a touch.
+class XPT2046_Touchscreen {
+public:
+  explicit XPT2046_Touchscreen(uint8_t csPin, uint8_t irqPin = 255)
+      : csPin(csPin), irqPin(irqPin) {}
+  bool begin() { return true; }
+  void setRotation(uint8_t r) { rotation = r; }
+  bool touched() { return false; }
+  TS_Point getPoint() { return TS_Point(); }
+
+private:
+  uint8_t csPin;
+  uint8_t irqPin;
+  uint8_t rotation = 1;
+};
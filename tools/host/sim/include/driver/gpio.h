@@ -0,0 +1,10 @@
+#pragma once
+#include <esp_err.h>
+#include <stdint.h>
+
+// Host subset of the ESP-IDF GPIO driver. Levels are shared with
+// digitalWrite() (see Sim_gpioLevel()).
+
+typedef int gpio_num_t;
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level);
@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Host heap capabilities: every allocation is DMA-capable. The free and
+// largest-block sizes are fixed at what an ESP32 typically reports after
+// boot (see EspClass::getFreeHeap), so size checks behave as on a board.
+
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_8BIT (1 << 2)
+
+inline void *heap_caps_malloc(size_t size, uint32_t caps) {
+  (void)caps;
+  return malloc(size);
+}
+
+inline void heap_caps_free(void *ptr) { free(ptr); }
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+  (void)caps;
+  return 200 * 1024;
+}
+
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  (void)caps;
+  return 110 * 1024;
+}
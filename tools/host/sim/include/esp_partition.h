@@ -0,0 +1,42 @@
+#pragma once
+#include <esp_err.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// No flash partitions on the host: lookups find nothing.
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef enum {
+  ESP_PARTITION_MMAP_DATA,
+  ESP_PARTITION_MMAP_INST,
+} esp_partition_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+inline const esp_partition_t *
+esp_partition_find_first(esp_partition_type_t, esp_partition_subtype_t,
+                         const char *) {
+  return nullptr;
+}
+
+inline esp_err_t esp_partition_mmap(const esp_partition_t *, size_t, size_t,
+                                    esp_partition_mmap_memory_t,
+                                    const void **, spi_flash_mmap_handle_t *) {
+  return ESP_ERR_NOT_FOUND;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "FreeRTOS.h"
+
+// Mutexes only. Tasks never preempt each other on the host, so a mutex is
+// free whenever another thread gets to run unless its holder blocked while
+// holding it, which the firmware never does.
+typedef struct SimSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
@@ -0,0 +1,13 @@
+#pragma once
+#include "FreeRTOS.h"
+
+TickType_t xTaskGetTickCount();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stackDepth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       uint32_t stackDepth, void *param, UBaseType_t priority,
+                       TaskHandle_t *handle);
@@ -0,0 +1,405 @@
+// Virtual clock, cooperative FreeRTOS scheduler and the Arduino core
+// functions that do not belong to a peripheral.
+
+#include "SimHost.h"
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <ctype.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- Scheduler ---
+
+// A task thread only runs while `running` points at it; the main thread
+// waits meanwhile. Control changes hands under schedMutex, so the clock and
+// all firmware state are only ever touched by one thread at a time.
+struct SimTask {
+  TaskFunction_t fn;
+  void *param;
+  uint64_t wakeUs;
+  std::condition_variable cv;
+};
+
+static std::mutex schedMutex;
+static std::condition_variable mainCv;
+static std::vector<SimTask *> tasks; // creation order breaks wake-time ties
+static SimTask *running = nullptr;
+static thread_local SimTask *selfTask = nullptr;
+static uint64_t nowUs = 0;
+
+static void taskEntry(SimTask *t) {
+  selfTask = t;
+  {
+    std::unique_lock<std::mutex> lock(schedMutex);
+    t->cv.wait(lock, [t] { return running == t; });
+  }
+  t->fn(t->param);
+  // FreeRTOS tasks must not return; treat it as the task deleting itself.
+  std::unique_lock<std::mutex> lock(schedMutex);
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (tasks[i] == t) {
+      tasks.erase(tasks.begin() + i);
+      break;
+    }
+  }
+  running = nullptr;
+  mainCv.notify_one();
+}
+
+// Main thread: hand control to t until it blocks again.
+static void resume(std::unique_lock<std::mutex> &lock, SimTask *t) {
+  running = t;
+  t->cv.notify_one();
+  mainCv.wait(lock, [] { return running == nullptr; });
+}
+
+// Task thread: give control back to the main thread until wakeUs.
+static void blockUntil(uint64_t wakeUs) {
+  std::unique_lock<std::mutex> lock(schedMutex);
+  SimTask *t = selfTask;
+  t->wakeUs = wakeUs;
+  running = nullptr;
+  mainCv.notify_one();
+  t->cv.wait(lock, [t] { return running == t; });
+}
+
+static SimTask *nextDue(uint64_t limitUs) {
+  SimTask *best = nullptr;
+  for (SimTask *t : tasks) {
+    if (t->wakeUs <= limitUs && (!best || t->wakeUs < best->wakeUs))
+      best = t;
+  }
+  return best;
+}
+
+uint64_t Sim_nowUs() { return nowUs; }
+
+void Sim_advanceUs(uint64_t us) {
+  std::unique_lock<std::mutex> lock(schedMutex);
+  uint64_t target = nowUs + us;
+  while (SimTask *t = nextDue(target)) {
+    if (t->wakeUs > nowUs)
+      nowUs = t->wakeUs;
+    resume(lock, t);
+  }
+  nowUs = target;
+}
+
+void Sim_runDueTasks() { Sim_advanceUs(0); }
+
+bool Sim_cpuBusyNs(uint64_t ns) {
+  static thread_local uint64_t carryNs = 0; // sub-microsecond remainder
+  carryNs += ns;
+  uint64_t us = carryNs / 1000;
+  carryNs %= 1000;
+  if (selfTask) {
+    if (us > 0)
+      blockUntil(nowUs + us); // the other core is busy; the loop runs on
+    return false;
+  }
+  if (us > 0)
+    Sim_advanceUs(us);
+  return true;
+}
+
+uint32_t Sim_taskCount() {
+  std::lock_guard<std::mutex> lock(schedMutex);
+  return (uint32_t)tasks.size();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stackDepth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core) {
+  (void)name;
+  (void)stackDepth;
+  (void)priority;
+  (void)core;
+  SimTask *t = new SimTask();
+  t->fn = fn;
+  t->param = param;
+  t->wakeUs = nowUs; // first runs at the next scheduling point
+  {
+    std::lock_guard<std::mutex> lock(schedMutex);
+    tasks.push_back(t);
+  }
+  // Detached: tasks run forever and are abandoned when the simulator exits.
+  std::thread(taskEntry, t).detach();
+  if (handle)
+    *handle = t;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       uint32_t stackDepth, void *param, UBaseType_t priority,
+                       TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle,
+                                 0);
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(nowUs / 1000); }
+
+void vTaskDelay(TickType_t ticks) {
+  if (selfTask)
+    blockUntil(nowUs + (uint64_t)ticks * 1000);
+  else
+    Sim_advanceUs((uint64_t)ticks * 1000);
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period) {
+  *previousWake += period;
+  uint64_t wakeUs = (uint64_t)*previousWake * 1000;
+  if (wakeUs <= nowUs)
+    return; // already late: FreeRTOS returns without blocking
+  if (selfTask)
+    blockUntil(wakeUs);
+  else
+    Sim_advanceUs(wakeUs - nowUs);
+}
+
+struct SimSemaphore {
+  int held;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new SimSemaphore{0}; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout) {
+  (void)timeout;
+  if (!sem || sem->held)
+    return pdFALSE;
+  sem->held = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  if (!sem || !sem->held)
+    return pdFALSE;
+  sem->held = 0;
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+// --- Arduino core ---
+
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+
+unsigned long micros() { return (unsigned long)nowUs; }
+
+void delay(unsigned long ms) { vTaskDelay((TickType_t)ms); }
+
+void delayMicroseconds(unsigned int us) {
+  if (!selfTask)
+    Sim_advanceUs(us);
+}
+
+void yield() {}
+
+static uint8_t gpioLevels[64];
+
+int Sim_gpioLevel(uint8_t pin) { return pin < 64 ? gpioLevels[pin] : LOW; }
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < 64)
+    gpioLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t) { return LOW; }
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) {
+  if (gpio < 0 || gpio >= 64)
+    return ESP_ERR_INVALID_ARG;
+  gpioLevels[gpio] = level ? HIGH : LOW;
+  return ESP_OK;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+static uint32_t randomState = 1;
+
+long random(long max) {
+  if (max <= 0)
+    return 0;
+  randomState = randomState * 1664525UL + 1013904223UL;
+  return (long)((randomState >> 8) % (uint32_t)max);
+}
+
+long random(long min, long max) {
+  return min >= max ? min : min + random(max - min);
+}
+
+double ledcSetup(uint8_t, double freq, uint8_t) { return freq; }
+void ledcAttachPin(uint8_t, uint8_t) {}
+void ledcWrite(uint8_t, uint32_t) {}
+
+EspClass ESP;
+
+// Heap is not tracked on the host; report a typical idle figure.
+uint32_t EspClass::getFreeHeap() { return 200 * 1024; }
+
+// Virtual time stands still inside loop(), so the cycle counter follows the
+// host's clock instead; profilers then measure the host doing real work.
+uint32_t EspClass::getCycleCount() {
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+  return (uint32_t)(ns * getCpuFreqMHz() / 1000);
+}
+
+// --- Serial ---
+
+static FILE *serialOut = stdout;
+
+void Sim_setSerialOutput(FILE *out) { serialOut = out; }
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (serialOut && c != '\r')
+    fputc(c, serialOut);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t size) {
+  for (size_t i = 0; i < size; i++)
+    write(buf[i]);
+  return size;
+}
+
+// --- Print / Stream ---
+
+size_t Print::write(const uint8_t *buf, size_t size) {
+  size_t n = 0;
+  while (size--)
+    n += write(*buf++);
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  if (base == 10)
+    return printf("%ld", v);
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  if (base == 16)
+    return printf("%lX", v);
+  if (base == 8)
+    return printf("%lo", v);
+  return printf("%lu", v);
+}
+
+size_t Print::printf(const char *fmt, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  if ((size_t)len < sizeof(buf))
+    return write((const uint8_t *)buf, (size_t)len);
+  std::string big((size_t)len + 1, '\0');
+  va_start(args, fmt);
+  vsnprintf(&big[0], big.size(), fmt, args);
+  va_end(args);
+  return write((const uint8_t *)big.data(), (size_t)len);
+}
+
+String Stream::readStringUntil(char terminator) {
+  std::string out;
+  int c;
+  while ((c = read()) >= 0 && c != terminator)
+    out += (char)c;
+  return String(out);
+}
+
+// --- String ---
+
+void String::setFloat(double v, unsigned int decimals) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+  str = buf;
+}
+
+bool String::equalsIgnoreCase(const String &o) const {
+  if (str.size() != o.str.size())
+    return false;
+  for (size_t i = 0; i < str.size(); i++) {
+    if (tolower((unsigned char)str[i]) != tolower((unsigned char)o.str[i]))
+      return false;
+  }
+  return true;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t pos = str.find(c, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &s, unsigned int from) const {
+  size_t pos = str.find(s.str, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t pos = str.rfind(c);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+  return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to)
+    std::swap(from, to);
+  if (from >= str.size())
+    return String();
+  return String(str.substr(from, to - from));
+}
+
+void String::replace(const String &find, const String &with) {
+  if (find.str.empty())
+    return;
+  size_t pos = 0;
+  while ((pos = str.find(find.str, pos)) != std::string::npos) {
+    str.replace(pos, find.str.size(), with.str);
+    pos += with.str.size();
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < str.size())
+    str.erase(index, count);
+}
+
+void String::toUpperCase() {
+  for (char &c : str)
+    c = (char)toupper((unsigned char)c);
+}
+
+void String::toLowerCase() {
+  for (char &c : str)
+    c = (char)tolower((unsigned char)c);
+}
+
+void String::trim() {
+  size_t begin = 0;
+  size_t end = str.size();
+  while (begin < end && isspace((unsigned char)str[begin]))
+    begin++;
+  while (end > begin && isspace((unsigned char)str[end - 1]))
+    end--;
+  str = str.substr(begin, end - begin);
+}
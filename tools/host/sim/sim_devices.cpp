@@ -0,0 +1,383 @@
+// Emulated sensors and radios: an MPU6050 on the I2C bus with a working
+// FIFO, the DHT, the hall sensor and WiFi scans. All readings are
+// deterministic functions of virtual time, so simulator runs repeat exactly.
+
+#include "SimHost.h"
+#include <Adafruit_MPU6050.h>
+#include <Arduino.h>
+#include <DHT.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <deque>
+
+TwoWire Wire;
+WiFiClass WiFi;
+
+static uint32_t hash32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352dUL;
+  x ^= x >> 15;
+  x *= 0x846ca68bUL;
+  x ^= x >> 16;
+  return x;
+}
+
+// Uniform in [-1, 1].
+static float noise(uint32_t seed) {
+  return (float)(hash32(seed) & 0xFFFF) / 32767.5f - 1.0f;
+}
+
+// --- MPU6050 ---
+
+namespace {
+
+const uint8_t MPU_ADDR = 0x68;
+const uint8_t REG_SMPLRT_DIV = 0x19;
+const uint8_t REG_CONFIG = 0x1A;
+const uint8_t REG_GYRO_CONFIG = 0x1B;
+const uint8_t REG_ACCEL_CONFIG = 0x1C;
+const uint8_t REG_FIFO_EN = 0x23;
+const uint8_t REG_INT_STATUS = 0x3A;
+const uint8_t REG_ACCEL_XOUT_H = 0x3B;
+const uint8_t REG_USER_CTRL = 0x6A;
+const uint8_t REG_PWR_MGMT_1 = 0x6B;
+const uint8_t REG_FIFO_COUNTH = 0x72;
+const uint8_t REG_FIFO_COUNTL = 0x73;
+const uint8_t REG_FIFO_R_W = 0x74;
+const uint8_t REG_WHO_AM_I = 0x75;
+const uint8_t USER_CTRL_FIFO_EN = 0x40;
+const uint8_t USER_CTRL_FIFO_RESET = 0x04;
+const uint8_t FIFO_EN_ACCEL_GYRO = 0x78;
+const uint8_t INT_FIFO_OFLOW = 0x10;
+const size_t FIFO_BYTES = 1024;
+
+// Fixed scales matching the firmware's configuration (+-8 g, +-500 dps).
+const float ACCEL_LSB_PER_G = 4096.0f;
+const float GYRO_LSB_PER_DPS = 65.5f;
+
+struct Mpu6050 {
+  bool present = true;
+  uint8_t regs[128] = {};
+  uint8_t pointer = 0;
+  std::deque<uint8_t> fifo;
+  uint64_t nextSampleUs = 0;
+  uint32_t sampleIndex = 0;
+  uint8_t data[14] = {}; // ACCEL_XOUT_H .. GYRO_ZOUT_L
+
+  uint32_t rateHz() const {
+    uint8_t dlpf = regs[REG_CONFIG] & 0x07;
+    uint32_t base = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+    return base / (1U + regs[REG_SMPLRT_DIV]);
+  }
+
+  bool fifoRunning() const {
+    return (regs[REG_USER_CTRL] & USER_CTRL_FIFO_EN) &&
+           (regs[REG_FIFO_EN] & FIFO_EN_ACCEL_GYRO) == FIFO_EN_ACCEL_GYRO;
+  }
+
+  // At rest with gravity on Z, shaken for 1.6 s out of every 8 s.
+  void makeSample(uint32_t index, int16_t out[7]) {
+    uint32_t rate = rateHz();
+    uint32_t ms = (uint32_t)((uint64_t)index * 1000 / (rate ? rate : 1));
+    bool shaking = (ms % 8000) >= 6400;
+    float accelAmp = shaking ? 0.6f : 0.01f; // g
+    float gyroAmp = shaking ? 120.0f : 0.5f; // deg/s
+    float gravity[3] = {0.0f, 0.0f, 1.0f};
+    for (int a = 0; a < 3; a++) {
+      float g = gravity[a] + accelAmp * noise(index * 8 + a);
+      out[a] = (int16_t)(g * ACCEL_LSB_PER_G);
+      out[4 + a] =
+          (int16_t)(gyroAmp * noise(index * 8 + 4 + a) * GYRO_LSB_PER_DPS);
+    }
+    out[3] = 0; // temperature word, unused
+  }
+
+  void latch(const int16_t s[7]) {
+    for (int i = 0; i < 7; i++) {
+      data[2 * i] = (uint8_t)((uint16_t)s[i] >> 8);
+      data[2 * i + 1] = (uint8_t)(s[i] & 0xFF);
+    }
+  }
+
+  void pushFifo(const int16_t s[7]) {
+    const int order[6] = {0, 1, 2, 4, 5, 6}; // accel xyz, gyro xyz
+    for (int i = 0; i < 6; i++) {
+      if (fifo.size() >= FIFO_BYTES) {
+        fifo.pop_front(); // overflow overwrites the oldest byte
+        regs[REG_INT_STATUS] |= INT_FIFO_OFLOW;
+      }
+      uint16_t v = (uint16_t)s[order[i]];
+      fifo.push_back((uint8_t)(v >> 8));
+      if (fifo.size() >= FIFO_BYTES) {
+        fifo.pop_front();
+        regs[REG_INT_STATUS] |= INT_FIFO_OFLOW;
+      }
+      fifo.push_back((uint8_t)(v & 0xFF));
+    }
+  }
+
+  // Produce every sample due by now.
+  void sync() {
+    uint32_t rate = rateHz();
+    if (rate == 0)
+      return;
+    uint64_t periodUs = 1000000ULL / rate;
+    uint64_t now = Sim_nowUs();
+    if (nextSampleUs == 0)
+      nextSampleUs = now;
+    // Only the last FIFO's worth can matter; skip older samples.
+    uint64_t maxBacklog = FIFO_BYTES / 12 + 1;
+    if (now > nextSampleUs + maxBacklog * periodUs) {
+      uint64_t skip = (now - nextSampleUs) / periodUs - maxBacklog;
+      sampleIndex += (uint32_t)skip;
+      nextSampleUs += skip * periodUs;
+      if (fifoRunning())
+        regs[REG_INT_STATUS] |= INT_FIFO_OFLOW;
+    }
+    while (nextSampleUs <= now) {
+      int16_t s[7];
+      makeSample(sampleIndex++, s);
+      latch(s);
+      if (fifoRunning())
+        pushFifo(s);
+      nextSampleUs += periodUs;
+    }
+  }
+
+  void write(uint8_t reg, uint8_t value) {
+    reg &= 0x7F;
+    if (reg == REG_USER_CTRL && (value & USER_CTRL_FIFO_RESET)) {
+      fifo.clear();
+      value &= (uint8_t)~USER_CTRL_FIFO_RESET; // self-clearing
+    }
+    if (reg == REG_PWR_MGMT_1 && (value & 0x80)) {
+      memset(regs, 0, sizeof(regs));
+      fifo.clear();
+      value = 0x40; // sleep after reset
+    }
+    regs[reg] = value;
+  }
+
+  uint8_t read(uint8_t reg) {
+    switch (reg) {
+    case REG_WHO_AM_I:
+      return MPU_ADDR;
+    case REG_INT_STATUS: {
+      uint8_t v = regs[REG_INT_STATUS];
+      regs[REG_INT_STATUS] = 0; // cleared on read
+      return v;
+    }
+    case REG_FIFO_COUNTH:
+      return (uint8_t)(fifo.size() >> 8);
+    case REG_FIFO_COUNTL:
+      return (uint8_t)(fifo.size() & 0xFF);
+    case REG_FIFO_R_W: {
+      if (fifo.empty())
+        return 0;
+      uint8_t v = fifo.front();
+      fifo.pop_front();
+      return v;
+    }
+    default:
+      break;
+    }
+    if (reg >= REG_ACCEL_XOUT_H && reg < REG_ACCEL_XOUT_H + 14)
+      return data[reg - REG_ACCEL_XOUT_H];
+    return regs[reg & 0x7F];
+  }
+};
+
+Mpu6050 mpu6050;
+
+} // namespace
+
+void Sim_setImuPresent(bool present) { mpu6050.present = present; }
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t value) {
+  if (txLen >= sizeof(txBuf))
+    return 0;
+  txBuf[txLen++] = value;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  if (txAddress != MPU_ADDR || !mpu6050.present)
+    return 2; // address NACK
+  if (txLen == 0)
+    return 0;
+  mpu6050.pointer = txBuf[0];
+  for (size_t i = 1; i < txLen; i++)
+    mpu6050.write((uint8_t)(txBuf[0] + i - 1), txBuf[i]);
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  rxLen = 0;
+  rxPos = 0;
+  if (address != MPU_ADDR || !mpu6050.present)
+    return 0;
+  if (quantity > sizeof(rxBuf))
+    quantity = sizeof(rxBuf);
+  mpu6050.sync();
+  for (uint8_t i = 0; i < quantity; i++) {
+    rxBuf[rxLen++] = mpu6050.read(mpu6050.pointer);
+    if (mpu6050.pointer != REG_FIFO_R_W)
+      mpu6050.pointer++;
+  }
+  return quantity;
+}
+
+void Adafruit_MPU6050::writeReg(uint8_t reg, uint8_t value) {
+  wire->beginTransmission(address);
+  wire->write(reg);
+  wire->write(value);
+  wire->endTransmission();
+}
+
+bool Adafruit_MPU6050::begin(uint8_t addr, TwoWire *w) {
+  address = addr;
+  wire = w;
+  wire->beginTransmission(address);
+  wire->write(REG_WHO_AM_I);
+  if (wire->endTransmission(false) != 0 || wire->requestFrom(address, 1) != 1)
+    return false;
+  if (wire->read() != MPU_ADDR)
+    return false;
+  writeReg(REG_PWR_MGMT_1, 0x80);
+  writeReg(REG_PWR_MGMT_1, 0x01); // wake, PLL with X gyro
+  return true;
+}
+
+void Adafruit_MPU6050::setAccelerometerRange(mpu6050_accel_range_t range) {
+  writeReg(REG_ACCEL_CONFIG, (uint8_t)(range << 3));
+}
+
+void Adafruit_MPU6050::setGyroRange(mpu6050_gyro_range_t range) {
+  writeReg(REG_GYRO_CONFIG, (uint8_t)(range << 3));
+}
+
+void Adafruit_MPU6050::setFilterBandwidth(mpu6050_bandwidth_t bandwidth) {
+  writeReg(REG_CONFIG, (uint8_t)bandwidth);
+}
+
+void Adafruit_MPU6050::setSampleRateDivisor(uint8_t divisor) {
+  writeReg(REG_SMPLRT_DIV, divisor);
+}
+
+bool Adafruit_MPU6050::getEvent(sensors_event_t *accel, sensors_event_t *gyro,
+                                sensors_event_t *temp) {
+  wire->beginTransmission(address);
+  wire->write(REG_ACCEL_XOUT_H);
+  if (wire->endTransmission(false) != 0 || wire->requestFrom(address, 14) != 14)
+    return false;
+  int16_t raw[7];
+  for (int i = 0; i < 7; i++) {
+    int hi = wire->read();
+    int lo = wire->read();
+    raw[i] = (int16_t)((hi << 8) | lo);
+  }
+  const float g = 9.80665f;
+  const float degToRad = 0.017453293f;
+  if (accel) {
+    accel->acceleration.x = raw[0] / ACCEL_LSB_PER_G * g;
+    accel->acceleration.y = raw[1] / ACCEL_LSB_PER_G * g;
+    accel->acceleration.z = raw[2] / ACCEL_LSB_PER_G * g;
+  }
+  if (temp)
+    temp->temperature = raw[3] / 340.0f + 36.53f;
+  if (gyro) {
+    gyro->gyro.x = raw[4] / GYRO_LSB_PER_DPS * degToRad;
+    gyro->gyro.y = raw[5] / GYRO_LSB_PER_DPS * degToRad;
+    gyro->gyro.z = raw[6] / GYRO_LSB_PER_DPS * degToRad;
+  }
+  return true;
+}
+
+// --- DHT and hall sensor ---
+
+float DHT::readTemperature(bool fahrenheit) {
+  uint32_t ms = millis();
+  float c = 22.0f + 2.0f * sinf((float)ms * 2.0f * (float)PI / 600000.0f) +
+            0.3f * noise(ms ^ 0x7e3a);
+  if (type == DHT11)
+    c = roundf(c);
+  return fahrenheit ? c * 1.8f + 32.0f : c;
+}
+
+float DHT::readHumidity() {
+  uint32_t ms = millis();
+  float h = 45.0f + 8.0f * sinf((float)ms * 2.0f * (float)PI / 900000.0f) +
+            noise(ms ^ 0x51c4);
+  return type == DHT11 ? roundf(h) : h;
+}
+
+int hallRead() { return (int)(20.0f * noise((uint32_t)micros() ^ 0x2b1d)); }
+
+// --- WiFi ---
+
+namespace {
+
+const uint32_t SCAN_DURATION_MS = 1500;
+const int MAX_NETWORKS = 32;
+
+int networkCount = 8;
+bool scanRunning = false;
+bool resultsValid = false;
+unsigned long scanStartMs = 0;
+uint32_t scanNumber = 0;
+int resultCount = 0;
+int32_t resultRssi[MAX_NETWORKS];
+int32_t resultChannel[MAX_NETWORKS];
+
+void finishScan() {
+  scanRunning = false;
+  resultsValid = true;
+  scanNumber++;
+  resultCount = networkCount;
+  for (int i = 0; i < resultCount; i++) {
+    float drift = 4.0f * noise(scanNumber * 64 + (uint32_t)i);
+    resultRssi[i] = (int32_t)(-45 - 6 * i + drift);
+    resultChannel[i] = 1 + (i * 5) % 13;
+  }
+}
+
+} // namespace
+
+void Sim_setWifiNetworkCount(int count) {
+  networkCount = count < 0 ? 0 : count > MAX_NETWORKS ? MAX_NETWORKS : count;
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool showHidden) {
+  (void)showHidden;
+  scanRunning = true;
+  resultsValid = false;
+  scanStartMs = millis();
+  if (async)
+    return WIFI_SCAN_RUNNING;
+  finishScan();
+  return (int16_t)resultCount;
+}
+
+int16_t WiFiClass::scanComplete() {
+  if (scanRunning && millis() - scanStartMs >= SCAN_DURATION_MS)
+    finishScan();
+  if (scanRunning)
+    return WIFI_SCAN_RUNNING;
+  return resultsValid ? (int16_t)resultCount : WIFI_SCAN_FAILED;
+}
+
+void WiFiClass::scanDelete() { resultsValid = false; }
+
+int32_t WiFiClass::RSSI(uint8_t i) {
+  return resultsValid && i < resultCount ? resultRssi[i] : 0;
+}
+
+int32_t WiFiClass::channel(uint8_t i) {
+  return resultsValid && i < resultCount ? resultChannel[i] : 0;
+}
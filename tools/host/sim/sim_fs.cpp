@@ -0,0 +1,401 @@
+// SD and SPIFFS backed by host directories.
+
+#include "SimHost.h"
+#include <FS.h>
+#include <SD.h>
+#include <SPIFFS.h>
+#include <algorithm>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+SDFS SD;
+SPIFFSFS SPIFFS;
+SPIClass SPI;
+
+void Sim_setSdRoot(const char *dir) { SD.setRoot(dir); }
+void Sim_setSpiffsRoot(const char *dir) { SPIFFS.setRoot(dir); }
+
+// --- SD card timing ---
+//
+// Writes go through a one-sector cache per file, as in FatFs: bytes that
+// complete a sector send it, whole sectors in the middle of a write go out in
+// one multi-block command, and a trailing partial sector waits in the cache
+// until it is completed or the file is flushed. A flush also rewrites the
+// directory entry with the new size. Each path component looked up reads a
+// directory sector. Reading file data is not timed.
+//
+// Files grow by 32 KB clusters. Allocating clusters dirties the FAT, which
+// the next flush writes back to both FAT copies along with the FSINFO
+// sector.
+namespace {
+const uint32_t SD_SECTOR_BYTES = 512;
+const uint32_t SD_CLUSTER_BYTES = 32768; // FAT32 on an SDHC card
+const uint32_t SD_FAT_COPIES = 2;
+const uint64_t SD_READ_COMMAND_NS = 200000;   // command and read latency
+const uint64_t SD_WRITE_COMMAND_NS = 1000000; // command and card busy time
+uint32_t sdBusHz = 4000000;
+SimSdStats sdStats;
+uint64_t sdBusNs = 0;
+uint64_t sdLoopNs = 0;
+
+// One command moving `sectors` sectors.
+void chargeSd(bool write, uint64_t sectors) {
+  uint64_t ns = (write ? SD_WRITE_COMMAND_NS : SD_READ_COMMAND_NS) +
+                sectors * SD_SECTOR_BYTES * 8 * 1000000000ULL / sdBusHz;
+  sdStats.commands++;
+  if (write)
+    sdStats.sectorsWritten += sectors;
+  sdBusNs += ns;
+  if (Sim_cpuBusyNs(ns))
+    sdLoopNs += ns;
+}
+
+void chargeSdLookup(const char *path) {
+  sdStats.lookups++;
+  for (const char *p = path; p && *p; p++) {
+    if (*p == '/' && p[1] && p[1] != '/')
+      chargeSd(false, 1);
+  }
+}
+} // namespace
+
+void Sim_getSdStats(SimSdStats &out) {
+  out = sdStats;
+  out.busUs = sdBusNs / 1000;
+  out.loopBlockedUs = sdLoopNs / 1000;
+}
+
+void Sim_resetSdStats() {
+  sdStats = SimSdStats();
+  sdBusNs = 0;
+  sdLoopNs = 0;
+}
+
+bool SDFS::begin(uint8_t, SPIClass &, uint32_t frequency, const char *,
+                 uint8_t, bool) {
+  if (frequency)
+    sdBusHz = frequency;
+  return mounted();
+}
+
+uint64_t SDFS::cardSize() { return mounted() ? 4ULL << 30 : 0; }
+
+bool SDFS::truncate(const char *path, uint32_t size) {
+  if (!mounted())
+    return false;
+  chargeSdLookup(path);
+  // Free the clusters past `size` in both FATs, update FSINFO and the
+  // directory entry.
+  for (uint32_t i = 0; i < SD_FAT_COPIES + 2; i++)
+    chargeSd(true, 1);
+  sdStats.fatWrites += SD_FAT_COPIES + 1;
+  return ::truncate(hostPath(path).c_str(), (off_t)size) == 0;
+}
+
+bool SPIFFSFS::begin(bool, const char *, uint8_t, const char *) {
+  return mounted();
+}
+
+namespace fs {
+
+struct FileImpl {
+  std::string path;     // firmware path, e.g. /logs/events.log
+  std::string hostPath; // backing file or directory on the host
+  std::string root;     // root of the owning file system
+  const char *label = "";
+  FILE *fp = nullptr;
+  bool isDir = false;
+  bool timed = false;       // on the SD card
+  bool append = false;      // writes go to the end
+  uint64_t allocated = 0;   // bytes in the file's clusters
+  uint32_t fatDirty = 0;    // FAT sectors changed since the last flush
+  bool sectorDirty = false; // cached partial sector not yet on the card
+  bool sizeDirty = false;   // directory entry not yet updated
+  std::vector<std::string> entries; // directory listing, sorted
+  size_t nextEntry = 0;
+  std::string nameBuf;
+
+  ~FileImpl() {
+    sync();
+    if (fp)
+      fclose(fp);
+  }
+
+  // Give the file enough clusters for `end` bytes.
+  void allocate(uint64_t end) {
+    if (!timed || end <= allocated)
+      return;
+    uint64_t grown = (end + SD_CLUSTER_BYTES - 1) / SD_CLUSTER_BYTES *
+                     SD_CLUSTER_BYTES;
+    uint64_t clusters = (grown - allocated) / SD_CLUSTER_BYTES;
+    // A new chain of 4-byte FAT32 entries, contiguous on a fresh card.
+    fatDirty += (uint32_t)((clusters * 4 + SD_SECTOR_BYTES - 1) /
+                           SD_SECTOR_BYTES);
+    allocated = grown;
+  }
+
+  // Write back what a flush would, as FatFs does in f_sync().
+  void sync() {
+    if (!timed || (!sectorDirty && !sizeDirty && !fatDirty))
+      return;
+    sdStats.flushes++;
+    if (sectorDirty)
+      chargeSd(true, 1);
+    if (fatDirty) {
+      // One sector at a time through the FatFs window, then FSINFO.
+      for (uint32_t i = 0; i < fatDirty * SD_FAT_COPIES + 1; i++)
+        chargeSd(true, 1);
+      sdStats.fatWrites += fatDirty * SD_FAT_COPIES + 1;
+    }
+    if (sizeDirty)
+      chargeSd(true, 1);
+    sectorDirty = false;
+    sizeDirty = false;
+    fatDirty = 0;
+  }
+};
+
+static bool isHostDir(const std::string &p) {
+  struct stat st;
+  return stat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+void FS::setRoot(const char *dir) {
+  root = dir ? dir : "";
+  while (root.size() > 1 && root.back() == '/')
+    root.pop_back();
+}
+
+std::string FS::hostPath(const char *path) const {
+  std::string p = path ? path : "";
+  if (p.empty() || p[0] != '/')
+    p = "/" + p;
+  return root + p;
+}
+
+bool FS::timed() const { return strcmp(label, "SD") == 0; }
+
+File FS::open(const char *path, const char *mode, bool create) {
+  (void)create;
+  if (!mounted() || !path)
+    return File();
+  if (timed()) {
+    sdStats.opens++;
+    chargeSdLookup(path);
+  }
+  std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+  impl->path = path;
+  impl->hostPath = hostPath(path);
+  impl->root = root;
+  impl->label = label;
+  impl->timed = timed();
+
+  if (isHostDir(impl->hostPath)) {
+    impl->isDir = true;
+    if (DIR *d = opendir(impl->hostPath.c_str())) {
+      while (struct dirent *e = readdir(d)) {
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0)
+          impl->entries.push_back(e->d_name);
+      }
+      closedir(d);
+    }
+    std::sort(impl->entries.begin(), impl->entries.end());
+    return File(impl);
+  }
+
+  const char *hostMode = "rb";
+  if (strcmp(mode, FILE_WRITE) == 0)
+    hostMode = "w+b";
+  else if (strcmp(mode, FILE_APPEND) == 0)
+    hostMode = "a+b";
+  impl->fp = fopen(impl->hostPath.c_str(), hostMode);
+  if (!impl->fp)
+    return File();
+  impl->append = strcmp(mode, FILE_APPEND) == 0;
+  if (impl->timed && strcmp(mode, FILE_WRITE) == 0)
+    impl->sizeDirty = true; // truncated
+  struct stat st;
+  if (fstat(fileno(impl->fp), &st) == 0)
+    impl->allocated = ((uint64_t)st.st_size + SD_CLUSTER_BYTES - 1) /
+                      SD_CLUSTER_BYTES * SD_CLUSTER_BYTES;
+  return File(impl);
+}
+
+bool FS::exists(const char *path) {
+  struct stat st;
+  if (mounted() && timed())
+    chargeSdLookup(path);
+  return mounted() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) {
+  if (mounted() && timed()) {
+    chargeSdLookup(path);
+    chargeSd(true, 1);
+  }
+  return mounted() && ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  if (mounted() && timed()) {
+    chargeSdLookup(from);
+    chargeSdLookup(to);
+    chargeSd(true, 1);
+  }
+  return mounted() &&
+         ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path) {
+  if (mounted() && timed()) {
+    chargeSdLookup(path);
+    chargeSd(true, 1);
+  }
+  return mounted() && (::mkdir(hostPath(path).c_str(), 0755) == 0 ||
+                       isHostDir(hostPath(path)));
+}
+
+bool FS::rmdir(const char *path) {
+  return mounted() && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t *buf, size_t size) {
+  if (!impl || !impl->fp)
+    return 0;
+  if (impl->append)
+    fseek(impl->fp, 0, SEEK_END);
+  if (impl->timed && size > 0) {
+    sdStats.writeCalls++;
+    uint64_t start = (uint64_t)ftell(impl->fp);
+    uint64_t end = start + size;
+    uint64_t firstFull = (start + SD_SECTOR_BYTES - 1) / SD_SECTOR_BYTES;
+    uint64_t lastFull = end / SD_SECTOR_BYTES; // exclusive
+    if (start % SD_SECTOR_BYTES && lastFull >= firstFull) {
+      // Completes the cached sector.
+      chargeSd(true, 1);
+      impl->sectorDirty = false;
+    }
+    if (lastFull > firstFull) {
+      chargeSd(true, lastFull - firstFull);
+    }
+    if (end % SD_SECTOR_BYTES)
+      impl->sectorDirty = true;
+    impl->sizeDirty = true;
+    impl->allocate(end);
+  }
+  return fwrite(buf, 1, size, impl->fp);
+}
+
+int File::available() {
+  if (!impl || !impl->fp)
+    return 0;
+  long pos = ftell(impl->fp);
+  long left = (long)size() - pos;
+  return left > 0 ? (int)left : 0;
+}
+
+int File::read() {
+  if (!impl || !impl->fp)
+    return -1;
+  int c = fgetc(impl->fp);
+  return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+  int c = read();
+  if (c >= 0)
+    ungetc(c, impl->fp);
+  return c;
+}
+
+size_t File::read(uint8_t *buf, size_t size) {
+  if (!impl || !impl->fp)
+    return 0;
+  return fread(buf, 1, size, impl->fp);
+}
+
+void File::flush() {
+  if (impl && impl->fp) {
+    impl->sync();
+    fflush(impl->fp);
+  }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl || !impl->fp)
+    return false;
+  int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END
+                                                            : SEEK_SET;
+  long from = ftell(impl->fp);
+  if (fseek(impl->fp, (long)pos, whence) != 0)
+    return false;
+  // Leaving a sector writes back the cached copy, as f_lseek() does.
+  long at = ftell(impl->fp);
+  if (impl->timed && impl->sectorDirty &&
+      from / SD_SECTOR_BYTES != at / SD_SECTOR_BYTES) {
+    chargeSd(true, 1);
+    impl->sectorDirty = false;
+  }
+  return true;
+}
+
+size_t File::position() const {
+  if (!impl || !impl->fp)
+    return 0;
+  long pos = ftell(impl->fp);
+  return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+  if (!impl || !impl->fp)
+    return 0;
+  fflush(impl->fp);
+  struct stat st;
+  if (fstat(fileno(impl->fp), &st) != 0)
+    return 0;
+  return (size_t)st.st_size;
+}
+
+void File::close() {
+  if (impl)
+    impl->sync();
+  impl.reset();
+}
+
+File::operator bool() const { return impl != nullptr; }
+
+const char *File::name() const {
+  if (!impl)
+    return "";
+  size_t slash = impl->path.rfind('/');
+  impl->nameBuf = slash == std::string::npos ? impl->path
+                                             : impl->path.substr(slash + 1);
+  return impl->nameBuf.c_str();
+}
+
+const char *File::path() const { return impl ? impl->path.c_str() : ""; }
+
+bool File::isDirectory() const { return impl && impl->isDir; }
+
+File File::openNextFile(const char *mode) {
+  if (!impl || !impl->isDir || impl->nextEntry >= impl->entries.size())
+    return File();
+  std::string child = impl->path;
+  if (child.empty() || child.back() != '/')
+    child += "/";
+  child += impl->entries[impl->nextEntry++];
+  FS owner(impl->label);
+  owner.setRoot(impl->root.c_str());
+  return owner.open(child.c_str(), mode);
+}
+
+void File::rewindDirectory() {
+  if (impl)
+    impl->nextEntry = 0;
+}
+
+} // namespace fs
@@ -0,0 +1,1112 @@
+// Adafruit_GFX primitives, canvases, placeholder fonts, the emulated
+// ILI9341 panel and the SPI master driver that reaches it by DMA.
+
+#include "SimHost.h"
+#include <Adafruit_GFX.h>
+#include <Adafruit_ILI9341.h>
+#include <deque>
+#include <driver/spi_master.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans24pt7b.h>
+#include <Fonts/FreeSans9pt7b.h>
+
+#define swap_int16(a, b)                                                       \
+  {                                                                            \
+    int16_t t = a;                                                             \
+    a = b;                                                                     \
+    b = t;                                                                     \
+  }
+
+static uint32_t glyphHash(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352dUL;
+  x ^= x >> 15;
+  x *= 0x846ca68bUL;
+  x ^= x >> 16;
+  return x;
+}
+
+// 5x7 placeholder shape for a printable character: row r is 5 bits.
+static uint8_t glyphRow(unsigned char c, int r) {
+  if (c <= ' ' || c > '~')
+    return 0;
+  uint32_t h = glyphHash(c * 7u + (uint32_t)r);
+  return (uint8_t)((h & 0x1F) | 0x11); // keep both edges lit
+}
+
+// --- Classic 6x8 font: column-major, bit n of a column is row n ---
+
+static uint8_t classicFont[256 * 5];
+
+static struct ClassicFontInit {
+  ClassicFontInit() {
+    for (int c = 0; c < 256; c++) {
+      for (int col = 0; col < 5; col++) {
+        uint8_t bits = 0;
+        for (int row = 0; row < 7; row++) {
+          if (glyphRow((unsigned char)c, row) & (0x10 >> col))
+            bits |= (uint8_t)(1 << row);
+        }
+        classicFont[c * 5 + col] = bits;
+      }
+    }
+  }
+} classicFontInit;
+
+// --- Placeholder FreeSans fonts ---
+
+struct FontData {
+  std::vector<uint8_t> bitmap;
+  std::vector<GFXglyph> glyphs;
+};
+
+static bool isNarrow(char c) { return strchr("Iijl.,:;!|'1t", c) != nullptr; }
+
+static GFXfont makeFont(FontData &data, uint8_t capHeight, uint8_t width,
+                        uint8_t advance, uint8_t yAdvance) {
+  for (int c = 0x20; c <= 0x7E; c++) {
+    GFXglyph g;
+    g.bitmapOffset = (uint16_t)data.bitmap.size();
+    bool lower = c >= 'a' && c <= 'z';
+    g.width = c == ' ' ? 0 : isNarrow((char)c) ? width / 3 + 1 : width;
+    g.height = c == ' ' ? 0 : lower ? capHeight * 3 / 4 : capHeight;
+    g.xAdvance = c == ' ' ? advance / 2
+                          : isNarrow((char)c) ? g.width + 3 : advance;
+    g.xOffset = 1;
+    g.yOffset = (int8_t)-g.height;
+
+    // Scale the 5x7 shape to the glyph box, packed MSB-first row-major.
+    uint8_t acc = 0;
+    int bit = 0;
+    for (int y = 0; y < g.height; y++) {
+      uint8_t row = glyphRow((unsigned char)c, y * 7 / g.height);
+      for (int x = 0; x < g.width; x++) {
+        if (row & (0x10 >> (x * 5 / g.width)))
+          acc |= (uint8_t)(0x80 >> bit);
+        if (++bit == 8) {
+          data.bitmap.push_back(acc);
+          acc = 0;
+          bit = 0;
+        }
+      }
+    }
+    if (bit)
+      data.bitmap.push_back(acc);
+    data.glyphs.push_back(g);
+  }
+  GFXfont f = {data.bitmap.data(), data.glyphs.data(), 0x20, 0x7E, yAdvance};
+  return f;
+}
+
+static FontData sans9Data, sans12Data, sans24Data;
+const GFXfont FreeSans9pt7b = makeFont(sans9Data, 13, 9, 11, 22);
+const GFXfont FreeSans12pt7b = makeFont(sans12Data, 17, 12, 15, 29);
+const GFXfont FreeSans24pt7b = makeFont(sans24Data, 34, 24, 30, 56);
+
+// --- Adafruit_GFX ---
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 uint16_t color) {
+  fillRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                  uint16_t color) {
+  drawFastVLine(x, y, h, color);
+}
+
+void Adafruit_GFX::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                  uint16_t color) {
+  drawFastHLine(x, y, w, color);
+}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                             uint16_t color) {
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    swap_int16(x0, y0);
+    swap_int16(x1, y1);
+  }
+  if (x0 > x1) {
+    swap_int16(x0, x1);
+    swap_int16(y0, y1);
+  }
+  int16_t dx = x1 - x0;
+  int16_t dy = (int16_t)abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = y0 < y1 ? 1 : -1;
+  for (; x0 <= x1; x0++) {
+    if (steep)
+      writePixel(y0, x0, color);
+    else
+      writePixel(x0, y0, color);
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+  rotation = r & 3;
+  if (rotation & 1) {
+    _width = HEIGHT;
+    _height = WIDTH;
+  } else {
+    _width = WIDTH;
+    _height = HEIGHT;
+  }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                 uint16_t color) {
+  startWrite();
+  writeLine(x, y, x, y + h - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                 uint16_t color) {
+  startWrite();
+  writeLine(x, y, x + w - 1, y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  startWrite();
+  for (int16_t i = x; i < x + w; i++)
+    writeFastVLine(i, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                            uint16_t color) {
+  if (x0 == x1) {
+    if (y0 > y1)
+      swap_int16(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  } else if (y0 == y1) {
+    if (x0 > x1)
+      swap_int16(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  } else {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  startWrite();
+  writePixel(x0, y0 + r, color);
+  writePixel(x0, y0 - r, color);
+  writePixel(x0 + r, y0, color);
+  writePixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    writePixel(x0 + x, y0 + y, color);
+    writePixel(x0 - x, y0 + y, color);
+    writePixel(x0 + x, y0 - y, color);
+    writePixel(x0 - x, y0 - y, color);
+    writePixel(x0 + y, y0 + x, color);
+    writePixel(x0 - y, y0 + x, color);
+    writePixel(x0 + y, y0 - x, color);
+    writePixel(x0 - y, y0 - x, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r,
+                                    uint8_t corners, uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (corners & 0x4) {
+      writePixel(x0 + x, y0 + y, color);
+      writePixel(x0 + y, y0 + x, color);
+    }
+    if (corners & 0x2) {
+      writePixel(x0 + x, y0 - y, color);
+      writePixel(x0 + y, y0 - x, color);
+    }
+    if (corners & 0x8) {
+      writePixel(x0 - y, y0 + x, color);
+      writePixel(x0 - x, y0 + y, color);
+    }
+    if (corners & 0x1) {
+      writePixel(x0 - y, y0 - x, color);
+      writePixel(x0 - x, y0 - y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  startWrite();
+  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
+                                    uint8_t corners, int16_t delta,
+                                    uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  delta++; // avoid some +1's in the loop
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    // Vertical lines from the outside in; skip the ones already drawn.
+    if (x < (y + 1)) {
+      if (corners & 1)
+        writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2)
+        writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py) {
+      if (corners & 1)
+        writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2)
+        writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 int16_t r, uint16_t color) {
+  int16_t maxRadius = ((w < h) ? w : h) / 2;
+  if (r > maxRadius)
+    r = maxRadius;
+  startWrite();
+  writeFastHLine(x + r, y, w - 2 * r, color);
+  writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  writeFastVLine(x, y + r, h - 2 * r, color);
+  writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+  drawCircleHelper(x + r, y + r, r, 1, color);
+  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 int16_t r, uint16_t color) {
+  int16_t maxRadius = ((w < h) ? w : h) / 2;
+  if (r > maxRadius)
+    r = maxRadius;
+  startWrite();
+  writeFillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap,
+                                 int16_t w, int16_t h) {
+  startWrite();
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++)
+      writePixel(x + i, y, bitmap[j * w + i]);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+                                 int16_t w, int16_t h) {
+  drawRGBBitmap(x, y, (const uint16_t *)bitmap, w, h);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size) {
+  if (!gfxFont) {
+    if (x >= _width || y >= _height || (x + 6 * size - 1) < 0 ||
+        (y + 8 * size - 1) < 0)
+      return;
+    startWrite();
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = classicFont[c * 5 + i];
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        uint16_t ink;
+        if (line & 1)
+          ink = color;
+        else if (bg != color)
+          ink = bg;
+        else
+          continue;
+        if (size == 1)
+          writePixel(x + i, y + j, ink);
+        else
+          writeFillRect(x + i * size, y + j * size, size, size, ink);
+      }
+    }
+    if (bg != color) {
+      if (size == 1)
+        writeFastVLine(x + 5, y, 8, bg);
+      else
+        writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+    }
+    endWrite();
+    return;
+  }
+
+  // Custom fonts draw from the baseline and have no background.
+  c -= (uint8_t)gfxFont->first;
+  const GFXglyph &glyph = gfxFont->glyph[c];
+  const uint8_t *bitmap = gfxFont->bitmap;
+  uint16_t bo = glyph.bitmapOffset;
+  uint8_t bits = 0;
+  uint8_t bit = 0;
+  startWrite();
+  for (uint8_t yy = 0; yy < glyph.height; yy++) {
+    for (uint8_t xx = 0; xx < glyph.width; xx++) {
+      if (!(bit++ & 7))
+        bits = bitmap[bo++];
+      if (bits & 0x80) {
+        if (size == 1)
+          writePixel(x + glyph.xOffset + xx, y + glyph.yOffset + yy, color);
+        else
+          writeFillRect(x + (glyph.xOffset + xx) * size,
+                        y + (glyph.yOffset + yy) * size, size, size, color);
+      }
+      bits <<= 1;
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && (cursor_x + textsize_x * 6) > _width) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * gfxFont->yAdvance;
+  } else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last) {
+    const GFXglyph &glyph = gfxFont->glyph[c - gfxFont->first];
+    if (glyph.width > 0 && glyph.height > 0) {
+      if (wrap && (cursor_x + textsize_x * (glyph.xOffset + glyph.width)) >
+                      _width) {
+        cursor_x = 0;
+        cursor_y += textsize_y * gfxFont->yAdvance;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+    }
+    cursor_x += glyph.xAdvance * textsize_x;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::setFont(const GFXfont *f) {
+  // The classic font is drawn from the top, custom fonts from the baseline.
+  if (f && !gfxFont)
+    cursor_y += 6;
+  else if (!f && gfxFont)
+    cursor_y -= 6;
+  gfxFont = f;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y,
+                              int16_t *minx, int16_t *miny, int16_t *maxx,
+                              int16_t *maxy) {
+  if (gfxFont) {
+    if (c == '\n') {
+      *x = 0;
+      *y += textsize_y * gfxFont->yAdvance;
+    } else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last) {
+      const GFXglyph &glyph = gfxFont->glyph[c - gfxFont->first];
+      if (wrap &&
+          (*x + ((glyph.xOffset + glyph.width) * textsize_x)) > _width) {
+        *x = 0;
+        *y += textsize_y * gfxFont->yAdvance;
+      }
+      int16_t x1 = *x + glyph.xOffset * textsize_x;
+      int16_t y1 = *y + glyph.yOffset * textsize_y;
+      int16_t x2 = x1 + glyph.width * textsize_x - 1;
+      int16_t y2 = y1 + glyph.height * textsize_y - 1;
+      if (x1 < *minx)
+        *minx = x1;
+      if (y1 < *miny)
+        *miny = y1;
+      if (x2 > *maxx)
+        *maxx = x2;
+      if (y2 > *maxy)
+        *maxy = y2;
+      *x += glyph.xAdvance * textsize_x;
+    }
+    return;
+  }
+
+  if (c == '\n') {
+    *x = 0;
+    *y += textsize_y * 8;
+  } else if (c != '\r') {
+    if (wrap && ((*x + textsize_x * 6) > _width)) {
+      *x = 0;
+      *y += textsize_y * 8;
+    }
+    int16_t x2 = *x + textsize_x * 6 - 1;
+    int16_t y2 = *y + textsize_y * 8 - 1;
+    if (x2 > *maxx)
+      *maxx = x2;
+    if (y2 > *maxy)
+      *maxy = y2;
+    if (*x < *minx)
+      *minx = *x;
+    if (*y < *miny)
+      *miny = *y;
+    *x += textsize_x * 6;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  *x1 = x;
+  *y1 = y;
+  *w = *h = 0;
+  int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+  unsigned char c;
+  while ((c = (unsigned char)*str++))
+    charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+  if (maxx >= minx) {
+    *x1 = minx;
+    *w = (uint16_t)(maxx - minx + 1);
+  }
+  if (maxy >= miny) {
+    *y1 = miny;
+    *h = (uint16_t)(maxy - miny + 1);
+  }
+}
+
+// --- Canvases ---
+
+GFXcanvas16::GFXcanvas16(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), buffer((size_t)w * h, 0) {}
+
+bool GFXcanvas16::toRaw(int16_t &x, int16_t &y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return false;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  return true;
+}
+
+void GFXcanvas16::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (toRaw(x, y))
+    buffer[x + (size_t)y * WIDTH] = color;
+}
+
+uint16_t GFXcanvas16::getPixel(int16_t x, int16_t y) const {
+  return toRaw(x, y) ? buffer[x + (size_t)y * WIDTH] : 0;
+}
+
+void GFXcanvas16::fillScreen(uint16_t color) {
+  std::fill(buffer.begin(), buffer.end(), color);
+}
+
+void GFXcanvas16::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (rotation != 0 || y < 0 || y >= _height) {
+    for (int16_t i = 0; i < w; i++)
+      drawPixel(x + i, y, color);
+    return;
+  }
+  int16_t x0 = max<int16_t>(x, 0);
+  int16_t x1 = min<int16_t>(x + w, _width);
+  if (x0 < x1)
+    std::fill(&buffer[x0 + (size_t)y * WIDTH],
+              &buffer[x1 + (size_t)y * WIDTH], color);
+}
+
+void GFXcanvas16::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                uint16_t color) {
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  for (int16_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+GFXcanvas8::GFXcanvas8(uint16_t w, uint16_t h)
+    : Adafruit_GFX(w, h), buffer((size_t)w * h, 0) {}
+
+bool GFXcanvas8::toRaw(int16_t &x, int16_t &y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return false;
+  int16_t t;
+  switch (rotation) {
+  case 1:
+    t = x;
+    x = WIDTH - 1 - y;
+    y = t;
+    break;
+  case 2:
+    x = WIDTH - 1 - x;
+    y = HEIGHT - 1 - y;
+    break;
+  case 3:
+    t = x;
+    x = y;
+    y = HEIGHT - 1 - t;
+    break;
+  }
+  return true;
+}
+
+void GFXcanvas8::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (toRaw(x, y))
+    buffer[x + (size_t)y * WIDTH] = (uint8_t)color;
+}
+
+uint8_t GFXcanvas8::getPixel(int16_t x, int16_t y) const {
+  return toRaw(x, y) ? buffer[x + (size_t)y * WIDTH] : 0;
+}
+
+void GFXcanvas8::fillScreen(uint16_t color) {
+  std::fill(buffer.begin(), buffer.end(), (uint8_t)color);
+}
+
+void GFXcanvas8::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                               uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  for (int16_t i = 0; i < w; i++)
+    drawPixel(x + i, y, color);
+}
+
+void GFXcanvas8::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                               uint16_t color) {
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  for (int16_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+// --- Emulated ILI9341 ---
+
+namespace {
+
+const int GRAM_W = ILI9341_TFTWIDTH;
+const int GRAM_H = ILI9341_TFTHEIGHT;
+uint16_t gram[GRAM_W * GRAM_H];
+SimDisplayStats stats;
+const Adafruit_SPITFT *panel = nullptr; // for rotation when reading back
+uint8_t panelRotation = 0;
+uint16_t scrollTop = 0;                  // fixed rows above the scroll area
+uint16_t scrollHeight = GRAM_H;          // rows in the scroll area
+uint16_t scrollStart = 0;                // GRAM row shown first in the area
+
+// Bus timing. A CPU-driven window also sends CASET/PASET/RAMWR with their
+// parameters, toggling DC between them, through the Arduino HAL.
+const uint32_t DEFAULT_BUS_HZ = 40000000;
+const uint64_t CPU_WINDOW_NS = 6000;
+const uint64_t DMA_TRANS_NS = 2000; // driver queueing and ISR, per transaction
+uint32_t busHz = DEFAULT_BUS_HZ;
+uint64_t cpuBusNs = 0;
+uint64_t dmaBusNs = 0;
+uint64_t dmaWaitNs = 0;
+
+uint64_t nowNs() { return Sim_nowUs() * 1000; }
+
+uint64_t bitsNs(uint64_t bits) { return bits * 1000000000ULL / busHz; }
+
+// The caller drives the bus for `ns`.
+void chargeCpu(uint64_t ns) {
+  cpuBusNs += ns;
+  Sim_cpuBusyNs(ns);
+}
+
+// Logical (rotated) coordinates to GRAM column/row.
+void toGram(int16_t x, int16_t y, int &col, int &row) {
+  switch (panelRotation) {
+  case 0:
+    col = GRAM_W - 1 - x;
+    row = y;
+    break;
+  case 1:
+    col = y;
+    row = x;
+    break;
+  case 2:
+    col = x;
+    row = GRAM_H - 1 - y;
+    break;
+  default:
+    col = GRAM_W - 1 - y;
+    row = GRAM_H - 1 - x;
+    break;
+  }
+}
+
+// GRAM row shown on panel line `line` with vertical scrolling applied.
+int scrolledRow(int line) {
+  if (line < scrollTop || line >= scrollTop + scrollHeight)
+    return line;
+  int offset = (line - scrollTop) + (scrollStart - scrollTop);
+  return scrollTop + ((offset % scrollHeight) + scrollHeight) % scrollHeight;
+}
+
+} // namespace
+
+void Adafruit_SPITFT::storePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return;
+  int col, row;
+  toGram(x, y, col, row);
+  gram[row * GRAM_W + col] = color;
+}
+
+void Adafruit_SPITFT::setAddrWindow(uint16_t x, uint16_t y, uint16_t w,
+                                    uint16_t h) {
+  winX = (int16_t)x;
+  winY = (int16_t)y;
+  winW = (int16_t)w;
+  winH = (int16_t)h;
+  winPos = 0;
+  stats.windows++;
+  chargeCpu(CPU_WINDOW_NS);
+}
+
+void Adafruit_SPITFT::storeWindowPixel(uint16_t color) {
+  if (winW <= 0 || winPos >= (int32_t)winW * winH)
+    return;
+  storePixel(winX + winPos % winW, winY + winPos / winW, color);
+  winPos++;
+  stats.pixelsWritten++;
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool block,
+                                  bool bigEndian) {
+  (void)block;
+  for (uint32_t i = 0; i < len; i++) {
+    uint16_t c = colors[i];
+    if (bigEndian)
+      c = (uint16_t)((c >> 8) | (c << 8));
+    storeWindowPixel(c);
+  }
+  chargeCpu(bitsNs((uint64_t)len * 16));
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++)
+    storeWindowPixel(color);
+  chargeCpu(bitsNs((uint64_t)len * 16));
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height)
+    return;
+  setAddrWindow(x, y, 1, 1);
+  storeWindowPixel(color);
+  chargeCpu(bitsNs(16));
+}
+
+void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+  if (w == 0 || h == 0 || x >= _width || y >= _height || x2 < 0 || y2 < 0)
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x2 >= _width)
+    x2 = _width - 1;
+  if (y2 >= _height)
+    y2 = _height - 1;
+  w = x2 - x + 1;
+  h = y2 - y + 1;
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors,
+                                    int16_t w, int16_t h) {
+  int16_t x2, y2;
+  if (w <= 0 || h <= 0 || (x >= _width) || (y >= _height) ||
+      ((x2 = (x + w - 1)) < 0) || ((y2 = (y + h - 1)) < 0))
+    return;
+  int16_t bx1 = 0, by1 = 0, saveW = w;
+  if (x < 0) {
+    w += x;
+    bx1 = -x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    by1 = -y;
+    y = 0;
+  }
+  if (x2 >= _width)
+    w = _width - x;
+  if (y2 >= _height)
+    h = _height - y;
+  pcolors += by1 * saveW + bx1;
+  setAddrWindow(x, y, w, h);
+  while (h--) {
+    writePixels(pcolors, w);
+    pcolors += saveW;
+  }
+}
+
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t)
+    : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {
+  csPin = cs;
+  dcPin = dc;
+}
+
+Adafruit_ILI9341::Adafruit_ILI9341(SPIClass *, int8_t dc, int8_t cs, int8_t)
+    : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {
+  csPin = cs;
+  dcPin = dc;
+}
+
+void Adafruit_ILI9341::begin(uint32_t freq) {
+  panel = this;
+  busHz = freq ? freq : DEFAULT_BUS_HZ;
+  memset(gram, 0, sizeof(gram));
+  scrollTop = 0;
+  scrollHeight = GRAM_H;
+  scrollStart = 0;
+  setRotation(0);
+}
+
+void Adafruit_ILI9341::setRotation(uint8_t r) {
+  Adafruit_GFX::setRotation(r);
+  if (panel == this)
+    panelRotation = rotation;
+}
+
+void Adafruit_ILI9341::setScrollMargins(uint16_t top, uint16_t bottom) {
+  if (top + bottom > GRAM_H)
+    return;
+  scrollTop = top;
+  scrollHeight = (uint16_t)(GRAM_H - top - bottom);
+}
+
+void Adafruit_ILI9341::scrollTo(uint16_t y) { scrollStart = y; }
+
+// --- Controller command interface (DMA path) ---
+
+namespace {
+
+const uint8_t CMD_CASET = 0x2A;
+const uint8_t CMD_PASET = 0x2B;
+const uint8_t CMD_RAMWR = 0x2C;
+
+struct BusDecoder {
+  uint8_t cmd;
+  uint8_t param[4];
+  uint8_t paramLen;
+  uint16_t colStart, colEnd, pageStart, pageEnd;
+  int32_t pos; // pixel index in the RAMWR window
+  bool haveHigh;
+  uint8_t high;
+} bus;
+
+// Bytes clocked into the controller with DC at `data`. Address ranges are
+// logical coordinates in the current rotation, as Adafruit sends them.
+void panelBusWrite(bool data, const uint8_t *bytes, size_t len) {
+  if (!panel)
+    return;
+  if (!data) {
+    for (size_t i = 0; i < len; i++) {
+      bus.cmd = bytes[i];
+      bus.paramLen = 0;
+      bus.pos = 0;
+      bus.haveHigh = false;
+      if (bus.cmd == CMD_RAMWR)
+        stats.windows++;
+    }
+    return;
+  }
+  int32_t w = bus.colEnd - bus.colStart + 1;
+  int32_t h = bus.pageEnd - bus.pageStart + 1;
+  for (size_t i = 0; i < len; i++) {
+    uint8_t b = bytes[i];
+    if (bus.cmd == CMD_CASET || bus.cmd == CMD_PASET) {
+      if (bus.paramLen < 4)
+        bus.param[bus.paramLen++] = b;
+      if (bus.paramLen == 4) {
+        uint16_t from = (uint16_t)(bus.param[0] << 8 | bus.param[1]);
+        uint16_t to = (uint16_t)(bus.param[2] << 8 | bus.param[3]);
+        if (bus.cmd == CMD_CASET) {
+          bus.colStart = from;
+          bus.colEnd = to;
+        } else {
+          bus.pageStart = from;
+          bus.pageEnd = to;
+        }
+      }
+    } else if (bus.cmd == CMD_RAMWR) {
+      if (!bus.haveHigh) {
+        bus.high = b;
+        bus.haveHigh = true;
+        continue;
+      }
+      bus.haveHigh = false;
+      if (w <= 0 || h <= 0 || bus.pos >= w * h)
+        continue;
+      int16_t x = (int16_t)(bus.colStart + bus.pos % w);
+      int16_t y = (int16_t)(bus.pageStart + bus.pos / w);
+      bus.pos++;
+      stats.pixelsWritten++;
+      if (x >= panel->width() || y >= panel->height())
+        continue;
+      int col, row;
+      toGram(x, y, col, row);
+      gram[row * GRAM_W + col] = (uint16_t)(bus.high << 8 | b);
+    }
+  }
+}
+
+} // namespace
+
+// --- SPI master driver ---
+
+struct spi_device_t {
+  int clockHz;
+  int queueSize;
+  transaction_cb_t pre;
+};
+
+namespace {
+
+struct PendingTrans {
+  spi_transaction_t *trans;
+  uint64_t doneNs;
+};
+
+bool spiBusUp = false;
+spi_device_t spiDevice;
+bool spiDeviceAdded = false;
+std::deque<PendingTrans> spiPending; // queued or finished, not yet collected
+uint64_t spiFreeNs = 0;              // when the last queued one finishes
+
+} // namespace
+
+esp_err_t spi_bus_initialize(spi_host_device_t host,
+                             const spi_bus_config_t *cfg, int dmaChan) {
+  (void)host;
+  (void)dmaChan;
+  if (!cfg || spiBusUp)
+    return ESP_ERR_INVALID_STATE;
+  spiBusUp = true;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host,
+                             const spi_device_interface_config_t *dev,
+                             spi_device_handle_t *handle) {
+  (void)host;
+  if (!spiBusUp || spiDeviceAdded || !dev || !handle ||
+      dev->clock_speed_hz <= 0 || dev->queue_size <= 0)
+    return ESP_ERR_INVALID_ARG;
+  spiDevice.clockHz = dev->clock_speed_hz;
+  spiDevice.queueSize = dev->queue_size;
+  spiDevice.pre = dev->pre_cb;
+  spiDeviceAdded = true;
+  *handle = &spiDevice;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle,
+                                 spi_transaction_t *t, TickType_t wait) {
+  (void)wait;
+  if (handle != &spiDevice || !t)
+    return ESP_ERR_INVALID_ARG;
+  if ((int)spiPending.size() >= spiDevice.queueSize)
+    return ESP_ERR_TIMEOUT;
+  if (spiDevice.pre)
+    spiDevice.pre(t);
+  size_t bytes = t->length / 8;
+  const uint8_t *data = (t->flags & SPI_TRANS_USE_TXDATA)
+                            ? t->tx_data
+                            : (const uint8_t *)t->tx_buffer;
+  // The controller ignores the bus while it is not selected.
+  if (panel && panel->simCsPin() >= 0 &&
+      Sim_gpioLevel((uint8_t)panel->simCsPin()) == LOW)
+    panelBusWrite(Sim_gpioLevel((uint8_t)panel->simDcPin()) != LOW, data,
+                  bytes);
+
+  uint64_t now = nowNs();
+  uint64_t start = spiFreeNs > now ? spiFreeNs : now;
+  uint64_t busy = DMA_TRANS_NS + (uint64_t)t->length * 1000000000ULL /
+                                     (uint64_t)spiDevice.clockHz;
+  spiFreeNs = start + busy;
+  dmaBusNs += busy;
+  spiPending.push_back({t, spiFreeNs});
+  return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle,
+                                      spi_transaction_t **t,
+                                      TickType_t wait) {
+  if (handle != &spiDevice || !t)
+    return ESP_ERR_INVALID_ARG;
+  if (spiPending.empty())
+    return ESP_ERR_TIMEOUT; // would block forever
+  PendingTrans next = spiPending.front();
+  uint64_t now = nowNs();
+  if (next.doneNs > now) {
+    if (wait == 0)
+      return ESP_ERR_TIMEOUT;
+    dmaWaitNs += next.doneNs - now;
+    Sim_cpuBusyNs(next.doneNs - now);
+  }
+  spiPending.pop_front();
+  *t = next.trans;
+  return ESP_OK;
+}
+
+// --- Simulator access ---
+
+int16_t Sim_displayWidth() { return panel ? panel->width() : 0; }
+
+int16_t Sim_displayHeight() { return panel ? panel->height() : 0; }
+
+uint16_t Sim_displayPixel(int16_t x, int16_t y) {
+  if (!panel || x < 0 || y < 0 || x >= panel->width() || y >= panel->height())
+    return 0;
+  int col, row;
+  toGram(x, y, col, row);
+  return gram[scrolledRow(row) * GRAM_W + col];
+}
+
+void Sim_getDisplayStats(SimDisplayStats &out) {
+  out = stats;
+  out.cpuBusUs = cpuBusNs / 1000;
+  out.dmaBusUs = dmaBusNs / 1000;
+  out.dmaWaitUs = dmaWaitNs / 1000;
+}
+
+void Sim_resetDisplayStats() {
+  stats = SimDisplayStats();
+  cpuBusNs = 0;
+  dmaBusNs = 0;
+  dmaWaitNs = 0;
+}
+
+bool Sim_writeDisplayPpm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  int w = Sim_displayWidth();
+  int h = Sim_displayHeight();
+  fprintf(f, "P6\n%d %d\n255\n", w, h);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      uint16_t c = Sim_displayPixel((int16_t)x, (int16_t)y);
+      uint8_t rgb[3] = {(uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+                        (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                        (uint8_t)((c & 0x1F) * 255 / 31)};
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  return fclose(f) == 0;
+}
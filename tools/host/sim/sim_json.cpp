@@ -0,0 +1,393 @@
+// JSON tree, parser and serializer behind the ArduinoJson stand-in.
+
+#include <ArduinoJson.h>
+#include <ctype.h>
+
+// --- Tree ---
+
+JsonNode *JsonNode::find(const char *k) const {
+  if (type != Object || !k)
+    return nullptr;
+  for (const auto &m : members) {
+    if (m.first == k)
+      return m.second.get();
+  }
+  return nullptr;
+}
+
+JsonNode *JsonNode::getOrAdd(const char *k) {
+  if (type == Null)
+    type = Object;
+  if (type != Object)
+    return nullptr;
+  if (JsonNode *n = find(k))
+    return n;
+  members.emplace_back(k, std::unique_ptr<JsonNode>(new JsonNode()));
+  return members.back().second.get();
+}
+
+void JsonNode::clear() {
+  type = Null;
+  s.clear();
+  members.clear();
+  items.clear();
+}
+
+JsonVariant JsonVariant::operator[](const char *k) const {
+  JsonNode *container =
+      node && (node->type == JsonNode::Object || node->type == JsonNode::Null)
+          ? node
+          : nullptr;
+  return JsonVariant(container, k ? k : "", node ? node->find(k) : nullptr);
+}
+
+JsonNode *JsonVariant::materialize() {
+  if (!node && parent)
+    node = parent->getOrAdd(key.c_str());
+  if (node)
+    node->clear();
+  return node;
+}
+
+template <> JsonObject JsonVariant::to<JsonObject>() {
+  if (JsonNode *n = materialize()) {
+    n->type = JsonNode::Object;
+    return JsonObject(*this);
+  }
+  return JsonObject();
+}
+
+JsonVariant &JsonVariant::operator=(bool v) {
+  if (JsonNode *n = materialize()) {
+    n->type = JsonNode::Bool;
+    n->b = v;
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::operator=(const char *v) {
+  if (JsonNode *n = materialize()) {
+    if (v) {
+      n->type = JsonNode::Str;
+      n->s = v;
+    }
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::setInt(long long v) {
+  if (JsonNode *n = materialize()) {
+    n->type = JsonNode::Int;
+    n->i = v;
+  }
+  return *this;
+}
+
+JsonVariant &JsonVariant::setFloat(double v) {
+  if (JsonNode *n = materialize()) {
+    n->type = JsonNode::Float;
+    n->f = v;
+  }
+  return *this;
+}
+
+const char *JsonVariant::operator|(const char *def) const {
+  return node && node->type == JsonNode::Str ? node->s.c_str() : def;
+}
+
+bool JsonVariant::operator|(bool def) const {
+  return node && node->type == JsonNode::Bool ? node->b : def;
+}
+
+long long JsonVariant::intOr(long long def) const {
+  if (node && node->type == JsonNode::Int)
+    return node->i;
+  if (node && node->type == JsonNode::Float)
+    return (long long)node->f;
+  return def;
+}
+
+double JsonVariant::floatOr(double def) const {
+  if (node && node->type == JsonNode::Float)
+    return node->f;
+  if (node && node->type == JsonNode::Int)
+    return (double)node->i;
+  return def;
+}
+
+const char *DeserializationError::c_str() const {
+  switch (code) {
+  case Ok:
+    return "Ok";
+  case EmptyInput:
+    return "EmptyInput";
+  case IncompleteInput:
+    return "IncompleteInput";
+  case InvalidInput:
+    return "InvalidInput";
+  case NoMemory:
+    return "NoMemory";
+  }
+  return "Unknown";
+}
+
+// --- Parser ---
+
+namespace {
+
+struct Parser {
+  const char *p;
+  const char *end;
+
+  void skipSpace() {
+    while (p < end && isspace((unsigned char)*p))
+      p++;
+  }
+
+  bool parseString(std::string &out) {
+    if (p >= end || *p != '"')
+      return false;
+    p++;
+    while (p < end && *p != '"') {
+      char c = *p++;
+      if (c == '\\') {
+        if (p >= end)
+          return false;
+        char e = *p++;
+        switch (e) {
+        case 'n':
+          c = '\n';
+          break;
+        case 't':
+          c = '\t';
+          break;
+        case 'r':
+          c = '\r';
+          break;
+        case 'b':
+          c = '\b';
+          break;
+        case 'f':
+          c = '\f';
+          break;
+        case 'u':
+          if (end - p < 4)
+            return false;
+          c = (char)strtol(std::string(p, 4).c_str(), nullptr, 16);
+          p += 4;
+          break;
+        default:
+          c = e;
+          break;
+        }
+      }
+      out += c;
+    }
+    if (p >= end)
+      return false;
+    p++;
+    return true;
+  }
+
+  DeserializationError::Code parseValue(JsonNode &n, int depth) {
+    if (depth > 16)
+      return DeserializationError::NoMemory;
+    skipSpace();
+    if (p >= end)
+      return DeserializationError::IncompleteInput;
+    char c = *p;
+    if (c == '{') {
+      p++;
+      n.type = JsonNode::Object;
+      skipSpace();
+      if (p < end && *p == '}') {
+        p++;
+        return DeserializationError::Ok;
+      }
+      for (;;) {
+        skipSpace();
+        std::string k;
+        if (!parseString(k))
+          return p >= end ? DeserializationError::IncompleteInput
+                          : DeserializationError::InvalidInput;
+        skipSpace();
+        if (p >= end || *p != ':')
+          return DeserializationError::InvalidInput;
+        p++;
+        JsonNode *child = n.getOrAdd(k.c_str());
+        child->clear();
+        DeserializationError::Code err = parseValue(*child, depth + 1);
+        if (err != DeserializationError::Ok)
+          return err;
+        skipSpace();
+        if (p < end && *p == ',') {
+          p++;
+          continue;
+        }
+        if (p < end && *p == '}') {
+          p++;
+          return DeserializationError::Ok;
+        }
+        return p >= end ? DeserializationError::IncompleteInput
+                        : DeserializationError::InvalidInput;
+      }
+    }
+    if (c == '[') {
+      p++;
+      n.type = JsonNode::Array;
+      skipSpace();
+      if (p < end && *p == ']') {
+        p++;
+        return DeserializationError::Ok;
+      }
+      for (;;) {
+        n.items.emplace_back(new JsonNode());
+        DeserializationError::Code err =
+            parseValue(*n.items.back(), depth + 1);
+        if (err != DeserializationError::Ok)
+          return err;
+        skipSpace();
+        if (p < end && *p == ',') {
+          p++;
+          continue;
+        }
+        if (p < end && *p == ']') {
+          p++;
+          return DeserializationError::Ok;
+        }
+        return p >= end ? DeserializationError::IncompleteInput
+                        : DeserializationError::InvalidInput;
+      }
+    }
+    if (c == '"') {
+      n.type = JsonNode::Str;
+      return parseString(n.s) ? DeserializationError::Ok
+                              : DeserializationError::IncompleteInput;
+    }
+    if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0) {
+      n.type = JsonNode::Bool;
+      n.b = *p == 't';
+      p += n.b ? 4 : 5;
+      return DeserializationError::Ok;
+    }
+    if (strncmp(p, "null", 4) == 0) {
+      p += 4;
+      return DeserializationError::Ok;
+    }
+    const char *start = p;
+    while (p < end && (isdigit((unsigned char)*p) || strchr("+-.eE", *p)))
+      p++;
+    if (p == start)
+      return DeserializationError::InvalidInput;
+    std::string num(start, p);
+    if (num.find_first_of(".eE") == std::string::npos) {
+      n.type = JsonNode::Int;
+      n.i = strtoll(num.c_str(), nullptr, 10);
+    } else {
+      n.type = JsonNode::Float;
+      n.f = strtod(num.c_str(), nullptr);
+    }
+    return DeserializationError::Ok;
+  }
+};
+
+} // namespace
+
+DeserializationError deserializeJson(JsonDocument &doc, const char *input) {
+  doc.clear();
+  Parser parser = {input, input + strlen(input)};
+  parser.skipSpace();
+  if (parser.p >= parser.end)
+    return DeserializationError::EmptyInput;
+  return parser.parseValue(*doc.raw(), 0);
+}
+
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input) {
+  std::string text;
+  int c;
+  while ((c = input.read()) >= 0)
+    text += (char)c;
+  return deserializeJson(doc, text.c_str());
+}
+
+// --- Serializer ---
+
+static size_t writeString(Print &out, const std::string &s) {
+  size_t n = out.write('"');
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      n += out.write('\\');
+      n += out.write((uint8_t)c);
+    } else if (c == '\n') {
+      n += out.write("\\n");
+    } else {
+      n += out.write((uint8_t)c);
+    }
+  }
+  return n + out.write('"');
+}
+
+static size_t writeIndent(Print &out, bool pretty, int depth) {
+  if (!pretty)
+    return 0;
+  size_t n = out.write("\r\n");
+  for (int i = 0; i < depth; i++)
+    n += out.write("  ");
+  return n;
+}
+
+static size_t writeNode(Print &out, const JsonNode *node, bool pretty,
+                        int depth) {
+  if (!node)
+    return out.write("null");
+  char buf[32];
+  switch (node->type) {
+  case JsonNode::Null:
+    return out.write("null");
+  case JsonNode::Bool:
+    return out.write(node->b ? "true" : "false");
+  case JsonNode::Int:
+    snprintf(buf, sizeof(buf), "%lld", node->i);
+    return out.write(buf);
+  case JsonNode::Float:
+    snprintf(buf, sizeof(buf), "%.9g", node->f);
+    return out.write(buf);
+  case JsonNode::Str:
+    return writeString(out, node->s);
+  case JsonNode::Object: {
+    size_t n = out.write('{');
+    for (size_t i = 0; i < node->members.size(); i++) {
+      if (i)
+        n += out.write(',');
+      n += writeIndent(out, pretty, depth + 1);
+      n += writeString(out, node->members[i].first);
+      n += out.write(pretty ? ": " : ":");
+      n += writeNode(out, node->members[i].second.get(), pretty, depth + 1);
+    }
+    if (!node->members.empty())
+      n += writeIndent(out, pretty, depth);
+    return n + out.write('}');
+  }
+  case JsonNode::Array: {
+    size_t n = out.write('[');
+    for (size_t i = 0; i < node->items.size(); i++) {
+      if (i)
+        n += out.write(',');
+      n += writeIndent(out, pretty, depth + 1);
+      n += writeNode(out, node->items[i].get(), pretty, depth + 1);
+    }
+    if (!node->items.empty())
+      n += writeIndent(out, pretty, depth);
+    return n + out.write(']');
+  }
+  }
+  return 0;
+}
+
+size_t serializeJson(const JsonVariant &src, Print &out) {
+  return writeNode(out, src.raw(), false, 0);
+}
+
+size_t serializeJsonPretty(const JsonVariant &src, Print &out) {
+  return writeNode(out, src.raw(), true, 0);
+}
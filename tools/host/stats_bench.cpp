@@ -0,0 +1,136 @@
+// Host benchmark for SlidingStats: O(1) sliding variance versus the previous
+// two-pass computeVariance over the whole window on every sample, with the
+// worst error of each against a double-precision recompute. Correctness is
+// covered by tests/stats_test.cpp.
+//
+//   stats_bench [samples]
+
+#include "SlidingStats.h"
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Previous sensors.cpp implementation.
+static float computeVariance(const float *arr, int n) {
+  if (n <= 1)
+    return 0.0f;
+  float sum = 0.0f;
+  for (int i = 0; i < n; i++)
+    sum += arr[i];
+  float mean = sum / n;
+  float var = 0.0f;
+  for (int i = 0; i < n; i++) {
+    float d = arr[i] - mean;
+    var += d * d;
+  }
+  var /= (n - 1);
+  return var;
+}
+
+static double referenceVariance(const float *arr, int n) {
+  if (n <= 1)
+    return 0.0;
+  double sum = 0.0;
+  for (int i = 0; i < n; i++)
+    sum += arr[i];
+  double mean = sum / n;
+  double var = 0.0;
+  for (int i = 0; i < n; i++) {
+    double d = arr[i] - mean;
+    var += d * d;
+  }
+  return var / (n - 1);
+}
+
+// Accelerometer-like magnitudes: gravity offset, small noise, and bursts of
+// motion, so the variance spans several orders of magnitude.
+static std::vector<float> makeSignal(size_t samples) {
+  std::vector<float> v(samples);
+  uint32_t rng = 12345;
+  for (size_t i = 0; i < samples; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    float noise = ((rng >> 8) & 0xFFFF) / 65535.0f - 0.5f;
+    bool moving = (i / 5000) % 4 == 3;
+    v[i] = 9.81f + noise * (moving ? 6.0f : 0.02f);
+  }
+  return v;
+}
+
+static void benchWindow(const std::vector<float> &signal, int window) {
+  std::vector<float> ring(window), slidingBuf(window);
+  int index = 0, count = 0;
+  SlidingStats stats;
+  SlidingStats_init(stats, slidingBuf.data(), (uint16_t)window);
+
+  // Timing: old two-pass per sample.
+  double twoPassSum = 0.0;
+  Clock::time_point start = Clock::now();
+  for (float x : signal) {
+    ring[index] = x;
+    index = (index + 1) % window;
+    if (count < window)
+      count++;
+    twoPassSum += computeVariance(ring.data(), count);
+  }
+  double twoPassSec = secondsSince(start);
+
+  // Timing: sliding accumulator.
+  double slidingSum = 0.0;
+  start = Clock::now();
+  for (float x : signal) {
+    SlidingStats_add(stats, x);
+    slidingSum += SlidingStats_variance(stats);
+  }
+  double slidingSec = secondsSince(start);
+
+  // Accuracy: compare both against a double reference on a sampled subset.
+  index = count = 0;
+  SlidingStats_init(stats, slidingBuf.data(), (uint16_t)window);
+  double worstSliding = 0.0, worstTwoPass = 0.0;
+  for (size_t i = 0; i < signal.size(); i++) {
+    ring[index] = signal[i];
+    index = (index + 1) % window;
+    if (count < window)
+      count++;
+    SlidingStats_add(stats, signal[i]);
+    if (i % 97 != 0)
+      continue;
+    double ref = referenceVariance(ring.data(), count);
+    // Error relative to the signal scale, so near-zero variances count too.
+    double scale = ref + 1e-6 * 9.81 * 9.81;
+    double errSliding = fabs(SlidingStats_variance(stats) - ref) / scale;
+    double errTwoPass = fabs(computeVariance(ring.data(), count) - ref) / scale;
+    if (errSliding > worstSliding)
+      worstSliding = errSliding;
+    if (errTwoPass > worstTwoPass)
+      worstTwoPass = errTwoPass;
+  }
+
+  printf("window %d (%zu samples)\n", window, signal.size());
+  printf("  two-pass    : %12.0f samples/s  worst rel err=%.2e\n",
+         signal.size() / twoPassSec, worstTwoPass);
+  printf("  sliding     : %12.0f samples/s  worst rel err=%.2e  (%.1fx)\n",
+         signal.size() / slidingSec, worstSliding, twoPassSec / slidingSec);
+  // Keep the timed loops from being optimized away.
+  if (twoPassSum < 0 || slidingSum < 0)
+    printf("  (unreachable)\n");
+}
+
+int main(int argc, char **argv) {
+  size_t samples = argc > 1 ? (size_t)strtoul(argv[1], nullptr, 10) : 1000000;
+  std::vector<float> signal = makeSignal(samples);
+
+  const int windows[] = {10, 100, 500};
+  for (int w : windows)
+    benchWindow(signal, w);
+  return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdio.h>
+
+// Checks for the host unit tests. A failed CHECK prints its location and
+// expression and the test carries on; main() returns HostTest_result() so
+// ctest reports the run as failed.
+//
+//   CHECK(ring.empty());
+//   CHECK_NEAR(variance, expected, 1e-6);
+
+static int hostTestFailures = 0;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      hostTestFailures++;                                                      \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                \
+  do {                                                                         \
+    double a_ = (actual), e_ = (expected);                                     \
+    if (!(a_ - e_ <= (tolerance) && e_ - a_ <= (tolerance))) {                 \
+      hostTestFailures++;                                                      \
+      fprintf(stderr, "%s:%d: %s = %.9g, expected %.9g +- %g\n", __FILE__,    \
+              __LINE__, #actual, a_, e_, (double)(tolerance));                 \
+    }                                                                          \
+  } while (0)
+
+static inline int HostTest_result(const char *name) {
+  if (hostTestFailures)
+    printf("%s: %d check(s) failed\n", name, hostTestFailures);
+  else
+    printf("%s: ok\n", name);
+  return hostTestFailures ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+// Unit tests for DictImage_open: a dictc image opens and matches like the
+// builder, and images whose links or word offsets point outside their tables
+// are rejected even when the CRC has been recomputed to match, or skipped.
+
+#include "DictImage.h"
+#include "HostTest.h"
+#include "dict_compile.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Sorted by (length, text), as DictCompile_readWords returns them.
+static const char *const WORDS[] = {"IT",    "NO",    "OLD",   "YES",
+                                    "COLD",  "DARK",  "HOST",  "ANGEL",
+                                    "DEMON", "GHOST", "LIGHT", "SPIRIT"};
+static const size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+static std::vector<uint8_t> compile() {
+  std::vector<std::string> words(WORDS, WORDS + WORD_COUNT);
+  std::vector<uint8_t> image;
+  CHECK(DictCompile_image(words, "test", image));
+  return image;
+}
+
+static DictImageHeader &header(std::vector<uint8_t> &image) {
+  return *(DictImageHeader *)image.data();
+}
+
+static DictNode *nodes(std::vector<uint8_t> &image) {
+  return (DictNode *)(image.data() + header(image).nodesOffset);
+}
+
+static uint32_t *wordOffsets(std::vector<uint8_t> &image) {
+  return (uint32_t *)(image.data() + header(image).wordOffsetsOffset);
+}
+
+static void resign(std::vector<uint8_t> &image) {
+  DictImageHeader &h = header(image);
+  h.checksum = DictImage_crc32(image.data() + h.headerSize,
+                               h.imageSize - h.headerSize);
+}
+
+static bool opens(const std::vector<uint8_t> &image, bool checkCrc = true) {
+  DictImageView view;
+  return DictImage_open(image.data(), image.size(), view, checkCrc);
+}
+
+// The deepest node, i.e. the last one in breadth-first order.
+static uint32_t deepest(std::vector<uint8_t> &image) {
+  return header(image).nodeCount - 1;
+}
+
+static void testValid() {
+  std::vector<uint8_t> image = compile();
+  DictImageView view;
+  bool ok = DictImage_open(image.data(), image.size(), view);
+  CHECK(ok);
+  if (!ok)
+    return;
+  CHECK(view.matcher.wordCount == WORD_COUNT);
+  CHECK(view.maxWordLength == 6);
+  CHECK(strcmp(view.name, "test") == 0);
+
+  uint32_t state = DICT_ROOT_STATE;
+  for (const char *c = "XXGHOST"; *c; c++)
+    state = DictMatcher_step(view.matcher, state, *c);
+  DictOutput out[4];
+  uint32_t n = DictMatcher_outputs(view.matcher, state, out, 4);
+  CHECK(n == 2); // GHOST, then HOST
+  CHECK(n == 2 && out[0].length == 5 && out[1].length == 4);
+  CHECK(n == 2 &&
+        strcmp(DictMatcher_word(view.matcher, out[1].word), "HOST") == 0);
+}
+
+static void testCrc() {
+  std::vector<uint8_t> image = compile();
+  DictImageHeader &h = header(image);
+  image[h.charsOffset] ^= 0x20; // a letter, so the indices stay valid
+  CHECK(!opens(image));
+  CHECK(opens(image, false));
+}
+
+template <typename Fn> static void expectRejected(Fn corrupt) {
+  std::vector<uint8_t> image = compile();
+  corrupt(image);
+  resign(image);
+  CHECK(!opens(image));
+  CHECK(!opens(image, false));
+}
+
+static void testIndices() {
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[0].firstChild = header(im).nodeCount;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[1].childCount = 255;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[deepest(im)].fail = header(im).nodeCount;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[1].output = header(im).nodeCount + 7;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[deepest(im)].word = header(im).wordCount;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    wordOffsets(im)[3] = header(im).charsSize;
+  });
+  // A fail link to itself would loop forever in DictMatcher_step.
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[deepest(im)].fail = deepest(im);
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[1].output = deepest(im);
+  });
+  // Depths size the copy out of the letter window.
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[deepest(im)].depth = 40;
+  });
+  expectRejected([](std::vector<uint8_t> &im) {
+    nodes(im)[0].depth = 1;
+  });
+}
+
+int main() {
+  testValid();
+  testCrc();
+  testIndices();
+  return HostTest_result("dictimage_test");
+}
@@ -0,0 +1,135 @@
+// Unit tests for SpscRing: FIFO order, full/empty edges, the sliding-window
+// use in Dictionary_appendLetter (drop the oldest when full) against the old
+// memmove window, and ordering across a producer and a consumer thread.
+
+#include "HostTest.h"
+#include "SpscRing.h"
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+
+static const int LETTER_BUFFER_SIZE = 32; // mirrors config_core.h
+
+static char letterAt(size_t n) { return (char)('A' + (n * 7) % 26); }
+
+static void testPushPop() {
+  SpscRing<int, 4> ring;
+  CHECK(ring.empty());
+  CHECK(ring.capacity() == 4);
+  for (int i = 0; i < 4; i++)
+    CHECK(ring.push(i));
+  CHECK(ring.full());
+  CHECK(!ring.push(99)); // nothing stored when full
+  CHECK(ring.size() == 4);
+
+  int v = -1;
+  for (int i = 0; i < 4; i++) {
+    CHECK(ring.pop(v));
+    CHECK(v == i);
+  }
+  CHECK(!ring.pop(v));
+  CHECK(v == 3);
+  CHECK(ring.empty());
+
+  // Run the indices around the storage several times.
+  for (int i = 0; i < 100; i++) {
+    CHECK(ring.push(i));
+    CHECK(ring.push(i + 1000));
+    CHECK(ring.pop(v) && v == i);
+    CHECK(ring.pop(v) && v == i + 1000);
+  }
+  CHECK(ring.empty());
+}
+
+static void testConsumerHelpers() {
+  SpscRing<int, 8> ring;
+  for (int i = 0; i < 6; i++)
+    ring.push(i);
+  CHECK(ring.at(0) == 0);
+  CHECK(ring.at(5) == 5);
+  CHECK(ring.newest() == 5);
+
+  int linear[8];
+  CHECK(ring.copyLatest(linear, 8) == 6);
+  CHECK(linear[0] == 0 && linear[5] == 5);
+  CHECK(ring.copyLatest(linear, 3) == 3); // the newest three, oldest first
+  CHECK(linear[0] == 3 && linear[1] == 4 && linear[2] == 5);
+
+  ring.drop(2);
+  CHECK(ring.size() == 4);
+  CHECK(ring.at(0) == 2);
+  ring.drop(100); // more than it holds
+  CHECK(ring.empty());
+
+  ring.push(7);
+  ring.push(8);
+  ring.clear();
+  CHECK(ring.empty());
+  CHECK(ring.push(9));
+  CHECK(ring.newest() == 9);
+}
+
+// The letter window must hold exactly what the memmove'd array held, after
+// every letter, including the steps where the oldest letter is dropped.
+static void testLetterWindow() {
+  char window[LETTER_BUFFER_SIZE];
+  int count = 0;
+  SpscRing<char, LETTER_BUFFER_SIZE> ring;
+  char linear[LETTER_BUFFER_SIZE];
+
+  for (size_t n = 0; n < 10 * LETTER_BUFFER_SIZE; n++) {
+    if (count < LETTER_BUFFER_SIZE) {
+      window[count++] = letterAt(n);
+    } else {
+      memmove(window, window + 1, LETTER_BUFFER_SIZE - 1);
+      window[LETTER_BUFFER_SIZE - 1] = letterAt(n);
+    }
+    if (ring.full())
+      ring.drop(1);
+    CHECK(ring.push(letterAt(n)));
+
+    size_t got = ring.copyLatest(linear, LETTER_BUFFER_SIZE);
+    CHECK(got == (size_t)count);
+    CHECK(memcmp(linear, window, count) == 0);
+    CHECK(ring.newest() == letterAt(n));
+  }
+}
+
+// One producer thread pushes 0..items-1; this thread pops and checks that
+// every value arrives once and in order. Both sides yield when blocked so
+// the test also completes on a single core.
+template <size_t N> static void testThreads(uint32_t items) {
+  SpscRing<uint32_t, N> ring;
+  std::thread producer([&]() {
+    for (uint32_t v = 0; v < items;) {
+      if (ring.push(v))
+        v++;
+      else
+        std::this_thread::yield();
+    }
+  });
+
+  uint32_t expected = 0, outOfOrder = 0;
+  while (expected < items) {
+    uint32_t v;
+    if (!ring.pop(v)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (v != expected)
+      outOfOrder++;
+    expected++;
+  }
+  producer.join();
+  CHECK(outOfOrder == 0);
+  CHECK(ring.empty());
+}
+
+int main() {
+  testPushPop();
+  testConsumerHelpers();
+  testLetterWindow();
+  testThreads<2>(200000);
+  testThreads<32>(2000000);
+  return HostTest_result("ring_test");
+}
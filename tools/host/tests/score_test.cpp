@@ -0,0 +1,156 @@
+// Statistical tests for the Q16 scoring path (GHOST_FIXED_POINT_SCORE)
+// against the float reference: the approximate integer magnitude stays
+// within SENSOR_SCORE_MAG_ERROR of the true length, and the letter
+// distribution matches the float path, both for readings scored directly
+// and with the motion magnitudes taken from raw IMU vectors through
+// SensorScore_magnitude() as SensorPipeline does.
+
+#include "HostTest.h"
+#include "ScoreReadings.h"
+#include "SensorPipeline.h"
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+static double trueLength(int32_t x, int32_t y, int32_t z) {
+  return sqrt((double)x * x + (double)y * y + (double)z * z);
+}
+
+static void testMagnitude() {
+  CHECK(SensorScore_magnitude(0, 0, 0) == 0);
+  CHECK(SensorScore_magnitude(-32768, -32768, -32768) > 0);
+
+  // Every direction, including the axes and diagonals the fit is tight at.
+  // Lengths below 1000 counts also carry the >> 6 truncation.
+  std::mt19937 rng(99);
+  std::uniform_int_distribution<int> raw(-32768, 32767);
+  double worst = 0.0;
+  auto check = [&](int32_t x, int32_t y, int32_t z) {
+    double len = trueLength(x, y, z);
+    if (len < 1000.0)
+      return;
+    double err = fabs(SensorScore_magnitude(x, y, z) - len) / len;
+    if (err > worst)
+      worst = err;
+  };
+  for (int i = 0; i < 2000000; i++)
+    check(raw(rng), raw(rng), raw(rng));
+  const int32_t m = 32767;
+  for (int32_t s = 1000; s <= m; s += 997) {
+    check(s, 0, 0);
+    check(0, -s, 0);
+    check(s, s, 0);
+    check(s, -s, s);
+    check(s, s / 2, s / 4);
+  }
+  printf("  magnitude: worst relative error %.4f (bound %.2f)\n", worst,
+         SENSOR_SCORE_MAG_ERROR);
+  CHECK(worst <= SENSOR_SCORE_MAG_ERROR);
+}
+
+struct Distribution {
+  size_t agree;
+  double worstShare; // largest change in one letter's share
+  double chi2;
+};
+
+static Distribution compareLetters(const std::vector<char> &a,
+                                   const std::vector<char> &b) {
+  Distribution d = {0, 0.0, 0.0};
+  size_t histA[26] = {0}, histB[26] = {0};
+  for (size_t i = 0; i < a.size(); i++) {
+    d.agree += a[i] == b[i];
+    histA[a[i] - 'A']++;
+    histB[b[i] - 'A']++;
+  }
+  for (int l = 0; l < 26; l++) {
+    double share = fabs((double)histA[l] - histB[l]) / a.size();
+    if (share > d.worstShare)
+      d.worstShare = share;
+    if (histA[l] > 0) {
+      double diff = (double)histB[l] - histA[l];
+      d.chi2 += diff * diff / histA[l];
+    }
+  }
+  return d;
+}
+
+// Same readings through both paths: scores within 1/1000, 99.5% of letters
+// identical and no letter's share moved by more than 0.1 percentage points.
+static void testScores(const std::vector<SensorReadings> &readings) {
+  std::vector<char> floatLetters, fixedLetters;
+  double worstScoreErr = 0.0;
+  for (const SensorReadings &r : readings) {
+    float f = SensorScore_float(r);
+    int32_t q = SensorScore_q16(r);
+    floatLetters.push_back(SensorScore_letterFromFloat(f));
+    fixedLetters.push_back(SensorScore_letterFromQ16(q));
+    double err = fabs(f - q / 65536.0);
+    if (err > worstScoreErr)
+      worstScoreErr = err;
+  }
+  Distribution d = compareLetters(floatLetters, fixedLetters);
+  double agreeRate = (double)d.agree / readings.size();
+  printf("  scores: letters agree %.4f%%, worst share diff %.4f pp, "
+         "chi2=%.2f, worst score err %.2e\n",
+         100.0 * agreeRate, 100.0 * d.worstShare, d.chi2, worstScoreErr);
+  CHECK(worstScoreErr <= 1e-3);
+  CHECK(agreeRate >= 0.995);
+  CHECK(d.worstShare <= 1e-3);
+}
+
+// Raw IMU vectors in random directions: the float path takes their exact
+// length, the Q16 path SensorScore_magnitude(). The approximation moves
+// individual scores by up to SENSOR_SCORE_MAG_ERROR of the motion terms, so
+// more letters change, but the distribution must still match.
+static void testRawMotion(std::vector<SensorReadings> readings) {
+  std::mt19937 rng(77);
+  std::normal_distribution<float> gauss(0.0f, 1.0f);
+  const float accelScale = 9.80665f / IMU_ACCEL_LSB_PER_G;
+  const float gyroScale = (3.14159265f / 180.0f) / IMU_GYRO_LSB_PER_DPS;
+
+  std::vector<char> floatLetters, fixedLetters;
+  for (SensorReadings &r : readings) {
+    int32_t accel[3], gyro[3];
+    float accelLen = r.accelMag / accelScale, gyroLen = r.gyroMag / gyroScale;
+    float ax = gauss(rng), ay = gauss(rng), az = gauss(rng);
+    float gx = gauss(rng), gy = gauss(rng), gz = gauss(rng);
+    float an = sqrtf(ax * ax + ay * ay + az * az) + 1e-9f;
+    float gn = sqrtf(gx * gx + gy * gy + gz * gz) + 1e-9f;
+    float a[3] = {ax / an, ay / an, az / an};
+    float g[3] = {gx / gn, gy / gn, gz / gn};
+    for (int i = 0; i < 3; i++) {
+      accel[i] = (int32_t)fmaxf(-32768.0f, fminf(32767.0f, a[i] * accelLen));
+      gyro[i] = (int32_t)fmaxf(-32768.0f, fminf(32767.0f, g[i] * gyroLen));
+    }
+
+    SensorReadings exact = r, approx = r;
+    exact.accelMag = (float)trueLength(accel[0], accel[1], accel[2]) *
+                     accelScale;
+    exact.gyroMag = (float)trueLength(gyro[0], gyro[1], gyro[2]) * gyroScale;
+    approx.accelMag =
+        SensorScore_magnitude(accel[0], accel[1], accel[2]) * accelScale;
+    approx.gyroMag = SensorScore_magnitude(gyro[0], gyro[1], gyro[2]) *
+                     gyroScale;
+    floatLetters.push_back(
+        SensorScore_letterFromFloat(SensorScore_float(exact)));
+    fixedLetters.push_back(
+        SensorScore_letterFromQ16(SensorScore_q16(approx)));
+  }
+  Distribution d = compareLetters(floatLetters, fixedLetters);
+  double agreeRate = (double)d.agree / readings.size();
+  printf("  raw motion: letters agree %.4f%%, worst share diff %.4f pp, "
+         "chi2=%.2f\n",
+         100.0 * agreeRate, 100.0 * d.worstShare, d.chi2);
+  CHECK(agreeRate >= 0.95);
+  CHECK(d.worstShare <= 1e-3);
+}
+
+int main() {
+  std::vector<SensorReadings> readings = makeScoreReadings(1000000);
+  testMagnitude();
+  testScores(readings);
+  testRawMotion(readings);
+  return HostTest_result("score_test");
+}
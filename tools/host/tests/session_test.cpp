@@ -0,0 +1,105 @@
+// Unit tests for the binary session log: a header naming every dictionary
+// Dictionary_getCount() can report, and word records from the last of them
+// (index 19: three built-ins, "All", sixteen SD lists) decoding back to the
+// same CSV as the firmware writes directly.
+
+#include "HostTest.h"
+#include "SessionLog.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static SessionRecord wordRecord(uint32_t ms, const char *word, uint32_t id,
+                                uint8_t dict) {
+  SessionRecord r;
+  memset(&r, 0, sizeof(r));
+  r.type = SESSION_WORD;
+  r.ms = ms;
+  r.unixTime = 1700000000 + ms / 1000;
+  snprintf(r.word.word, sizeof(r.word.word), "%s", word);
+  r.word.id = id;
+  r.word.dict = dict;
+  return r;
+}
+
+static void testLastDictionary() {
+  static char names[SESSION_DICTS_MAX][SESSION_NAME_MAX + 1];
+  SessionDictNames dicts;
+  dicts.count = (uint8_t)SESSION_DICTS_MAX;
+  for (uint8_t i = 0; i < dicts.count; i++) {
+    snprintf(names[i], sizeof(names[i]), "list_%02u", (unsigned)i);
+    dicts.names[i] = names[i];
+  }
+  const uint8_t last = (uint8_t)(SESSION_DICTS_MAX - 1);
+  CHECK(last == 19);
+
+  std::vector<SessionRecord> records;
+  records.push_back(wordRecord(1000, "GHOST", 5, last));
+  records.push_back(wordRecord(1200, "GHOST", 5, last)); // id only
+  records.push_back(wordRecord(1400, "COLD", DICT_NO_WORD, last));
+  records.push_back(wordRecord(1600, "YES", 7, 0));
+  records.push_back(wordRecord(1800, "NO", 9, last));
+
+  std::vector<uint8_t> bin(SESSION_BIN_HEADER_MAX);
+  bin.resize(SessionLog_encodeBinaryHeader(bin.data(), dicts));
+  std::string csv;
+  char line[SESSION_LINE_MAX];
+  SessionBinState enc;
+  SessionLog_resetBinary(enc);
+  uint8_t rec[SESSION_LINE_MAX];
+  for (const SessionRecord &r : records) {
+    csv.append(line, SessionLog_formatCsv(r, dicts, line));
+    size_t n = SessionLog_encodeBinary(r, enc, rec);
+    bin.insert(bin.end(), rec, rec + n);
+  }
+  CHECK(csv.find("dict=list_19") != std::string::npos);
+  CHECK(csv.find("unknown") == std::string::npos);
+
+  char storage[SESSION_DICTS_MAX][SESSION_NAME_MAX + 1];
+  SessionDictNames decodedDicts;
+  size_t pos = SessionLog_decodeBinaryHeader(bin.data(), bin.size(), storage,
+                                             decodedDicts);
+  CHECK(pos != 0);
+  CHECK(decodedDicts.count == SESSION_DICTS_MAX);
+  if (pos == 0)
+    return;
+  CHECK(strcmp(decodedDicts.names[last], "list_19") == 0);
+
+  // Decode, filling in the text of repeated ids as session_decode does.
+  SessionBinState dec;
+  SessionLog_resetBinary(dec);
+  std::string decoded;
+  std::vector<std::string> texts(16);
+  size_t words = 0;
+  while (pos < bin.size()) {
+    SessionRecord r;
+    size_t n = SessionLog_decodeBinary(bin.data() + pos, bin.size() - pos,
+                                       dec, r);
+    CHECK(n != 0);
+    if (n == 0)
+      return;
+    pos += n;
+    if (r.type == SESSION_DICT) {
+      texts.assign(16, std::string());
+      continue;
+    }
+    if (r.type == SESSION_WORD && r.word.id != DICT_NO_WORD) {
+      if (r.word.word[0])
+        texts[r.word.id] = r.word.word;
+      else
+        snprintf(r.word.word, sizeof(r.word.word), "%s",
+                 texts[r.word.id].c_str());
+    }
+    CHECK(r.word.dict == records[words].word.dict);
+    words++;
+    decoded.append(line, SessionLog_formatCsv(r, decodedDicts, line));
+  }
+  CHECK(words == records.size());
+  CHECK(decoded == csv);
+}
+
+int main() {
+  testLastDictionary();
+  return HostTest_result("session_test");
+}
@@ -0,0 +1,99 @@
+// Unit tests for SlidingStats: start-up and edge cases, and the sliding
+// mean/variance against a double-precision two-pass recompute of the same
+// window after every sample, at the window lengths the firmware uses.
+
+#include "HostTest.h"
+#include "SlidingStats.h"
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+static void reference(const std::vector<float> &window, double &mean,
+                      double &var) {
+  double sum = 0.0;
+  for (float x : window)
+    sum += x;
+  mean = window.empty() ? 0.0 : sum / window.size();
+  var = 0.0;
+  if (window.size() <= 1)
+    return;
+  for (float x : window)
+    var += (x - mean) * (x - mean);
+  var /= window.size() - 1;
+}
+
+// Accelerometer-like magnitudes: gravity, small noise, and bursts of motion,
+// so the variance moves across several orders of magnitude.
+static float signalAt(size_t i, uint32_t &rng) {
+  rng = rng * 1664525u + 1013904223u;
+  float noise = ((rng >> 8) & 0xFFFF) / 65535.0f - 0.5f;
+  bool moving = (i / 5000) % 4 == 3;
+  return 9.81f + noise * (moving ? 6.0f : 0.02f);
+}
+
+static void testEdges() {
+  float buf[4];
+  SlidingStats s;
+  SlidingStats_init(s, buf, 4);
+  CHECK(SlidingStats_variance(s) == 0.0f);
+  SlidingStats_add(s, 3.0f);
+  CHECK(SlidingStats_variance(s) == 0.0f); // one sample
+  CHECK_NEAR(SlidingStats_mean(s), 3.0, 1e-9);
+  SlidingStats_add(s, 5.0f);
+  CHECK_NEAR(SlidingStats_variance(s), 2.0, 1e-6);
+
+  SlidingStats_reset(s);
+  CHECK(s.count == 0);
+  CHECK(SlidingStats_variance(s) == 0.0f);
+
+  // A constant signal never goes negative through rounding.
+  for (int i = 0; i < 1000; i++) {
+    SlidingStats_add(s, 9.81f);
+    CHECK(SlidingStats_variance(s) >= 0.0f);
+  }
+  CHECK_NEAR(SlidingStats_variance(s), 0.0, 1e-9);
+
+  // A zero-capacity window ignores samples.
+  SlidingStats empty;
+  SlidingStats_init(empty, nullptr, 0);
+  SlidingStats_add(empty, 1.0f);
+  CHECK(empty.count == 0);
+}
+
+static void testAgainstTwoPass(uint16_t capacity, size_t samples) {
+  std::vector<float> buf(capacity), window;
+  SlidingStats s;
+  SlidingStats_init(s, buf.data(), capacity);
+  uint32_t rng = 12345;
+  double worst = 0.0;
+  for (size_t i = 0; i < samples; i++) {
+    float x = signalAt(i, rng);
+    SlidingStats_add(s, x);
+    window.push_back(x);
+    if (window.size() > capacity)
+      window.erase(window.begin());
+    CHECK(s.count == window.size());
+
+    double mean, var;
+    reference(window, mean, var);
+    CHECK_NEAR(SlidingStats_mean(s), mean, 1e-5 * 9.81);
+    // Relative to the signal scale, so near-zero variances count too.
+    double scale = var + 1e-6 * 9.81 * 9.81;
+    double err = fabs(SlidingStats_variance(s) - var) / scale;
+    if (err > worst)
+      worst = err;
+  }
+  CHECK(worst < 1e-5);
+  if (worst >= 1e-5)
+    printf("  window %u: worst relative variance error %.2e\n",
+           (unsigned)capacity, worst);
+}
+
+int main() {
+  testEdges();
+  testAgainstTwoPass(2, 20000);
+  testAgainstTwoPass(10, 40000);
+  testAgainstTwoPass(100, 40000);
+  testAgainstTwoPass(500, 40000);
+  return HostTest_result("stats_test");
+}
@@ -0,0 +1,347 @@
+// Replays a sensor trace through the Sensors_* API and the dictionary
+// matcher, at recorded speed or as fast as possible. It prints letters/sec
+// and a checksum of the letter stream so that scoring changes can be checked
+// against a recorded session.
+//
+//   trace_replay <trace.grt> [--realtime] [--words words.txt]
+//   trace_replay --synth <out.grt> [seconds]
+//   trace_replay --selftest [seconds] [--words words.txt]
+//   trace_replay --motion <trace.grt>
+//
+// --synth writes a synthetic trace (250 Hz IMU) and prints the letters the
+// device pipeline produced while recording. --selftest records one, replays
+// it, and fails unless the replayed letters match exactly. --motion prints
+// the spread of the accel/gyro window variance per step, computed over every
+// IMU record and over one record per step (the pre-FIFO statistic), for
+// tuning MOTION_VAR_MAX in sensorscore.cpp.
+
+#include "DictMatcher.h"
+#include "SensorPipeline.h"
+#include "SensorReplay.h"
+#include "SensorTrace.h"
+#include "Sensors.h"
+#include "SlidingStats.h"
+#include "config_core.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const uint16_t SYNTH_IMU_HZ = 250;
+
+struct LetterStats {
+  uint32_t letters;
+  uint32_t checksum; // FNV-1a of the letter stream
+  uint32_t hits;
+};
+
+static void addLetter(LetterStats &st, char letter) {
+  st.letters++;
+  st.checksum = (st.checksum ^ (uint8_t)letter) * 16777619UL;
+}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next() {
+    state = state * 1664525UL + 1013904223UL;
+    return state >> 8;
+  }
+  float unit() { return (next() & 0xFFFF) / 65535.0f; } // [0, 1]
+};
+
+// Record a synthetic session: a device mostly at rest with bursts of motion,
+// drifting temperature/humidity and a WiFi scan every 5 s. The pipeline runs
+// while recording, as on the device, to get the expected letters.
+static bool synthesize(const char *path, uint32_t seconds, LetterStats &st) {
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    fprintf(stderr, "cannot write %s\n", path);
+    return false;
+  }
+  uint8_t buf[SENSOR_TRACE_MAX_RECORD];
+  SensorTraceHeader h = {SYNTH_IMU_HZ, (uint16_t)SAMPLE_PERIOD_MS};
+  fwrite(buf, 1, SensorTrace_encodeHeader(buf, h), f);
+
+  SensorPipeline_begin(SYNTH_IMU_HZ);
+  st = LetterStats{0, 2166136261UL, 0};
+  Lcg rng = {42};
+  SensorSample s = {0, 22.0f, 45.0f, 0, -60, 80.0f, 6, 1.0f};
+  uint32_t steps = seconds * 1000UL / SAMPLE_PERIOD_MS;
+  uint32_t imuPerStep = SYNTH_IMU_HZ * SAMPLE_PERIOD_MS / 1000UL;
+
+  for (uint32_t step = 0; step < steps; step++) {
+    bool moving = (step / 40) % 5 == 4;
+    float shake = moving ? 2500.0f : 40.0f;
+    for (uint32_t i = 0; i < imuPerStep; i++) {
+      ImuSample imu;
+      imu.accel[0] = (int16_t)((rng.unit() - 0.5f) * shake);
+      imu.accel[1] = (int16_t)((rng.unit() - 0.5f) * shake);
+      imu.accel[2] = (int16_t)(4096 + (rng.unit() - 0.5f) * shake);
+      for (int a = 0; a < 3; a++)
+        imu.gyro[a] = (int16_t)((rng.unit() - 0.5f) * shake);
+      fwrite(buf, 1, SensorTrace_encodeImu(buf, imu), f);
+      SensorPipeline_addImu(imu);
+    }
+
+    s.timestampMs = 1000 + step * SAMPLE_PERIOD_MS;
+    if (step % 10 == 0) { // DHT reads every 2 s
+      s.tempC += (rng.unit() - 0.5f) * 0.4f;
+      s.humidity += (rng.unit() - 0.5f) * 1.0f;
+    }
+    if (step % 25 == 0) { // WiFi scan every 5 s
+      s.wifiStrongest = (int16_t)(-75 + rng.next() % 35);
+      s.wifiVariance = rng.unit() * 200.0f;
+      s.wifiCount = (int16_t)(rng.next() % 12);
+    }
+    s.hallRaw = (int16_t)((int)(rng.next() % 41) - 20);
+    fwrite(buf, 1, SensorTrace_encodeSample(buf, s), f);
+
+    char letter;
+    if (SensorPipeline_sample(s, letter))
+      addLetter(st, letter);
+  }
+  fclose(f);
+  return true;
+}
+
+static bool loadMatcher(const char *path, DictMatcherBuilder &builder,
+                        DictMatcher &m) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot read %s\n", path);
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    size_t len = strcspn(line, "\r\n ");
+    for (size_t i = 0; i < len; i++)
+      if (line[i] >= 'a' && line[i] <= 'z')
+        line[i] = (char)(line[i] - 'a' + 'A');
+    if (len > 0 && len <= (size_t)LETTER_BUFFER_SIZE)
+      builder.addWord(line, len);
+  }
+  fclose(f);
+  m = builder.build();
+  return true;
+}
+
+static bool replay(const char *path, SensorReplaySpeed speed,
+                   const DictMatcher *matcher, LetterStats &st) {
+  if (!SensorReplay_open(path, speed)) {
+    fprintf(stderr, "cannot open trace %s\n", path);
+    return false;
+  }
+  Sensors_begin();
+  st = LetterStats{0, 2166136261UL, 0};
+  uint32_t state = DICT_ROOT_STATE;
+
+  Clock::time_point start = Clock::now();
+  while (!SensorReplay_finished()) {
+    char letter;
+    if (!Sensors_pollLetter(letter)) {
+      if (speed == SENSOR_REPLAY_REAL_TIME)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      continue;
+    }
+    addLetter(st, letter);
+    if (matcher) {
+      state = DictMatcher_step(*matcher, state, letter);
+      if (DictMatcher_matchAt(*matcher, state) != DICT_NO_WORD)
+        st.hits++;
+    }
+  }
+  double sec = std::chrono::duration<double>(Clock::now() - start).count();
+
+  uint32_t steps = SensorReplay_stepCount();
+  printf("replayed %u steps (%.0f s of sensor time) in %.3f s\n", steps,
+         steps * SAMPLE_PERIOD_MS / 1000.0, sec);
+  printf("  letters=%u  checksum=%08x", st.letters, st.checksum);
+  if (matcher)
+    printf("  dictionary hits=%u", st.hits);
+  printf("\n  %.0f letters/s, %.0f steps/s\n", st.letters / sec, steps / sec);
+  SensorReplay_close();
+  return true;
+}
+
+// Window variance of the accel and gyro magnitudes after each step.
+struct MotionWindows {
+  std::vector<float> accelBuf, gyroBuf;
+  SlidingStats accel, gyro;
+  std::vector<float> accelVar, gyroVar;
+
+  void begin(uint32_t samples) {
+    accelBuf.assign(samples, 0.0f);
+    gyroBuf.assign(samples, 0.0f);
+    SlidingStats_init(accel, accelBuf.data(), (uint16_t)samples);
+    SlidingStats_init(gyro, gyroBuf.data(), (uint16_t)samples);
+  }
+  void add(float accelMag, float gyroMag) {
+    SlidingStats_add(accel, accelMag);
+    SlidingStats_add(gyro, gyroMag);
+  }
+  void step() {
+    accelVar.push_back(SlidingStats_variance(accel));
+    gyroVar.push_back(SlidingStats_variance(gyro));
+  }
+};
+
+static float percentile(std::vector<float> v, float p) {
+  if (v.empty())
+    return 0.0f;
+  size_t i = (size_t)(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+static void printSpread(const char *name, const std::vector<float> &v) {
+  printf("  %-16s p50=%8.4f  p90=%8.4f  p99=%8.4f  max=%8.4f\n", name,
+         percentile(v, 0.5f), percentile(v, 0.9f), percentile(v, 0.99f),
+         percentile(v, 1.0f));
+}
+
+static bool motionReport(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "cannot open trace %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    data.insert(data.end(), buf, buf + n);
+  fclose(f);
+  SensorTraceHeader h;
+  if (!SensorTrace_decodeHeader(data.data(), data.size(), h)) {
+    fprintf(stderr, "%s: not a sensor trace\n", path);
+    return false;
+  }
+
+  // Same magnitudes as the float path of SensorPipeline_addImu().
+  const float accelScale = 9.80665f / IMU_ACCEL_LSB_PER_G;
+  const float gyroScale = (3.14159265f / 180.0f) / IMU_GYRO_LSB_PER_DPS;
+  uint32_t rateHz = h.imuRateHz ? h.imuRateHz : 1000UL / SAMPLE_PERIOD_MS;
+  uint32_t fifoWindow = rateHz * ENTROPY_WINDOW_MS / 1000UL;
+  fifoWindow = std::max<uint32_t>(2, std::min<uint32_t>(fifoWindow,
+                                                        ENTROPY_WINDOW_MAX));
+  MotionWindows fifo, perStep;
+  fifo.begin(fifoWindow);
+  perStep.begin(ENTROPY_WINDOW_MS / SAMPLE_PERIOD_MS);
+
+  float accelMag = 0.0f, gyroMag = 0.0f;
+  bool haveImu = false;
+  size_t offset = SENSOR_TRACE_HEADER_BYTES;
+  SensorTraceRecord rec;
+  while (offset < data.size()) {
+    size_t len = SensorTrace_decode(data.data() + offset, data.size() - offset,
+                                    rec);
+    if (len == 0)
+      break;
+    offset += len;
+    if (rec.type == SENSOR_TRACE_IMU) {
+      float a = 0.0f, g = 0.0f;
+      for (int i = 0; i < 3; i++) {
+        float ax = rec.imu.accel[i] * accelScale;
+        float gx = rec.imu.gyro[i] * gyroScale;
+        a += ax * ax;
+        g += gx * gx;
+      }
+      accelMag = sqrtf(a);
+      gyroMag = sqrtf(g);
+      fifo.add(accelMag, gyroMag);
+      haveImu = true;
+      continue;
+    }
+    if (haveImu)
+      perStep.add(accelMag, gyroMag);
+    haveImu = false;
+    fifo.step();
+    perStep.step();
+  }
+
+  printf("%s: %zu steps, %u Hz IMU, window %u samples vs %u\n", path,
+         fifo.accelVar.size(), (unsigned)rateHz, (unsigned)fifoWindow,
+         (unsigned)(ENTROPY_WINDOW_MS / SAMPLE_PERIOD_MS));
+  printSpread("accel all", fifo.accelVar);
+  printSpread("accel per step", perStep.accelVar);
+  printSpread("gyro all", fifo.gyroVar);
+  printSpread("gyro per step", perStep.gyroVar);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: trace_replay <trace.grt> [--realtime] "
+                    "[--words words.txt]\n"
+                    "       trace_replay --synth <out.grt> [seconds]\n"
+                    "       trace_replay --selftest [seconds] "
+                    "[--words words.txt]\n"
+                    "       trace_replay --motion <trace.grt>\n");
+    return 2;
+  }
+
+  const char *wordsPath = nullptr;
+  bool realTime = false;
+  std::vector<const char *> args;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--words") == 0 && i + 1 < argc)
+      wordsPath = argv[++i];
+    else if (strcmp(argv[i], "--realtime") == 0)
+      realTime = true;
+    else
+      args.push_back(argv[i]);
+  }
+
+  DictMatcherBuilder builder;
+  DictMatcher matcher;
+  if (wordsPath && !loadMatcher(wordsPath, builder, matcher))
+    return 1;
+  const DictMatcher *m = wordsPath ? &matcher : nullptr;
+
+  if (strcmp(args[0], "--synth") == 0) {
+    if (args.size() < 2)
+      return 2;
+    uint32_t seconds = args.size() > 2 ? strtoul(args[2], nullptr, 10) : 600;
+    LetterStats st;
+    if (!synthesize(args[1], seconds, st))
+      return 1;
+    printf("wrote %s: %u s, letters=%u checksum=%08x\n", args[1], seconds,
+           st.letters, st.checksum);
+    return 0;
+  }
+
+  if (strcmp(args[0], "--motion") == 0) {
+    if (args.size() < 2)
+      return 2;
+    return motionReport(args[1]) ? 0 : 1;
+  }
+
+  if (strcmp(args[0], "--selftest") == 0) {
+    uint32_t seconds = args.size() > 1 ? strtoul(args[1], nullptr, 10) : 3600;
+    const char *path = "trace_replay_selftest.grt";
+    LetterStats recorded, replayed;
+    if (!synthesize(path, seconds, recorded) ||
+        !replay(path, SENSOR_REPLAY_MAX_SPEED, m, replayed))
+      return 1;
+    remove(path);
+    bool same = recorded.letters == replayed.letters &&
+                recorded.checksum == replayed.checksum;
+    if (!same)
+      printf("  MISMATCH: recorded letters=%u checksum=%08x\n",
+             recorded.letters, recorded.checksum);
+    return same ? 0 : 1;
+  }
+
+  LetterStats st;
+  SensorReplaySpeed speed =
+      realTime ? SENSOR_REPLAY_REAL_TIME : SENSOR_REPLAY_MAX_SPEED;
+  return replay(args[0], speed, m, st) ? 0 : 1;
+}
@@ -17,7 +17,16 @@ DEFAULT_CONFIG = {
     "language": "en",
     "logging": {
         "enabled": True,
-        "level": "info"
+        "level": "info",
+        "sensor_trace": False,
+        "flush_ms": 2000,
+        "flush_bytes": 4096,
+        "format": "csv",
+        "prealloc_kb": 0
+    },
+    "dictionary": {
+        "match": "longest",
+        "min_length": 1
     },
     "ui": {
         "complications": {
@@ -35,7 +44,7 @@ class GhostRadarConfigApp(tk.Tk):
     def __init__(self):
         super().__init__()
         self.title("Ghost Radar SD Config Tool")
-        self.geometry("520x520")
+        self.geometry("520x600")
 
         self.sd_root = tk.StringVar(value="")
         self.config_data = json.loads(json.dumps(DEFAULT_CONFIG))
@@ -101,6 +110,39 @@ class GhostRadarConfigApp(tk.Tk):
         )
         self.logging_level_combo.grid(row=4, column=1, sticky="ew", padx=10, pady=5)
 
+        # Dictionary match policy
+        ttk.Label(frame_cfg, text="Word match policy:").grid(row=5, column=0, sticky="w", padx=10, pady=5)
+        self.match_policy_var = tk.StringVar(value=DEFAULT_CONFIG["dictionary"]["match"])
+        self.match_policy_combo = ttk.Combobox(
+            frame_cfg,
+            textvariable=self.match_policy_var,
+            values=["longest", "shortest", "first", "all"],
+            state="readonly"
+        )
+        self.match_policy_combo.grid(row=5, column=1, sticky="ew", padx=10, pady=5)
+
+        # Minimum word length
+        ttk.Label(frame_cfg, text="Minimum word length:").grid(row=6, column=0, sticky="w", padx=10, pady=5)
+        self.min_length_var = tk.IntVar(value=DEFAULT_CONFIG["dictionary"]["min_length"])
+        self.min_length_entry = ttk.Entry(frame_cfg, textvariable=self.min_length_var)
+        self.min_length_entry.grid(row=6, column=1, sticky="ew", padx=10, pady=5)
+
+        # Sensor trace recording
+        self.sensor_trace_var = tk.BooleanVar(value=DEFAULT_CONFIG["logging"]["sensor_trace"])
+        chk_trace = ttk.Checkbutton(frame_cfg, text="Record sensor trace (for host replay)", variable=self.sensor_trace_var)
+        chk_trace.grid(row=7, column=0, columnspan=2, sticky="w", padx=10, pady=5)
+
+        # Session log format
+        ttk.Label(frame_cfg, text="Session log format:").grid(row=8, column=0, sticky="w", padx=10, pady=5)
+        self.log_format_var = tk.StringVar(value=DEFAULT_CONFIG["logging"]["format"])
+        self.log_format_combo = ttk.Combobox(
+            frame_cfg,
+            textvariable=self.log_format_var,
+            values=["csv", "binary"],
+            state="readonly"
+        )
+        self.log_format_combo.grid(row=8, column=1, sticky="ew", padx=10, pady=5)
+
         frame_cfg.columnconfigure(1, weight=1)
 
         # Complications
@@ -160,7 +202,7 @@ class GhostRadarConfigApp(tk.Tk):
         if not root:
             return False
 
-        for sub in ["config", "logs", os.path.join("logs", "sessions"), "dictionary", "ui"]:
+        for sub in ["config", "logs", os.path.join("logs", "sessions"), os.path.join("logs", "traces"), "dictionary", "ui"]:
             full = os.path.join(root, sub)
             if not os.path.exists(full):
                 os.makedirs(full, exist_ok=True)
@@ -194,6 +236,13 @@ class GhostRadarConfigApp(tk.Tk):
             logging_data = data.get("logging", {})
             cfg["logging"]["enabled"] = logging_data.get("enabled", cfg["logging"]["enabled"])
             cfg["logging"]["level"] = logging_data.get("level", cfg["logging"]["level"])
+            cfg["logging"]["sensor_trace"] = logging_data.get("sensor_trace", cfg["logging"]["sensor_trace"])
+            for key in ("flush_ms", "flush_bytes", "format", "prealloc_kb"):
+                cfg["logging"][key] = logging_data.get(key, cfg["logging"][key])
+
+            dict_data = data.get("dictionary", {})
+            cfg["dictionary"]["match"] = dict_data.get("match", cfg["dictionary"]["match"])
+            cfg["dictionary"]["min_length"] = dict_data.get("min_length", cfg["dictionary"]["min_length"])
 
             ui_data = data.get("ui", {})
             comp_data = ui_data.get("complications", {})
@@ -217,6 +266,10 @@ class GhostRadarConfigApp(tk.Tk):
         self.language_var.set(cfg["language"])
         self.logging_enabled_var.set(cfg["logging"]["enabled"])
         self.logging_level_var.set(cfg["logging"]["level"])
+        self.sensor_trace_var.set(cfg["logging"]["sensor_trace"])
+        self.log_format_var.set(cfg["logging"]["format"])
+        self.match_policy_var.set(cfg["dictionary"]["match"])
+        self.min_length_var.set(cfg["dictionary"]["min_length"])
         comps = cfg.get("ui", {}).get("complications", {})
         for key, vars_dict in self.comp_vars.items():
             comp_cfg = comps.get(key, DEFAULT_CONFIG["ui"]["complications"][key])
@@ -242,6 +295,18 @@ class GhostRadarConfigApp(tk.Tk):
         cfg["language"] = self.language_var.get()
         cfg["logging"]["enabled"] = bool(self.logging_enabled_var.get())
         cfg["logging"]["level"] = self.logging_level_var.get()
+        cfg["logging"]["sensor_trace"] = bool(self.sensor_trace_var.get())
+        cfg["logging"]["format"] = self.log_format_var.get()
+        # No widgets for the write tuning; keep what was loaded.
+        for key in ("flush_ms", "flush_bytes", "prealloc_kb"):
+            cfg["logging"][key] = self.config_data["logging"][key]
+
+        try:
+            min_length = int(self.min_length_var.get())
+        except (ValueError, tk.TclError):
+            min_length = DEFAULT_CONFIG["dictionary"]["min_length"]
+        cfg["dictionary"]["match"] = self.match_policy_var.get()
+        cfg["dictionary"]["min_length"] = max(1, min(32, min_length))
 
         comp_cfg = {}
         for key, vars_dict in self.comp_vars.items():